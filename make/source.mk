@@ -87,6 +87,7 @@ COMMON_SRC = \
             fc/rc_adjustments.c \
             fc/rc_controls.c \
             fc/rc_modes.c \
+            fc/rx_latency.c \
             flight/position.c \
             flight/failsafe.c \
             flight/gps_rescue.c \
@@ -246,6 +247,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             fc/rc.c \
             fc/rc_controls.c \
             fc/runtime_config.c \
+            fc/rx_latency.c \
             flight/gyroanalyse.c \
             flight/imu.c \
             flight/mixer.c \
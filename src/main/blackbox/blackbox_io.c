@@ -46,6 +46,7 @@
 #include "blackbox_io.h"
 
 #include "common/maths.h"
+#include "common/time.h"
 
 #include "flight/pid.h"
 
@@ -538,6 +539,20 @@ bool blackboxDeviceBeginLog(void)
     case BLACKBOX_DEVICE_SDCARD:
         return blackboxSDCardBeginLog();
 #endif // USE_SDCARD
+#ifdef USE_FLASHFS_LOG_INDEX
+    case BLACKBOX_DEVICE_FLASH:
+        {
+            uint32_t timestamp = 0;
+#ifdef USE_RTC_TIME
+            rtcTime_t rtcTime;
+            if (rtcGet(&rtcTime)) {
+                timestamp = rtcTimeGetSeconds(&rtcTime);
+            }
+#endif
+            flashfsLogBegin(timestamp);
+        }
+        return true;
+#endif // USE_FLASHFS_LOG_INDEX
     default:
         return true;
     }
@@ -627,6 +642,11 @@ int32_t blackboxGetLogNumber(void)
         return blackboxSDCard.largestLogFileNumber;
 #endif
 
+#ifdef USE_FLASHFS_LOG_INDEX
+    case BLACKBOX_DEVICE_FLASH:
+        return flashfsLogGetCurrentNumber();
+#endif
+
     default:
         return -1;
     }
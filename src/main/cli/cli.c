@@ -45,6 +45,7 @@ bool cliMode = false;
 #include "cms/cms.h"
 
 #include "common/axis.h"
+#include "common/bitarray.h"
 #include "common/color.h"
 #include "common/maths.h"
 #include "common/printf.h"
@@ -97,6 +98,7 @@ bool cliMode = false;
 #include "config/config.h"
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
+#include "fc/init.h"
 #include "fc/rc.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
@@ -192,13 +194,29 @@ static uint32_t bufferIndex = 0;
 
 static bool configIsInCopy = false;
 
+// Parameter groups, by registry index, that differ from their defaults while the defaults are in place for differencing
+#define CLI_PG_CHANGED_MASK_SIZE 256
+static uint32_t pgChangedMask[CLI_PG_CHANGED_MASK_SIZE / 32];
+
+#ifdef USE_CLI_VALUE_INDEX
+static bool valueTableNameOrderBuilt = false;
+#endif
+
 #define CURRENT_PROFILE_INDEX -1
 static int8_t pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
 static int8_t rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
 
 #ifdef USE_CLI_BATCH
+#define COMMAND_BATCH_MAX_ERROR_LINES 8
 static bool commandBatchActive = false;
 static bool commandBatchError = false;
+static uint16_t commandBatchLine;
+static uint16_t commandBatchErrorCount;
+static uint16_t commandBatchLastErrorLine;
+static uint16_t commandBatchErrorLines[COMMAND_BATCH_MAX_ERROR_LINES];
+#ifdef USE_LED_STRIP_STATUS_MODE
+static bool commandBatchLedConfigChanged = false;
+#endif
 #endif
 
 #if defined(USE_BOARD_INFO)
@@ -428,6 +446,15 @@ static void cliPrintErrorVa(const char *format, va_list va)
 #ifdef USE_CLI_BATCH
     if (commandBatchActive) {
         commandBatchError = true;
+
+        // Count each failed command once, however many errors it reports
+        if (!commandBatchErrorCount || commandBatchLastErrorLine != commandBatchLine) {
+            if (commandBatchErrorCount < COMMAND_BATCH_MAX_ERROR_LINES) {
+                commandBatchErrorLines[commandBatchErrorCount] = commandBatchLine;
+            }
+            commandBatchErrorCount++;
+            commandBatchLastErrorLine = commandBatchLine;
+        }
     }
 #endif
 }
@@ -680,6 +707,26 @@ static bool isWritingConfigToCopy()
 static bool cliProcessCustomDefaults(void);
 #endif
 
+static void updatePgChangedMask(void)
+{
+    memset(pgChangedMask, 0, sizeof(pgChangedMask));
+
+    PG_FOREACH(pg) {
+        const unsigned index = pg - __pg_registry_start;
+        if (index < CLI_PG_CHANGED_MASK_SIZE && memcmp(pg->copy, pg->address, pgSize(pg)) != 0) {
+            bitArraySet(pgChangedMask, index);
+        }
+    }
+}
+
+// Only valid while the defaults are in place for differencing
+static bool pgEqualsDefault(const pgRegistry_t *pg)
+{
+    const unsigned index = pg - __pg_registry_start;
+
+    return index < CLI_PG_CHANGED_MASK_SIZE && !bitArrayGet(pgChangedMask, index);
+}
+
 static void backupAndResetConfigs(const bool useCustomDefaults)
 {
     backupConfigs();
@@ -696,6 +743,9 @@ static void backupAndResetConfigs(const bool useCustomDefaults)
 #else
     UNUSED(useCustomDefaults);
 #endif
+
+    // Values in groups that are unchanged as a whole needn't be compared one by one
+    updatePgChangedMask();
 }
 
 static uint8_t getPidProfileIndexToUse()
@@ -735,7 +785,11 @@ STATIC_UNIT_TESTED void *cliGetValuePointer(const clivalue_t *value)
 
 static const char *dumpPgValue(const clivalue_t *value, dumpFlags_t dumpMask, const char *headingStr)
 {
-    const pgRegistry_t *pg = pgFind(value->pgn);
+    // Values of the same group are next to each other in the value table
+    static const pgRegistry_t *pg = NULL;
+    if (!pg || pgN(pg) != value->pgn) {
+        pg = pgFind(value->pgn);
+    }
 #ifdef DEBUG
     if (!pg) {
         cliPrintLinef("VALUE %s ERROR", value->name);
@@ -746,7 +800,7 @@ static const char *dumpPgValue(const clivalue_t *value, dumpFlags_t dumpMask, co
     const char *format = "set %s = ";
     const char *defaultFormat = "#set %s = ";
     const int valueOffset = getValueOffset(value);
-    const bool equalsDefault = valuePtrEqualsDefault(value, pg->copy + valueOffset, pg->address + valueOffset);
+    const bool equalsDefault = pgEqualsDefault(pg) || valuePtrEqualsDefault(value, pg->copy + valueOffset, pg->address + valueOffset);
 
     headingStr = cliPrintSectionHeading(dumpMask, !equalsDefault, headingStr);
     if (((dumpMask & DO_DIFF) == 0) || !equalsDefault) {
@@ -1890,7 +1944,14 @@ static void cliLed(char *cmdline)
         i = atoi(ptr);
         if (i < LED_MAX_STRIP_LENGTH) {
             ptr = nextArg(cmdline);
-            if (parseLedStripConfig(i, ptr)) {
+#ifdef USE_CLI_BATCH
+            // The LED layout is worked out once, when the batch ends
+            const bool parsed = commandBatchActive ? parseLedStripConfigEntry(i, ptr) : parseLedStripConfig(i, ptr);
+            commandBatchLedConfigChanged |= commandBatchActive && parsed;
+#else
+            const bool parsed = parseLedStripConfig(i, ptr);
+#endif
+            if (parsed) {
                 generateLedConfig((ledConfig_t *)&ledStripStatusModeConfig()->ledConfigs[i], ledConfigBuffer, sizeof(ledConfigBuffer));
                 cliDumpPrintLinef(0, false, format, i, ledConfigBuffer);
             } else {
@@ -2440,7 +2501,11 @@ static void cliFlashErase(char *cmdline)
     cliWriterFlush();
     flashfsEraseCompletely();
 
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+    while (!flashfsIsReady() || flashfsIsErasing()) {
+#else
     while (!flashfsIsReady()) {
+#endif
 #ifndef MINIMAL_CLI
         cliPrintf(".");
         if (i++ > 120) {
@@ -2450,7 +2515,15 @@ static void cliFlashErase(char *cmdline)
 
         cliWriterFlush();
 #endif
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+        // The scheduler isn't running while we wait here, so drive the erase from here instead
+        const timeMs_t dotTimeMs = millis() + 100;
+        while (cmp32(millis(), dotTimeMs) < 0 && flashfsIsErasing()) {
+            flashfsEraseUpdate();
+        }
+#else
         delay(100);
+#endif
     }
     beeper(BEEPER_BLACKBOX_ERASE);
     cliPrintLinefeed();
@@ -4122,7 +4195,19 @@ static void cliDumpRateProfile(uint8_t rateProfileIndex, dumpFlags_t dumpMask)
 #ifdef USE_CLI_BATCH
 static void cliPrintCommandBatchWarning(const char *warning)
 {
+    // The batch is over, so the warning is not counted as a failed command of its last line
+    commandBatchActive = false;
+
     cliPrintErrorLinef("ERRORS WERE DETECTED - PLEASE REVIEW BEFORE CONTINUING");
+
+    if (commandBatchErrorCount) {
+        cliPrintf("###ERROR: %d COMMAND(S) FAILED, IN BATCH LINE(S):", commandBatchErrorCount);
+        for (int i = 0; i < MIN(commandBatchErrorCount, COMMAND_BATCH_MAX_ERROR_LINES); i++) {
+            cliPrintf(" %d", commandBatchErrorLines[i]);
+        }
+        cliPrintLine(commandBatchErrorCount > COMMAND_BATCH_MAX_ERROR_LINES ? " ...###" : "###");
+    }
+
     if (warning) {
         cliPrintErrorLinef(warning);
     }
@@ -4132,23 +4217,48 @@ static void resetCommandBatch(void)
 {
     commandBatchActive = false;
     commandBatchError = false;
+    commandBatchLine = 0;
+    commandBatchErrorCount = 0;
+#ifdef USE_LED_STRIP_STATUS_MODE
+    commandBatchLedConfigChanged = false;
+#endif
+}
+
+// Bring everything that was deferred while the batch ran up to date with the new configuration
+static void applyCommandBatch(void)
+{
+#ifdef USE_LED_STRIP_STATUS_MODE
+    if (commandBatchLedConfigChanged) {
+        reevaluateLedConfig();
+    }
+#endif
+    resetCommandBatch();
+}
+
+// Go back to the configuration as it was last saved, so a batch with errors leaves nothing half applied.
+// The reload replaces anything the batch changed, so the deferred state has to follow it as well.
+static void rollbackCommandBatch(void)
+{
+    readEEPROM();
+    applyCommandBatch();
 }
 
 static void cliBatch(char *cmdline)
 {
     if (strncasecmp(cmdline, "start", 5) == 0) {
         if (!commandBatchActive) {
+            resetCommandBatch();
             commandBatchActive = true;
-            commandBatchError = false;
         }
         cliPrintLine("Command batch started");
     } else if (strncasecmp(cmdline, "end", 3) == 0) {
         if (commandBatchActive && commandBatchError) {
-            cliPrintCommandBatchWarning(NULL);
+            cliPrintCommandBatchWarning("CONFIGURATION ROLLED BACK TO THE SAVED SETTINGS");
+            rollbackCommandBatch();
         } else {
             cliPrintLine("Command batch ended");
+            applyCommandBatch();
         }
-        resetCommandBatch();
     } else {
         cliPrintErrorLinef("Invalid option");
     }
@@ -4188,8 +4298,8 @@ bool tryPrepareSave(void)
     bool success = prepareSave();
 #if defined(USE_CLI_BATCH)
     if (!success) {
-        cliPrintCommandBatchWarning("PLEASE FIX ERRORS THEN 'SAVE'");
-        resetCommandBatch();
+        cliPrintCommandBatchWarning("CONFIGURATION ROLLED BACK TO THE SAVED SETTINGS, PLEASE FIX ERRORS AND TRY AGAIN");
+        rollbackCommandBatch();
 
         return false;
     }
@@ -4219,6 +4329,7 @@ bool resetConfigToCustomDefaults(void)
 
 #ifdef USE_CLI_BATCH
     commandBatchError = false;
+    commandBatchErrorCount = 0;
 #endif
 
     cliProcessCustomDefaults();
@@ -4288,6 +4399,7 @@ static void cliDefaults(char *cmdline)
     // only reset the current error state but the batch will still be active
     // for subsequent commands.
     commandBatchError = false;
+    commandBatchErrorCount = 0;
 #endif
 
 #if defined(USE_CUSTOM_DEFAULTS)
@@ -4376,8 +4488,52 @@ static uint8_t getWordLength(char *bufBegin, char *bufEnd)
     return bufEnd - bufBegin;
 }
 
+#ifdef USE_CLI_VALUE_INDEX
+// Insertion sort of the valueTable indexes by name, run once on the first lookup
+static void buildValueTableNameOrder(void)
+{
+    for (unsigned i = 0; i < valueTableEntryCount; i++) {
+        unsigned j = i;
+        while (j > 0 && strcasecmp(valueTable[valueTableNameOrder[j - 1]].name, valueTable[i].name) > 0) {
+            valueTableNameOrder[j] = valueTableNameOrder[j - 1];
+            j--;
+        }
+        valueTableNameOrder[j] = i;
+    }
+
+    valueTableNameOrderBuilt = true;
+}
+#endif
+
 uint16_t cliGetSettingIndex(char *name, uint8_t length)
 {
+#ifdef USE_CLI_VALUE_INDEX
+    if (!valueTableNameOrderBuilt) {
+        buildValueTableNameOrder();
+    }
+
+    // Binary search, a setting name that the searched name is a prefix of sorts after it
+    unsigned low = 0;
+    unsigned high = valueTableEntryCount;
+    while (low < high) {
+        const unsigned mid = (low + high) / 2;
+        const char *settingName = valueTable[valueTableNameOrder[mid]].name;
+        int cmp = strncasecmp(name, settingName, length);
+        if (cmp == 0) {
+            if (settingName[length] == '\0') {
+                return valueTableNameOrder[mid];
+            }
+            cmp = -1;
+        }
+        if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    return valueTableEntryCount;
+#else
     for (uint32_t i = 0; i < valueTableEntryCount; i++) {
         const char *settingName = valueTable[i].name;
 
@@ -4387,6 +4543,7 @@ uint16_t cliGetSettingIndex(char *name, uint8_t length)
         }
     }
     return valueTableEntryCount;
+#endif
 }
 
 STATIC_UNIT_TESTED void cliSet(char *cmdline)
@@ -4622,6 +4779,13 @@ static void cliStatus(char *cmdline)
 
     cliPrintLinef("Config size: %d, Max available config: %d", getEEPROMConfigSize(), getEEPROMStorageSize());
 
+    // Boot timing
+
+    cliPrintLinef("Boot: config check %dus, config load %dus", (int)bootTiming.configCheckUs, (int)bootTiming.configLoadUs);
+    cliPrintLinef("Boot: config loaded %dms, motors %dms, sensors %dms, ready %dms",
+        (int)(bootTiming.configLoadedAtUs / 1000), (int)(bootTiming.motorsReadyAtUs / 1000),
+        (int)(bootTiming.sensorsReadyAtUs / 1000), (int)(bootTiming.readyAtUs / 1000));
+
     // Sensors
 
 #if defined(USE_SENSOR_NAMES)
@@ -4961,6 +5125,7 @@ const cliResourceValue_t resourceTable[] = {
 #endif
 #ifdef USE_MAX7456
     DEFS( OWNER_OSD_CS,        PG_MAX7456_CONFIG, max7456Config_t, csTag ),
+    DEFS( OWNER_OSD_VSYNC,     PG_MAX7456_CONFIG, max7456Config_t, vsyncTag ),
 #endif
 #ifdef USE_RX_SPI
     DEFS( OWNER_RX_SPI_CS,     PG_RX_SPI_CONFIG, rxSpiConfig_t, csnTag ),
@@ -6451,6 +6616,11 @@ static void processCharacter(const char c)
                     break;
                 }
             }
+#ifdef USE_CLI_BATCH
+            if (commandBatchActive) {
+                commandBatchLine++;
+            }
+#endif
             if (cmd < cmdTable + ARRAYLEN(cmdTable)) {
                 cmd->func(options);
             } else {
@@ -6542,10 +6712,25 @@ void cliProcess(void)
     // Flush the buffer to get rid of any MSP data polls sent by configurator after CLI was invoked
     cliWriterFlush();
 
-    while (serialRxBytesWaiting(cliPort)) {
-        uint8_t c = serialRead(cliPort);
+    const uint8_t *data;
+    uint32_t count;
+    while ((count = serialPeekContiguous(cliPort, &data)) > 0) {
+        uint32_t used = 0;
+        uint8_t c;
+        do {
+            c = data[used++];
+            if (c == '\r' || c == '\n') {
+                break;
+            }
+            processCharacterInteractive(c);
+        } while (used < count);
 
-        processCharacterInteractive(c);
+        // A line is consumed before it is run, so a command that takes the port over
+        // (serialpassthrough) finds the bytes that follow it.
+        serialSkip(cliPort, used);
+        if (c == '\r' || c == '\n') {
+            processCharacterInteractive(c);
+        }
     }
 }
 
@@ -231,6 +231,9 @@ extern const lookupTableEntry_t lookupTables[];
 extern const uint16_t valueTableEntryCount;
 
 extern const clivalue_t valueTable[];
+#ifdef USE_CLI_VALUE_INDEX
+extern uint16_t valueTableNameOrder[];
+#endif
 //extern const uint8_t lookupTablesEntryCount;
 
 extern const char * const lookupTableGyroHardware[];
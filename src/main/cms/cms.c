@@ -247,6 +247,13 @@ static uint8_t cmsCursorAbsolute(displayPort_t *instance)
 
 uint8_t runtimeEntryFlags[CMS_MAX_ROWS] = { 0 };
 
+#ifdef USE_CMS_VALUE_CACHE
+#define CMS_MAX_VALUE_LEN 21    // longest value or label data that is cached, longer ones are always written
+
+// The value last drawn on each row of the page, so a redraw only writes the characters that changed
+static char runtimeEntryValues[CMS_MAX_ROWS][CMS_MAX_VALUE_LEN + 1];
+#endif
+
 static void cmsPageSelect(displayPort_t *instance, int8_t newpage)
 {
     currentCtx.page = (newpage + pageCount) % pageCount;
@@ -350,7 +357,44 @@ static void cmsPadToSize(char *buf, int size)
 #endif
 }
 
-static int cmsDrawMenuItemValue(displayPort_t *pDisplay, char *buff, uint8_t row, uint8_t maxSize)
+// Write a value, or only the part of it that differs from drawnValue if the row holds a cached value
+static int cmsDrawValueString(displayPort_t *pDisplay, uint8_t col, uint8_t row, const char *value, char *drawnValue)
+{
+#ifdef USE_CMS_VALUE_CACHE
+    if (drawnValue) {
+        const int len = strlen(value);
+        if (len > CMS_MAX_VALUE_LEN) {
+            drawnValue[0] = 0;
+            return displayWrite(pDisplay, col, row, value);
+        }
+        if ((int)strlen(drawnValue) == len) {
+            int first = 0;
+            while (first < len && value[first] == drawnValue[first]) {
+                first++;
+            }
+            if (first == len) {
+                return 0;
+            }
+            int last = len - 1;
+            while (value[last] == drawnValue[last]) {
+                last--;
+            }
+
+            char changed[CMS_MAX_VALUE_LEN + 1];
+            memcpy(changed, &value[first], last - first + 1);
+            changed[last - first + 1] = 0;
+            strcpy(drawnValue, value);
+            return displayWrite(pDisplay, col + first, row, changed);
+        }
+        strcpy(drawnValue, value);
+    }
+#else
+    UNUSED(drawnValue);
+#endif
+    return displayWrite(pDisplay, col, row, value);
+}
+
+static int cmsDrawMenuItemValue(displayPort_t *pDisplay, char *buff, uint8_t row, uint8_t maxSize, char *drawnValue)
 {
     int colpos;
     int cnt;
@@ -361,11 +405,11 @@ static int cmsDrawMenuItemValue(displayPort_t *pDisplay, char *buff, uint8_t row
 #else
     colpos = smallScreen ? rightMenuColumn - maxSize : rightMenuColumn;
 #endif
-    cnt = displayWrite(pDisplay, colpos, row, buff);
+    cnt = cmsDrawValueString(pDisplay, colpos, row, buff, drawnValue);
     return cnt;
 }
 
-static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t row, bool selectedRow, uint8_t *flags)
+static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t row, bool selectedRow, uint8_t *flags, char *drawnValue)
 {
     #define CMS_DRAW_BUFFER_LEN 12
     #define CMS_NUM_FIELD_LEN 5
@@ -386,7 +430,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
     case OME_String:
         if (IS_PRINTVALUE(*flags) && p->data) {
             strncpy(buff, p->data, CMS_DRAW_BUFFER_LEN);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_DRAW_BUFFER_LEN);
+            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_DRAW_BUFFER_LEN, drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -407,7 +451,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
             strncat(buff, ">", CMS_DRAW_BUFFER_LEN);
 
             row = smallScreen  ? row - 1  : row;
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, strlen(buff));
+            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, strlen(buff), drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -420,7 +464,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
               strcpy(buff, "NO ");
             }
 
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, 3);
+            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, 3, drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -430,7 +474,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
             OSD_TAB_t *ptr = p->data;
             char * str = (char *)ptr->names[*ptr->val];
             strncpy(buff, str, CMS_DRAW_BUFFER_LEN);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_DRAW_BUFFER_LEN);
+            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_DRAW_BUFFER_LEN, drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -455,7 +499,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
                     }
                 }
             }
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, 3);
+            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, 3, drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -464,8 +508,8 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
     case OME_UINT8:
         if (IS_PRINTVALUE(*flags) && p->data) {
             OSD_UINT8_t *ptr = p->data;
-            itoa(*ptr->val, buff, 10);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
+            formatInt(buff, *ptr->val, 0, ' ');
+            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN, drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -473,8 +517,8 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
     case OME_INT8:
         if (IS_PRINTVALUE(*flags) && p->data) {
             OSD_INT8_t *ptr = p->data;
-            itoa(*ptr->val, buff, 10);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
+            formatInt(buff, *ptr->val, 0, ' ');
+            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN, drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -482,8 +526,8 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
     case OME_UINT16:
         if (IS_PRINTVALUE(*flags) && p->data) {
             OSD_UINT16_t *ptr = p->data;
-            itoa(*ptr->val, buff, 10);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
+            formatInt(buff, *ptr->val, 0, ' ');
+            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN, drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -491,8 +535,8 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
     case OME_INT16:
         if (IS_PRINTVALUE(*flags) && p->data) {
             OSD_UINT16_t *ptr = p->data;
-            itoa(*ptr->val, buff, 10);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
+            formatInt(buff, *ptr->val, 0, ' ');
+            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN, drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -501,7 +545,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
         if (IS_PRINTVALUE(*flags) && p->data) {
             OSD_FLOAT_t *ptr = p->data;
             cmsFormatFloat(*ptr->val * ptr->multipler, buff);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
+            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN, drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -509,7 +553,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
     case OME_Label:
         if (IS_PRINTVALUE(*flags) && p->data) {
             // A label with optional string, immediately following text
-            cnt = displayWrite(pDisplay, leftMenuColumn + 1 + (uint8_t)strlen(p->text), row, p->data);
+            cnt = cmsDrawValueString(pDisplay, leftMenuColumn + 1 + (uint8_t)strlen(p->text), row, p->data, drawnValue);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -561,6 +605,9 @@ static void cmsDrawMenu(displayPort_t *pDisplay, uint32_t currentTimeUs)
         for (p = pageTop, i= 0; (p <= pageTop + pageMaxRow); p++, i++) {
             SET_PRINTLABEL(runtimeEntryFlags[i]);
             SET_PRINTVALUE(runtimeEntryFlags[i]);
+#ifdef USE_CMS_VALUE_CACHE
+            runtimeEntryValues[i][0] = 0;
+#endif
         }
         pDisplay->cleared = false;
     } else if (drawPolled) {
@@ -610,7 +657,12 @@ static void cmsDrawMenu(displayPort_t *pDisplay, uint32_t currentTimeUs)
 
         if (IS_PRINTVALUE(runtimeEntryFlags[i])) {
             bool selectedRow = i == currentCtx.cursorRow;
-            room -= cmsDrawMenuEntry(pDisplay, p, top + i * linesPerMenuItem, selectedRow, &runtimeEntryFlags[i]);
+#ifdef USE_CMS_VALUE_CACHE
+            char *drawnValue = runtimeEntryValues[i];
+#else
+            char *drawnValue = NULL;
+#endif
+            room -= cmsDrawMenuEntry(pDisplay, p, top + i * linesPerMenuItem, selectedRow, &runtimeEntryFlags[i], drawnValue);
             if (room < 30)
                 return;
         }
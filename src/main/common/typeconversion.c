@@ -26,6 +26,7 @@
 
 #include "build/build_config.h"
 #include "maths.h"
+#include "utils.h"
 
 #ifdef REQUIRE_PRINTF_LONG_SUPPORT
 
@@ -199,6 +200,113 @@ char *ftoa(float x, char *floatString)
     return floatString;
 }
 
+char *formatChar(char *buf, char c)
+{
+    *buf++ = c;
+    *buf = 0;
+    return buf;
+}
+
+char *formatString(char *buf, const char *s)
+{
+    while (*s) {
+        *buf++ = *s++;
+    }
+    *buf = 0;
+    return buf;
+}
+
+/*
+ * Decimal value, right aligned in at least width characters with pad in front.
+ * Same as tfp_sprintf's "%u", "%5u" and "%05u".
+ */
+char *formatUnsigned(char *buf, unsigned value, unsigned width, char pad)
+{
+    char digits[10];
+    unsigned count = 0;
+    do {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value);
+
+    for (unsigned i = count; i < width; i++) {
+        *buf++ = pad;
+    }
+    while (count) {
+        *buf++ = digits[--count];
+    }
+    *buf = 0;
+    return buf;
+}
+
+/*
+ * As formatUnsigned(), the width includes the sign, which goes before any zero padding
+ * ("-05" where tfp_sprintf's "%03d" gives "0-5").
+ */
+char *formatInt(char *buf, int value, unsigned width, char pad)
+{
+    if (value >= 0) {
+        return formatUnsigned(buf, value, width, pad);
+    }
+
+    const unsigned magnitude = -(unsigned)value;
+    if (pad == '0') {
+        *buf++ = '-';
+        return formatUnsigned(buf, magnitude, width ? width - 1 : 0, pad);
+    }
+
+    char digits[12];
+    const unsigned length = formatUnsigned(digits + 1, magnitude, 0, pad) - digits;
+    digits[0] = '-';
+    for (unsigned i = length; i < width; i++) {
+        *buf++ = pad;
+    }
+    return formatString(buf, digits);
+}
+
+/*
+ * Fixed point value with the given number of decimals, e.g. 1234 with 2 decimals is "12.34",
+ * right aligned in at least width characters with spaces. The sign is kept for values between
+ * -1 and 0, so -5 with 2 decimals is "-0.05".
+ */
+char *formatFixed(char *buf, int value, unsigned decimals, unsigned width)
+{
+    static const unsigned powersOfTen[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+    decimals = MIN(decimals, ARRAYLEN(powersOfTen) - 1);
+    const unsigned scale = powersOfTen[decimals];
+    const unsigned magnitude = value < 0 ? -(unsigned)value : (unsigned)value;
+
+    unsigned length = (value < 0) + (decimals ? decimals + 1 : 0);
+    for (unsigned integer = magnitude / scale; ; integer /= 10) {
+        length++;
+        if (integer < 10) {
+            break;
+        }
+    }
+    for (; length < width; length++) {
+        *buf++ = ' ';
+    }
+
+    if (value < 0) {
+        *buf++ = '-';
+    }
+    buf = formatUnsigned(buf, magnitude / scale, 0, ' ');
+    if (decimals) {
+        *buf++ = '.';
+        buf = formatUnsigned(buf, magnitude % scale, decimals, '0');
+    }
+    return buf;
+}
+
+// Timer as "mm:ss", minutes are not limited to two digits
+char *formatMinutesSeconds(char *buf, unsigned seconds)
+{
+    buf = formatUnsigned(buf, seconds / 60, 2, '0');
+    *buf++ = ':';
+    return formatUnsigned(buf, seconds % 60, 2, '0');
+}
+
 // Simple and fast atof (ascii to float) function.
 //
 // - Executes about 5x faster than standard MSCRT library atof().
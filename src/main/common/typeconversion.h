@@ -30,6 +30,15 @@ char a2i(char ch, const char **src, int base, int *nump);
 char *ftoa(float x, char *floatString);
 float fastA2F(const char *p);
 
+// Typed formatters for display text. Each writes a NUL terminated string and returns a pointer
+// to the terminator, so that the parts of an element can be written one after another.
+char *formatChar(char *buf, char c);
+char *formatString(char *buf, const char *s);
+char *formatUnsigned(char *buf, unsigned value, unsigned width, char pad);
+char *formatInt(char *buf, int value, unsigned width, char pad);
+char *formatFixed(char *buf, int value, unsigned decimals, unsigned width);
+char *formatMinutesSeconds(char *buf, unsigned seconds);
+
 #ifndef HAVE_ITOA_FUNCTION
 char *itoa(int i, char *a, int r);
 #endif
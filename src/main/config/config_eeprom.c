@@ -19,6 +19,7 @@
  */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -27,6 +28,7 @@
 #include "build/build_config.h"
 
 #include "common/crc.h"
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "config/config_eeprom.h"
@@ -43,6 +45,12 @@
 
 static uint16_t eepromConfigSize;
 
+// Offset of the stored record of each registered PG, by registry position, 0 if it is missing.
+// Built while the structure is validated, so loading doesn't have to scan the records per PG.
+#define EEPROM_INDEX_SIZE       256
+static uint16_t eepromIndex[EEPROM_INDEX_SIZE];
+static bool eepromIndexValid;
+
 typedef enum {
     CR_CLASSICATION_SYSTEM   = 0,
     CR_CLASSICATION_PROFILE_LAST = CR_CLASSICATION_SYSTEM,
@@ -77,6 +85,38 @@ typedef struct {
 } PG_PACKED configFooter_t;
 // checksum is appended just after footer. It is not included in footer to make checksum calculation consistent
 
+#ifdef USE_CONFIG_JOURNAL
+// Saves append the PGs that changed as journal records after the full copy, in the
+// part of its flash page that is still erased, instead of erasing and rewriting the
+// whole sector. All records of one save share a sequence number and the last one is
+// flagged CJ_FLAG_COMMIT, so a save interrupted by a power loss is ignored as a whole.
+// When the page is full or the journal has a torn tail the next save compacts
+// everything back into a fresh full copy.
+#define CJ_FLAG_COMMIT          0x80
+
+// Header for each journal record, followed by the inverted big endian CRC like the full copy.
+typedef struct {
+    uint16_t size;              // header, pg and CRC, without the padding to the next write unit
+    uint16_t sequence;          // number of the save that wrote the record, counting from 1
+    uint16_t baseCrc;           // stored CRC of the full copy the record applies to
+    pgn_t pgn;
+    uint8_t version;
+    uint8_t flags;              // classification as for configRecord_t, plus CJ_FLAG_COMMIT
+    uint8_t pg[];
+} PG_PACKED configJournalRecord_t;
+
+typedef struct {
+    const uint8_t *start;       // first record, just after the full copy
+    const uint8_t *limit;       // end of the erased area available to the journal
+    const uint8_t *committedEnd; // end of the last complete save
+    uint16_t sequence;          // sequence number of the last complete save
+    bool appendable;            // nothing but erased flash follows committedEnd
+} configJournal_t;
+
+static const uint8_t *eepromImageEnd;   // end of the full copy, NULL if it is not valid
+static uint16_t eepromImageCrc;
+#endif
+
 // Used to check the compiler packing at build time.
 typedef struct {
     uint8_t byte;
@@ -251,6 +291,9 @@ void initEEPROM(void)
 
     STATIC_ASSERT(sizeof(configFooter_t) == 2, footer_size_failed);
     STATIC_ASSERT(sizeof(configRecord_t) == 6, record_size_failed);
+#ifdef USE_CONFIG_JOURNAL
+    STATIC_ASSERT(sizeof(configJournalRecord_t) == 10, journal_record_size_failed);
+#endif
 
 #if defined(CONFIG_IN_FILE)
     loadEEPROMFromFile();
@@ -291,10 +334,14 @@ bool isEEPROMStructureValid(void)
         return false;
     }
 
+    eepromIndexValid = false;
+    memset(eepromIndex, 0, sizeof(eepromIndex));
+
     uint16_t crc = CRC_START_VALUE;
     crc = crc16_ccitt_update(crc, header, sizeof(*header));
     p += sizeof(*header);
 
+    const pgRegistry_t *nextReg = __pg_registry_start;
     for (;;) {
         const configRecord_t *record = (const configRecord_t *)p;
 
@@ -310,6 +357,16 @@ bool isEEPROMStructureValid(void)
 
         crc = crc16_ccitt_update(crc, p, record->size);
 
+        // records are written in registry order, so the next registry entry is nearly always the one
+        const pgRegistry_t *reg = (nextReg < __pg_registry_end && pgN(nextReg) == record->pgn) ? nextReg : pgFind(record->pgn);
+        if (reg) {
+            const ptrdiff_t index = reg - __pg_registry_start;
+            if (index < EEPROM_INDEX_SIZE && (record->flags & CR_CLASSIFICATION_MASK) == CR_CLASSICATION_SYSTEM) {
+                eepromIndex[index] = p - &__config_start;
+            }
+            nextReg = reg + 1;
+        }
+
         p += record->size;
     }
 
@@ -320,9 +377,16 @@ bool isEEPROMStructureValid(void)
     // include stored CRC in the CRC calculation
     const uint16_t *storedCrc = (const uint16_t *)p;
     crc = crc16_ccitt_update(crc, storedCrc, sizeof(*storedCrc));
-    p += sizeof(storedCrc);
+#ifdef USE_CONFIG_JOURNAL
+    eepromImageCrc = p[0] | (p[1] << 8);
+#endif
+    p += sizeof(*storedCrc);
 
     eepromConfigSize = p - &__config_start;
+    eepromIndexValid = crc == CRC_CHECK_VALUE;
+#ifdef USE_CONFIG_JOURNAL
+    eepromImageEnd = eepromIndexValid ? p : NULL;
+#endif
 
     // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
     return crc == CRC_CHECK_VALUE;
@@ -352,6 +416,12 @@ size_t getEEPROMStorageSize(void)
 // this function assumes that EEPROM content is valid
 static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification)
 {
+    const ptrdiff_t index = reg - __pg_registry_start;
+    if (eepromIndexValid && classification == CR_CLASSICATION_SYSTEM && index < EEPROM_INDEX_SIZE) {
+        const uint16_t offset = eepromIndex[index];
+        return offset ? (const configRecord_t *)(&__config_start + offset) : NULL;
+    }
+
     const uint8_t *p = &__config_start;
     p += sizeof(configHeader_t);             // skip header
     while (true) {
@@ -369,9 +439,94 @@ static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFla
     return NULL;
 }
 
+#ifdef USE_CONFIG_JOURNAL
+static uint16_t journalRecordSpace(size_t size)
+{
+    return (size + CONFIG_STREAMER_BUFFER_SIZE - 1) & ~(CONFIG_STREAMER_BUFFER_SIZE - 1);
+}
+
+// Walk the journal behind a valid full copy. Records are only accepted in sequence,
+// with the CRC of the current full copy and an intact CRC of their own, so torn writes
+// and leftovers from an older copy end the scan.
+static bool scanJournal(configJournal_t *journal)
+{
+    if (!eepromImageEnd) {
+        return false;
+    }
+
+    journal->start = &__config_start + journalRecordSpace(eepromImageEnd - &__config_start);
+    journal->limit = MIN((const uint8_t *)config_streamer_page_end((uintptr_t)eepromImageEnd - 1), &__config_end);
+    journal->committedEnd = journal->start;
+    journal->sequence = 0;
+
+    const uint8_t *p = journal->start;
+    bool erased = true;
+    while (p + sizeof(configJournalRecord_t) <= journal->limit) {
+        const configJournalRecord_t *record = (const configJournalRecord_t *)p;
+
+        if (record->size == 0xFFFF) {
+            // Erased flash, nothing has been appended here yet.
+            break;
+        }
+        if (record->size < sizeof(*record) + sizeof(uint16_t)
+            || p + record->size > journal->limit
+            || record->sequence != (uint16_t)(journal->sequence + 1)
+            || record->baseCrc != eepromImageCrc
+            || crc16_ccitt_update(CRC_START_VALUE, p, record->size) != CRC_CHECK_VALUE) {
+            erased = false;
+            break;
+        }
+
+        p += journalRecordSpace(record->size);
+        if (record->flags & CJ_FLAG_COMMIT) {
+            journal->committedEnd = p;
+            journal->sequence = record->sequence;
+        }
+    }
+
+    // Records of an interrupted save, or a torn record, can't be programmed over.
+    journal->appendable = erased && p == journal->committedEnd;
+
+    return true;
+}
+
+// find the newest committed journal record for reg, NULL if the full copy is current
+static const configJournalRecord_t *findJournal(const configJournal_t *journal, const pgRegistry_t *reg)
+{
+    const configJournalRecord_t *found = NULL;
+    for (const uint8_t *p = journal->start; p < journal->committedEnd; ) {
+        const configJournalRecord_t *record = (const configJournalRecord_t *)p;
+        if (pgN(reg) == record->pgn
+            && (record->flags & CR_CLASSIFICATION_MASK) == CR_CLASSICATION_SYSTEM) {
+            found = record;
+        }
+        p += journalRecordSpace(record->size);
+    }
+    return found;
+}
+
+static void loadJournal(void)
+{
+    configJournal_t journal;
+    if (!scanJournal(&journal)) {
+        return;
+    }
+
+    // records are in save order, so loading all of them leaves each PG with its newest one
+    for (const uint8_t *p = journal.start; p < journal.committedEnd; ) {
+        const configJournalRecord_t *record = (const configJournalRecord_t *)p;
+        const pgRegistry_t *reg = pgFind(record->pgn);
+        if (reg && (record->flags & CR_CLASSIFICATION_MASK) == CR_CLASSICATION_SYSTEM) {
+            pgLoad(reg, record->pg, record->size - offsetof(configJournalRecord_t, pg) - sizeof(uint16_t), record->version);
+        }
+        p += journalRecordSpace(record->size);
+    }
+}
+#endif
+
 // Initialize all PG records from EEPROM.
-// This functions processes all PGs sequentially, scanning EEPROM for each one. This is suboptimal,
-//   but each PG is loaded/initialized exactly once and in defined order.
+// This functions processes all PGs sequentially, looking each one up in the index built by
+//   isEEPROMStructureValid(), so each PG is loaded/initialized exactly once and in defined order.
 bool loadEEPROM(void)
 {
     bool success = true;
@@ -390,11 +545,18 @@ bool loadEEPROM(void)
         }
     }
 
+#ifdef USE_CONFIG_JOURNAL
+    loadJournal();
+#endif
+
     return success;
 }
 
 static bool writeSettingsToEEPROM(void)
 {
+    // the index is rebuilt when the new copy is validated
+    eepromIndexValid = false;
+
     config_streamer_t streamer;
     config_streamer_init(&streamer);
 
@@ -442,8 +604,109 @@ static bool writeSettingsToEEPROM(void)
     return success;
 }
 
+#ifdef USE_CONFIG_JOURNAL
+static bool pgMatchesStoredConfig(const configJournal_t *journal, const pgRegistry_t *reg)
+{
+    const configJournalRecord_t *journalRecord = findJournal(journal, reg);
+    const uint8_t *pg;
+    uint16_t size;
+    uint8_t version;
+    if (journalRecord) {
+        pg = journalRecord->pg;
+        size = journalRecord->size - offsetof(configJournalRecord_t, pg) - sizeof(uint16_t);
+        version = journalRecord->version;
+    } else {
+        const configRecord_t *record = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+        if (!record) {
+            return false;
+        }
+        pg = record->pg;
+        size = record->size - offsetof(configRecord_t, pg);
+        version = record->version;
+    }
+
+    return version == pgVersion(reg) && size == pgSize(reg) && memcmp(pg, reg->address, size) == 0;
+}
+
+// Append the PGs that differ from the stored config as one journal save.
+// Returns false if the journal can't take them and a full rewrite is needed.
+static bool appendSettingsToJournal(void)
+{
+    configJournal_t journal;
+    if (!isEEPROMVersionValid() || !isEEPROMStructureValid() || !scanJournal(&journal) || !journal.appendable) {
+        return false;
+    }
+
+    int changedCount = 0;
+    size_t space = 0;
+    PG_FOREACH(reg) {
+        if (!pgMatchesStoredConfig(&journal, reg)) {
+            changedCount++;
+            space += journalRecordSpace(sizeof(configJournalRecord_t) + pgSize(reg) + sizeof(uint16_t));
+        }
+    }
+
+    if (changedCount == 0) {
+        return true;
+    }
+    if (space > (size_t)(journal.limit - journal.committedEnd)) {
+        return false;
+    }
+
+    // The journal never reaches into the next flash page, so nothing gets erased here.
+    config_streamer_t streamer;
+    config_streamer_init(&streamer);
+
+    config_streamer_start(&streamer, (uintptr_t)journal.committedEnd, journal.limit - journal.committedEnd);
+
+    const uint16_t sequence = journal.sequence + 1;
+    PG_FOREACH(reg) {
+        if (pgMatchesStoredConfig(&journal, reg)) {
+            continue;
+        }
+
+        const uint16_t regSize = pgSize(reg);
+        configJournalRecord_t record = {
+            .size = sizeof(configJournalRecord_t) + regSize + sizeof(uint16_t),
+            .sequence = sequence,
+            .baseCrc = eepromImageCrc,
+            .pgn = pgN(reg),
+            .version = pgVersion(reg),
+            .flags = CR_CLASSICATION_SYSTEM
+        };
+        if (--changedCount == 0) {
+            record.flags |= CJ_FLAG_COMMIT;
+        }
+
+        config_streamer_write(&streamer, (uint8_t *)&record, sizeof(record));
+        uint16_t crc = crc16_ccitt_update(CRC_START_VALUE, (uint8_t *)&record, sizeof(record));
+        config_streamer_write(&streamer, reg->address, regSize);
+        crc = crc16_ccitt_update(crc, reg->address, regSize);
+
+        const uint16_t invertedBigEndianCrc = ~(((crc & 0xFF) << 8) | (crc >> 8));
+        config_streamer_write(&streamer, (uint8_t *)&invertedBigEndianCrc, sizeof(crc));
+
+        // pad each record to the write size, so the next one starts on its own word
+        config_streamer_flush(&streamer);
+    }
+
+    if (config_streamer_finish(&streamer) != 0) {
+        return false;
+    }
+
+    // read it back, a save that did not commit gets compacted into a full copy instead
+    return scanJournal(&journal) && journal.sequence == sequence && journal.appendable;
+}
+#endif
+
 void writeConfigToEEPROM(void)
 {
+#ifdef USE_CONFIG_JOURNAL
+    if (appendSettingsToJournal()) {
+        return;
+    }
+#endif
+
     bool success = false;
     // write it
     for (int attempt = 0; attempt < 3 && !success; attempt++) {
@@ -27,15 +27,6 @@
 
 #include "config/config_streamer.h"
 
-#if !defined(CONFIG_IN_FLASH)
-#if defined(CONFIG_IN_RAM) && defined(PERSISTENT)
-PERSISTENT uint8_t eepromData[EEPROM_SIZE];
-#else
-uint8_t eepromData[EEPROM_SIZE];
-#endif
-#endif
-
-
 #if defined(STM32H750xx) && !(defined(CONFIG_IN_EXTERNAL_FLASH) || defined(CONFIG_IN_RAM) || defined(CONFIG_IN_SDCARD))
 #error "STM32750xx only has one flash page which contains the bootloader, no spare flash pages available, use external storage for persistent config or ram for target testing"
 #endif
@@ -72,14 +63,22 @@ uint8_t eepromData[EEPROM_SIZE];
 // H7
 # elif defined(STM32H743xx) || defined(STM32H750xx)
 #  define FLASH_PAGE_SIZE                 ((uint32_t)0x20000) // 128K sectors
-// SIMULATOR
-# elif defined(SIMULATOR_BUILD)
-#  define FLASH_PAGE_SIZE                 (0x400)
 # else
 #  error "Flash page size not defined for target."
 # endif
 #endif
 
+#if !defined(CONFIG_IN_FLASH)
+#if defined(CONFIG_IN_RAM) && defined(PERSISTENT)
+PERSISTENT uint8_t eepromData[EEPROM_SIZE];
+#elif defined(CONFIG_IN_FILE)
+// page aligned like the linker placed config area, so page erases line up with it
+uint8_t eepromData[EEPROM_SIZE] __attribute__((aligned(FLASH_PAGE_SIZE)));
+#else
+uint8_t eepromData[EEPROM_SIZE];
+#endif
+#endif
+
 void config_streamer_init(config_streamer_t *c)
 {
     memset(c, 0, sizeof(*c));
@@ -500,6 +499,14 @@ int config_streamer_write(config_streamer_t *c, const uint8_t *p, uint32_t size)
     return c->err;
 }
 
+// Returns the end of the flash page holding address. A page is erased as a whole when
+// writing enters it, so everything after the last byte written up to this point is
+// still erased and can be programmed later without another erase.
+uintptr_t config_streamer_page_end(uintptr_t address)
+{
+    return (address / FLASH_PAGE_SIZE + 1) * FLASH_PAGE_SIZE;
+}
+
 int config_streamer_status(config_streamer_t *c)
 {
     return c->err;
@@ -0,0 +1,78 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Block CRCs on the programmable CRC unit of the F7 and H7.
+ * The F4 unit only does CRC-32 on whole words, so it is not used.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_CRC_HARDWARE
+
+#include "build/atomic.h"
+
+#include "drivers/crc_hw.h"
+#include "drivers/nvic.h"
+
+static bool crcHardwareEnabled;
+static volatile bool crcHardwareBusy;
+
+// Returns false, leaving crc untouched, if the unit is already in use by an interrupted caller.
+bool crcHardwareCcitt16(uint16_t *crc, const void *data, uint32_t length)
+{
+    bool claimed = false;
+    ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+        if (!crcHardwareBusy) {
+            crcHardwareBusy = true;
+            claimed = true;
+        }
+    }
+    if (!claimed) {
+        return false;
+    }
+
+    if (!crcHardwareEnabled) {
+        __HAL_RCC_CRC_CLK_ENABLE();
+        crcHardwareEnabled = true;
+    }
+
+    // CRC-16/CCITT: 16 bit polynomial, no reflection, reset loads the running value from INIT
+    CRC->POL = 0x1021;
+    CRC->INIT = *crc;
+    CRC->CR = CRC_CR_POLYSIZE_0 | CRC_CR_RESET;
+
+    const uint8_t *p = (const uint8_t *)data;
+    const uint8_t *pend = p + length;
+    for (; p != pend; p++) {
+        *(__IO uint8_t *)&CRC->DR = *p;
+    }
+
+    *crc = (uint16_t)CRC->DR;
+
+    crcHardwareBusy = false;
+
+    return true;
+}
+
+#endif
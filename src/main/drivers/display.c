@@ -142,6 +142,15 @@ bool displayLayerCopy(displayPort_t *instance, displayPortLayer_e destLayer, dis
     return false;
 }
 
+// Time until the display next writes its changes, 0 while it is writing them
+timeDelta_t displayCommitDelay(const displayPort_t *instance, timeUs_t currentTimeUs)
+{
+    if (instance->vTable->commitDelay) {
+        return instance->vTable->commitDelay(instance, currentTimeUs);
+    }
+    return DISPLAYPORT_NOT_FRAME_SYNCED;
+}
+
 void displayInit(displayPort_t *instance, const displayPortVTable_t *vTable)
 {
     instance->vTable = vTable;
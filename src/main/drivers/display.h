@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 typedef enum {
     DISPLAYPORT_LAYER_FOREGROUND,
     DISPLAYPORT_LAYER_BACKGROUND,
@@ -59,8 +61,12 @@ typedef struct displayPortVTable_s {
     bool (*layerSupported)(displayPort_t *displayPort, displayPortLayer_e layer);
     bool (*layerSelect)(displayPort_t *displayPort, displayPortLayer_e layer);
     bool (*layerCopy)(displayPort_t *displayPort, displayPortLayer_e destLayer, displayPortLayer_e sourceLayer);
+    timeDelta_t (*commitDelay)(const displayPort_t *displayPort, timeUs_t currentTimeUs);
 } displayPortVTable_t;
 
+// Returned by displayCommitDelay() when the display writes its changes as soon as they're drawn
+#define DISPLAYPORT_NOT_FRAME_SYNCED -1
+
 void displayGrab(displayPort_t *instance);
 void displayRelease(displayPort_t *instance);
 void displayReleaseAll(displayPort_t *instance);
@@ -80,4 +86,5 @@ void displayInit(displayPort_t *instance, const displayPortVTable_t *vTable);
 bool displayLayerSupported(displayPort_t *instance, displayPortLayer_e layer);
 bool displayLayerSelect(displayPort_t *instance, displayPortLayer_e layer);
 bool displayLayerCopy(displayPort_t *instance, displayPortLayer_e destLayer, displayPortLayer_e sourceLayer);
+timeDelta_t displayCommitDelay(const displayPort_t *instance, timeUs_t currentTimeUs);
 
@@ -326,6 +326,13 @@ static void flashConfigurePartitions(void)
     startSector = 0;
 #endif
 
+#if defined(USE_FLASHFS_LOG_INDEX)
+    // The log index takes the last sector in front of the firmware/config partitions
+    flashPartitionSet(FLASH_PARTITION_TYPE_FLASHFS_INDEX, endSector, endSector);
+
+    endSector = endSector - 1;
+#endif
+
 #ifdef USE_FLASHFS
     flashPartitionSet(FLASH_PARTITION_TYPE_FLASHFS, startSector, endSector);
 #endif
@@ -376,6 +383,7 @@ static const char *flashPartitionNames[] = {
     "BBMGMT   ",
     "FIRMWARE ",
     "CONFIG   ",
+    "FLASHIDX ",
 };
 
 const char *flashPartitionGetTypeName(flashPartitionType_e type)
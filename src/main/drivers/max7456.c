@@ -28,11 +28,14 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
+
 #include "pg/max7456.h"
 #include "pg/vcd.h"
 
 #include "drivers/bus_spi.h"
 #include "drivers/dma.h"
+#include "drivers/exti.h"
 #include "drivers/io.h"
 #include "drivers/light_led.h"
 #include "drivers/max7456.h"
@@ -162,7 +165,7 @@
 #define MAX7456ADD_OSDBL        0x6c
 #define MAX7456ADD_STAT         0xA0
 
-#define NVM_RAM_SIZE            54
+#define NVM_RAM_SIZE            MAX7456_NVM_CHAR_SIZE
 #define WRITE_NVR               0xA0
 
 // Device type
@@ -204,15 +207,59 @@ uint16_t maxScreenSize = VIDEO_BUFFER_CHARS_PAL;
 
 static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
 
+// Foreground positions that may differ from the shadowBuffer. They are set by
+// the write paths, so drawing only has to look at characters that were changed.
+
+static uint32_t dirtyBits[(VIDEO_BUFFER_CHARS_PAL + 31) / 32];
+#define SET_DIRTY(pos) (dirtyBits[(pos) / 32] |= (1U << ((pos) % 32)))
+#define CLR_DIRTY(pos) (dirtyBits[(pos) / 32] &= ~(1U << ((pos) % 32)))
+#define IS_DIRTY(pos) (dirtyBits[(pos) / 32] & (1U << ((pos) % 32)))
+
 //Max chars to update in one idle
 
 #define MAX_CHARS2UPDATE    100
+
+// Runs of changed characters at least this long are written in auto-increment mode,
+// costing 10 bytes to set up and 2 bytes per character instead of 6 bytes per character.
+#define MIN_AUTO_INCREMENT_RUN  3
+#define AUTO_INCREMENT_RUN_BYTES(length) (10 + 2 * (length))
+#define ADDRESSED_WRITE_BYTES   6
 #ifdef MAX7456_DMA_CHANNEL_TX
 volatile bool dmaTransactionInProgress = false;
 #endif
 
 static uint8_t spiBuff[MAX_CHARS2UPDATE*6];
 
+#ifdef USE_OSD_FRAME_SYNC
+// Field periods of the video signal, each field starts with a vertical sync
+#define FIELD_PERIOD_PAL_US         20000
+#define FIELD_PERIOD_NTSC_US        16683
+// Display memory is written from the start of vertical sync until before the first visible
+// line, a little less than the vertical blanking interval of either system.
+#define COMMIT_WINDOW_US            1000
+// The VSYNC interrupt comes every field, a frame clock without one for this long has lost the video
+#define FRAME_CLOCK_VALID_US        2000000
+
+// The slower of the SPI kernel clocks the SPIClockDivider_e dividers apply to, so that a burst
+// sized from it fits in the commit window on either bus.
+#if defined(STM32F4)
+#define SPI_BUS_CLOCK_MHZ           42
+#elif defined(STM32F7)
+#define SPI_BUS_CLOCK_MHZ           54
+#elif defined(STM32H7)
+#define SPI_BUS_CLOCK_MHZ           100
+#else
+#define SPI_BUS_CLOCK_MHZ           36
+#endif
+// A quarter of the time is left for the gaps between bytes and the chip select
+#define COMMIT_BUS_TIME_PERCENT     75
+
+static bool frameSyncEnabled = false;
+static volatile bool frameClockAnchored = false;
+static volatile timeUs_t frameStartUs;
+static extiCallbackRec_t vsyncExtiCallbackRec;
+#endif
+
 static uint8_t  videoSignalCfg;
 static uint8_t  videoSignalReg  = OSD_ENABLE; // OSD_ENABLE required to trigger first ReInit
 static uint8_t  displayMemoryModeReg = 0;
@@ -222,6 +269,22 @@ static uint8_t  vosRegValue; // VOS (Vertical offset register) value
 
 static bool fontIsLoading       = false;
 
+#ifdef USE_OSD_FONT_QUEUE
+// Characters waiting to be programmed into the NVM, the oldest one is programmed while fontNvmBusy is set
+#define FONT_QUEUE_SIZE         8
+
+typedef struct max7456FontChar_s {
+    uint8_t address;
+    uint8_t data[NVM_RAM_SIZE];
+} max7456FontChar_t;
+
+static max7456FontChar_t fontQueue[FONT_QUEUE_SIZE];
+static uint8_t fontQueueTail;
+static uint8_t fontQueueCount;
+static bool fontNvmBusy;
+static uint16_t fontCharsWritten;
+#endif
+
 static uint8_t max7456DeviceType;
 
 // previous states initialized outside the valid range to force update on first call
@@ -363,6 +426,72 @@ void max7456_dma_irq_handler(dmaChannelDescriptor_t* descriptor)
 
 #endif
 
+#ifdef USE_OSD_FRAME_SYNC
+static void max7456VsyncExtiHandler(extiCallbackRec_t *cb)
+{
+    UNUSED(cb);
+    frameStartUs = microsISR();
+    frameClockAnchored = true;
+}
+
+// Frame sync needs the VSYNC output of the chip. Polling STAT for the short
+// vertical sync pulse rarely finds it, so without the pin writes go out immediately.
+static void max7456FrameSyncInit(const max7456Config_t *max7456Config)
+{
+    frameSyncEnabled = false;
+    frameClockAnchored = false;
+
+    if (max7456Config->frameSync && max7456Config->vsyncTag) {
+        IO_t io = IOGetByTag(max7456Config->vsyncTag);
+        if (IOIsFreeOrPreinit(io)) {
+            IOInit(io, OWNER_OSD_VSYNC, 0);
+            EXTIHandlerInit(&vsyncExtiCallbackRec, max7456VsyncExtiHandler);
+            EXTIConfig(io, &vsyncExtiCallbackRec, NVIC_PRIO_MAX7456_VSYNC, IOCFG_IPU, EXTI_TRIGGER_FALLING);
+            EXTIEnable(io, true);
+            frameSyncEnabled = true;
+        }
+    }
+}
+
+/**
+ * Time until display memory writes are next committed, 0 during the commit window at the start of
+ * each field, or DISPLAYPORT_NOT_FRAME_SYNCED when the frame clock isn't known and writes go out
+ * immediately.
+ */
+timeDelta_t max7456CommitDelayUs(timeUs_t currentTimeUs)
+{
+    if (!frameSyncEnabled || !frameClockAnchored) {
+        return DISPLAYPORT_NOT_FRAME_SYNCED;
+    }
+
+    const timeDelta_t sinceFrameStartUs = cmpTimeUs(currentTimeUs, frameStartUs);
+    if (sinceFrameStartUs < 0) {
+        // the VSYNC interrupt came after currentTimeUs was taken
+        return 0;
+    }
+    if (sinceFrameStartUs > FRAME_CLOCK_VALID_US) {
+        return DISPLAYPORT_NOT_FRAME_SYNCED;
+    }
+
+    const timeDelta_t fieldPeriodUs = (videoSignalReg & VIDEO_MODE_PAL) ? FIELD_PERIOD_PAL_US : FIELD_PERIOD_NTSC_US;
+    const timeDelta_t phaseUs = sinceFrameStartUs % fieldPeriodUs;
+    return phaseUs < COMMIT_WINDOW_US ? 0 : fieldPeriodUs - phaseUs;
+}
+
+// How many bytes can be sent before the commit window that currentTimeUs lies in closes
+static unsigned max7456CommitWindowBytes(timeUs_t currentTimeUs)
+{
+    const timeDelta_t sinceFrameStartUs = cmpTimeUs(currentTimeUs, frameStartUs);
+    const timeDelta_t fieldPeriodUs = (videoSignalReg & VIDEO_MODE_PAL) ? FIELD_PERIOD_PAL_US : FIELD_PERIOD_NTSC_US;
+    const timeDelta_t remainingUs = COMMIT_WINDOW_US - (sinceFrameStartUs < 0 ? 0 : sinceFrameStartUs % fieldPeriodUs);
+    if (remainingUs <= 0) {
+        return 0;
+    }
+
+    return (uint32_t)remainingUs * COMMIT_BUS_TIME_PERCENT / 100 * SPI_BUS_CLOCK_MHZ / (max7456SpiClock * 8);
+}
+#endif
+
 uint8_t max7456GetRowsCount(void)
 {
     return (videoSignalReg & VIDEO_MODE_PAL) ? VIDEO_LINES_PAL : VIDEO_LINES_NTSC;
@@ -373,12 +502,31 @@ uint8_t max7456GetRowsCount(void)
 static void max7456ClearShadowBuffer(void)
 {
     memset(shadowBuffer, 0, maxScreenSize);
+    memset(dirtyBits, 0xff, sizeof(dirtyBits));
+}
+
+// Writes a character to a layer, flagging foreground changes for max7456DrawScreen()
+static void max7456SetChar(displayPortLayer_e layer, uint16_t pos, uint8_t c)
+{
+    uint8_t *buffer = getLayerBuffer(layer);
+    if (buffer[pos] != c) {
+        buffer[pos] = c;
+        if (layer == DISPLAYPORT_LAYER_FOREGROUND) {
+            SET_DIRTY(pos);
+        }
+    }
 }
 
 // Buffer is filled with the whitespace character (0x20)
 static void max7456ClearLayer(displayPortLayer_e layer)
 {
-    memset(getLayerBuffer(layer), 0x20, VIDEO_BUFFER_CHARS_PAL);
+    if (layer == DISPLAYPORT_LAYER_FOREGROUND) {
+        for (unsigned pos = 0; pos < VIDEO_BUFFER_CHARS_PAL; pos++) {
+            max7456SetChar(layer, pos, 0x20);
+        }
+    } else {
+        memset(getLayerBuffer(layer), 0x20, VIDEO_BUFFER_CHARS_PAL);
+    }
 }
 
 
@@ -457,6 +605,7 @@ bool max7456Init(const max7456Config_t *max7456Config, const vcdProfile_t *pVcdP
     for (unsigned i = 0; i < MAX7456_SUPPORTED_LAYER_COUNT; i++) {
         max7456ClearLayer(i);
     }
+    max7456ClearShadowBuffer();
 
     max7456HardwareReset();
 
@@ -558,6 +707,10 @@ bool max7456Init(const max7456Config_t *max7456Config, const vcdProfile_t *pVcdP
     dmaSetHandler(MAX7456_DMA_IRQ_HANDLER_ID, max7456_dma_irq_handler, NVIC_PRIO_MAX7456_DMA, 0);
 #endif
 
+#ifdef USE_OSD_FRAME_SYNC
+    max7456FrameSyncInit(max7456Config);
+#endif
+
     // Real init will be made later when driver detect idle.
     return true;
 }
@@ -611,18 +764,16 @@ void max7456ClearScreen(void)
 
 void max7456WriteChar(uint8_t x, uint8_t y, uint8_t c)
 {
-    uint8_t *buffer = getActiveLayerBuffer();
     if (x < CHARS_PER_LINE && y < VIDEO_LINES_PAL) {
-        buffer[y * CHARS_PER_LINE + x] = c;
+        max7456SetChar(activeLayer, y * CHARS_PER_LINE + x, c);
     }
 }
 
 void max7456Write(uint8_t x, uint8_t y, const char *buff)
 {
     if (y < VIDEO_LINES_PAL) {
-        uint8_t *buffer = getActiveLayerBuffer();
         for (int i = 0; buff[i] && x + i < CHARS_PER_LINE; i++) {
-            buffer[y * CHARS_PER_LINE + x + i] = buff[i];
+            max7456SetChar(activeLayer, y * CHARS_PER_LINE + x + i, buff[i]);
         }
     }
 }
@@ -649,7 +800,14 @@ bool max7456LayerSelect(displayPortLayer_e layer)
 bool max7456LayerCopy(displayPortLayer_e destLayer, displayPortLayer_e sourceLayer)
 {
     if ((sourceLayer != destLayer) && max7456LayerSupported(sourceLayer) && max7456LayerSupported(destLayer)) {
-        memcpy(getLayerBuffer(destLayer), getLayerBuffer(sourceLayer), VIDEO_BUFFER_CHARS_PAL);
+        if (destLayer == DISPLAYPORT_LAYER_FOREGROUND) {
+            const uint8_t *source = getLayerBuffer(sourceLayer);
+            for (unsigned pos = 0; pos < VIDEO_BUFFER_CHARS_PAL; pos++) {
+                max7456SetChar(destLayer, pos, source[pos]);
+            }
+        } else {
+            memcpy(getLayerBuffer(destLayer), getLayerBuffer(sourceLayer), VIDEO_BUFFER_CHARS_PAL);
+        }
         return true;
     } else {
         return false;
@@ -665,11 +823,21 @@ bool max7456DmaInProgress(void)
 #endif
 }
 
+// Only characters flagged dirty can differ from the shadowBuffer, this is cheap enough to poll
 bool max7456BuffersSynced(void)
 {
-    for (int i = 0; i < maxScreenSize; i++) {
-        if (displayLayers[DISPLAYPORT_LAYER_FOREGROUND].buffer[i] != shadowBuffer[i]) {
-            return false;
+    const uint8_t *buffer = getLayerBuffer(DISPLAYPORT_LAYER_FOREGROUND);
+
+    for (unsigned pos = 0; pos < maxScreenSize; pos++) {
+        if (!dirtyBits[pos / 32]) {
+            pos |= 31;
+            continue;
+        }
+        if (IS_DIRTY(pos)) {
+            if (buffer[pos] != shadowBuffer[pos]) {
+                return false;
+            }
+            CLR_DIRTY(pos);
         }
     }
     return true;
@@ -730,21 +898,87 @@ void max7456ReInitIfRequired(bool forceStallCheck)
     //------------   end of (re)init-------------------------------------
 }
 
-void max7456DrawScreen(void)
+// Length of the run of changed characters starting at pos that can be written in auto-increment mode
+static unsigned max7456ChangedRunLength(const uint8_t *buffer, unsigned pos, unsigned maxLength)
 {
-    static uint16_t pos = 0;
+    unsigned length = 0;
+    while (length < maxLength && pos + length < maxScreenSize
+        && buffer[pos + length] != shadowBuffer[pos + length] && buffer[pos + length] != END_STRING) {
+        length++;
+    }
+    return length;
+}
 
+void max7456DrawScreen(void)
+{
     if (!fontIsLoading) {
 
         // (Re)Initialize MAX7456 at startup or stall is detected.
 
         max7456ReInitIfRequired(false);
 
-        uint8_t *buffer = getActiveLayerBuffer();
+        unsigned maxBuffLen = sizeof(spiBuff);
 
-        int buff_len = 0;
-        for (int k = 0; k < MAX_CHARS2UPDATE; k++) {
-            if (buffer[pos] != shadowBuffer[pos]) {
+#ifdef USE_OSD_FRAME_SYNC
+        if (frameSyncEnabled) {
+            // Hold the changes back until the next vertical blanking interval so that a
+            // rendered screen doesn't appear partially updated in the video.
+            const timeUs_t currentTimeUs = micros();
+            const timeDelta_t commitDelayUs = max7456CommitDelayUs(currentTimeUs);
+            if (commitDelayUs > 0) {
+                return;
+            }
+            if (commitDelayUs == 0) {
+                // A burst must end before the first visible line, the rest goes in the next field
+                maxBuffLen = MIN(maxBuffLen, max7456CommitWindowBytes(currentTimeUs));
+            }
+        }
+#endif
+
+        const uint8_t *buffer = getLayerBuffer(DISPLAYPORT_LAYER_FOREGROUND);
+
+        unsigned buff_len = 0;
+        for (unsigned pos = 0; pos < maxScreenSize; pos++) {
+            if (!dirtyBits[pos / 32]) {
+                // skip the rest of a clean word
+                pos |= 31;
+                continue;
+            }
+            if (!IS_DIRTY(pos)) {
+                continue;
+            }
+            if (buffer[pos] == shadowBuffer[pos]) {
+                CLR_DIRTY(pos);
+                continue;
+            }
+
+            const unsigned space = maxBuffLen - buff_len;
+            unsigned length = 0;
+            if (space >= AUTO_INCREMENT_RUN_BYTES(MIN_AUTO_INCREMENT_RUN)) {
+                length = max7456ChangedRunLength(buffer, pos, (space - AUTO_INCREMENT_RUN_BYTES(0)) / 2);
+            }
+
+            if (length >= MIN_AUTO_INCREMENT_RUN) {
+                spiBuff[buff_len++] = MAX7456ADD_DMAH;
+                spiBuff[buff_len++] = pos >> 8;
+                spiBuff[buff_len++] = MAX7456ADD_DMAL;
+                spiBuff[buff_len++] = pos & 0xff;
+                spiBuff[buff_len++] = MAX7456ADD_DMM;
+                spiBuff[buff_len++] = displayMemoryModeReg | 1;
+                for (unsigned i = 0; i < length; i++, pos++) {
+                    spiBuff[buff_len++] = MAX7456ADD_DMDI;
+                    spiBuff[buff_len++] = buffer[pos];
+                    shadowBuffer[pos] = buffer[pos];
+                    CLR_DIRTY(pos);
+                }
+                pos--;
+                // the "escape" character 0xFF ends auto-increment mode
+                spiBuff[buff_len++] = MAX7456ADD_DMDI;
+                spiBuff[buff_len++] = END_STRING;
+                spiBuff[buff_len++] = MAX7456ADD_DMM;
+                spiBuff[buff_len++] = displayMemoryModeReg;
+            } else if (space >= ADDRESSED_WRITE_BYTES) {
+                // isolated character, or 0xFF which can't be written in auto-increment mode
                 spiBuff[buff_len++] = MAX7456ADD_DMAH;
                 spiBuff[buff_len++] = pos >> 8;
                 spiBuff[buff_len++] = MAX7456ADD_DMAL;
@@ -752,10 +986,9 @@ void max7456DrawScreen(void)
                 spiBuff[buff_len++] = MAX7456ADD_DMDI;
                 spiBuff[buff_len++] = buffer[pos];
                 shadowBuffer[pos] = buffer[pos];
-            }
-
-            if (++pos >= maxScreenSize) {
-                pos = 0;
+                CLR_DIRTY(pos);
+            } else {
+                // the rest is sent on the next call
                 break;
             }
         }
@@ -774,7 +1007,7 @@ void max7456DrawScreen(void)
 
 static void max7456DrawScreenSlow(void)
 {
-    bool escapeCharFound;
+    bool escapeCharFound = false;
     uint8_t *buffer = getActiveLayerBuffer();
 
     __spiBusTransactionBegin(busdev);
@@ -793,6 +1026,7 @@ static void max7456DrawScreenSlow(void)
             max7456Send(MAX7456ADD_DMDI, buffer[xx]);
         }
         shadowBuffer[xx] = buffer[xx];
+        CLR_DIRTY(xx);
     }
 
     max7456Send(MAX7456ADD_DMDI, END_STRING);
@@ -825,23 +1059,16 @@ void max7456RefreshAll(void)
     max7456DrawScreenSlow();
 }
 
-bool max7456WriteNvm(uint8_t char_address, const uint8_t *font_data)
+// Loads a character into the shadow RAM and starts programming it into the NVM, within a bus transaction
+static void max7456StartNvmWrite(uint8_t char_address, const uint8_t *font_data)
 {
-    if (!max7456DeviceDetected) {
-        return false;
-    }
-#ifdef MAX7456_DMA_CHANNEL_TX
-    while (dmaTransactionInProgress);
-#endif
-
-    __spiBusTransactionBegin(busdev);
     // disable display
     fontIsLoading = true;
     max7456Send(MAX7456ADD_VM0, 0);
 
     max7456Send(MAX7456ADD_CMAH, char_address); // set start address high
 
-    for (int x = 0; x < 54; x++) {
+    for (int x = 0; x < NVM_RAM_SIZE; x++) {
         max7456Send(MAX7456ADD_CMAL, x); //set start address low
         max7456Send(MAX7456ADD_CMDI, font_data[x]);
 #ifdef LED0_TOGGLE
@@ -854,6 +1081,20 @@ bool max7456WriteNvm(uint8_t char_address, const uint8_t *font_data)
     // Transfer 54 bytes from shadow ram to NVM
 
     max7456Send(MAX7456ADD_CMM, WRITE_NVR);
+}
+
+bool max7456WriteNvm(uint8_t char_address, const uint8_t *font_data)
+{
+    if (!max7456DeviceDetected) {
+        return false;
+    }
+#ifdef MAX7456_DMA_CHANNEL_TX
+    while (dmaTransactionInProgress);
+#endif
+
+    __spiBusTransactionBegin(busdev);
+
+    max7456StartNvmWrite(char_address, font_data);
 
     // Wait until bit 5 in the status register returns to 0 (12ms)
 
@@ -863,6 +1104,65 @@ bool max7456WriteNvm(uint8_t char_address, const uint8_t *font_data)
     return true;
 }
 
+#ifdef USE_OSD_FONT_QUEUE
+bool max7456QueueNvmWrite(uint8_t char_address, const uint8_t *font_data)
+{
+    if (!max7456DeviceDetected || fontQueueCount == FONT_QUEUE_SIZE) {
+        return false;
+    }
+
+    max7456FontChar_t *fontChar = &fontQueue[(fontQueueTail + fontQueueCount) % FONT_QUEUE_SIZE];
+    fontChar->address = char_address;
+    memcpy(fontChar->data, font_data, NVM_RAM_SIZE);
+    fontQueueCount++;
+
+    return true;
+}
+
+// Takes one step of programming the queued characters, either starting the next character or
+// checking whether the NVM has finished the current one. Returns true while characters remain.
+bool max7456UpdateNvmWrite(void)
+{
+    if (fontQueueCount == 0) {
+        return false;
+    }
+#ifdef MAX7456_DMA_CHANNEL_TX
+    if (dmaTransactionInProgress) {
+        return true;
+    }
+#endif
+
+    __spiBusTransactionBegin(busdev);
+
+    if (!fontNvmBusy) {
+        max7456StartNvmWrite(fontQueue[fontQueueTail].address, fontQueue[fontQueueTail].data);
+        fontNvmBusy = true;
+    } else if ((max7456Send(MAX7456ADD_STAT, 0x00) & STAT_NVR_BUSY) == 0x00) {
+        // Programming takes about 12ms, the slot is only released once it's done
+        fontNvmBusy = false;
+        fontQueueTail = (fontQueueTail + 1) % FONT_QUEUE_SIZE;
+        fontQueueCount--;
+        fontCharsWritten++;
+    }
+
+    __spiBusTransactionEnd(busdev);
+
+    return fontQueueCount > 0;
+}
+
+bool max7456NvmWritePending(void)
+{
+    return fontQueueCount > 0;
+}
+
+void max7456GetNvmWriteStatus(max7456NvmWriteStatus_t *status)
+{
+    status->queued = fontQueueCount;
+    status->free = FONT_QUEUE_SIZE - fontQueueCount;
+    status->written = fontCharsWritten;
+}
+#endif
+
 #ifdef MAX7456_NRST_PIN
 static IO_t max7456ResetPin        = IO_NONE;
 #endif
@@ -28,6 +28,15 @@
 #define VIDEO_LINES_NTSC          13
 #define VIDEO_LINES_PAL           16
 
+// Bytes of character memory for each font character
+#define MAX7456_NVM_CHAR_SIZE     54
+
+typedef struct max7456NvmWriteStatus_s {
+    uint8_t queued;     // characters waiting or being programmed
+    uint8_t free;       // characters that can still be queued
+    uint16_t written;   // characters programmed since boot
+} max7456NvmWriteStatus_t;
+
 extern uint16_t maxScreenSize;
 struct vcdProfile_s;
 void    max7456HardwareReset(void);
@@ -38,6 +47,10 @@ void    max7456Invert(bool invert);
 void    max7456Brightness(uint8_t black, uint8_t white);
 void    max7456DrawScreen(void);
 bool    max7456WriteNvm(uint8_t char_address, const uint8_t *font_data);
+bool    max7456QueueNvmWrite(uint8_t char_address, const uint8_t *font_data);
+bool    max7456UpdateNvmWrite(void);
+bool    max7456NvmWritePending(void);
+void    max7456GetNvmWriteStatus(max7456NvmWriteStatus_t *status);
 uint8_t max7456GetRowsCount(void);
 void    max7456Write(uint8_t x, uint8_t y, const char *buff);
 void    max7456WriteChar(uint8_t x, uint8_t y, uint8_t c);
@@ -49,3 +62,4 @@ bool    max7456LayerSupported(displayPortLayer_e layer);
 bool    max7456LayerSelect(displayPortLayer_e layer);
 bool    max7456LayerCopy(displayPortLayer_e destLayer, displayPortLayer_e sourceLayer);
 bool    max7456IsDeviceDetected(void);
+timeDelta_t max7456CommitDelayUs(timeUs_t currentTimeUs);
@@ -108,4 +108,5 @@ const char * const ownerNames[OWNER_TOTAL_COUNT] = {
     "PULLUP",
     "PULLDOWN",
     "DSHOT_BITBANG",
+    "OSD_VSYNC",
 };
@@ -20,9 +20,12 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
+#include "common/maths.h"
+
 #include "serial.h"
 
 void serialPrint(serialPort_t *instance, const char *str)
@@ -48,6 +51,12 @@ void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
 {
     if (instance->vTable->writeBuf) {
         instance->vTable->writeBuf(instance, data, count);
+    } else if (instance->vTable->writeBufContiguous) {
+        while (count > 0) {
+            const uint32_t written = instance->vTable->writeBufContiguous(instance, data, count);
+            data += written;
+            count -= written;
+        }
     } else {
         for (const uint8_t *p = data; count > 0; count--, p++) {
 
@@ -123,3 +132,80 @@ void serialEndWrite(serialPort_t *instance)
     if (instance->vTable->endWrite)
         instance->vTable->endWrite(instance);
 }
+
+bool serialSetRxFrameCallback(serialPort_t *instance, serialRxFrameCallbackPtr callback)
+{
+    // Ports that can't tell where frames end keep calling the byte callback
+    if (instance->vTable->setRxFrameCallback) {
+        return instance->vTable->setRxFrameCallback(instance, callback);
+    }
+    return false;
+}
+
+uint32_t serialReadBuf(serialPort_t *instance, uint8_t *data, uint32_t count)
+{
+    uint32_t total = 0;
+
+    // Up to the end of the receive buffer, then from its start
+    for (int segment = 0; segment < 2 && total < count; segment++) {
+        const uint8_t *received;
+        const uint32_t length = MIN(instance->vTable->peekContiguous(instance, &received), count - total);
+        if (length == 0) {
+            break;
+        }
+        memcpy(data + total, received, length);
+        instance->vTable->skip(instance, length);
+        total += length;
+    }
+
+    return total;
+}
+
+uint32_t serialPeekContiguous(serialPort_t *instance, const uint8_t **data)
+{
+    return instance->vTable->peekContiguous(instance, data);
+}
+
+void serialSkip(serialPort_t *instance, uint32_t count)
+{
+    instance->vTable->skip(instance, count);
+}
+
+uint32_t serialWriteBufContiguous(serialPort_t *instance, const uint8_t *data, uint32_t count)
+{
+    if (instance->vTable->writeBufContiguous) {
+        return instance->vTable->writeBufContiguous(instance, data, count);
+    }
+
+    uint32_t total = 0;
+    while (total < count && serialTxBytesFree(instance)) {
+        serialWrite(instance, data[total++]);
+    }
+    return total;
+}
+
+uint32_t serialBufferPeekContiguous(serialPort_t *instance, const uint8_t **data)
+{
+    const uint32_t head = instance->rxBufferHead;
+    const uint32_t tail = instance->rxBufferTail;
+
+    *data = (const uint8_t *)&instance->rxBuffer[tail];
+    return (head >= tail ? head : instance->rxBufferSize) - tail;
+}
+
+void serialBufferSkip(serialPort_t *instance, uint32_t count)
+{
+    const uint32_t tail = instance->rxBufferTail + count;
+    instance->rxBufferTail = tail >= instance->rxBufferSize ? tail - instance->rxBufferSize : tail;
+}
+
+// The caller has checked there is room for count bytes
+void serialBufferWrite(serialPort_t *instance, const uint8_t *data, uint32_t count)
+{
+    const uint32_t head = instance->txBufferHead;
+    const uint32_t first = MIN(count, instance->txBufferSize - head);
+
+    memcpy((uint8_t *)&instance->txBuffer[head], data, first);
+    memcpy((uint8_t *)instance->txBuffer, data + first, count - first);
+    instance->txBufferHead = head + count >= instance->txBufferSize ? head + count - instance->txBufferSize : head + count;
+}
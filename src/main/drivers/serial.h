@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 #include "drivers/io.h"
 #include "drivers/io_types.h"
 #include "drivers/resource.h"
@@ -61,6 +63,15 @@ typedef enum {
 typedef void (*serialReceiveCallbackPtr)(uint16_t data, void *rxCallbackData);   // used by serial drivers to return frames to app
 typedef void (*serialIdleCallbackPtr)();
 
+// Everything received up to an idle line, handed over in place. It is split in two where it wraps round the receive buffer.
+typedef struct serialRxFrame_s {
+    const volatile uint8_t *data[2];
+    uint16_t length[2];
+    timeUs_t timeUs;        // when the last byte was received
+} serialRxFrame_t;
+
+typedef void (*serialRxFrameCallbackPtr)(const serialRxFrame_t *frame, void *rxCallbackData);
+
 typedef struct serialPort_s {
 
     const struct serialPortVTable *vTable;
@@ -84,6 +95,8 @@ typedef struct serialPort_s {
 
     serialIdleCallbackPtr idleCallback;
 
+    serialRxFrameCallbackPtr rxFrameCallback;
+
     uint8_t identifier;
 } serialPort_t;
 
@@ -126,6 +139,16 @@ struct serialPortVTable {
     // Optional functions used to buffer large writes.
     void (*beginWrite)(serialPort_t *instance);
     void (*endWrite)(serialPort_t *instance);
+
+    // Optional, delivers received data a frame at a time instead of a byte at a time.
+    bool (*setRxFrameCallback)(serialPort_t *instance, serialRxFrameCallbackPtr callback);
+
+    // Required, bulk access to the receive buffer. peekContiguous returns how many received bytes follow *data
+    // before the buffer wraps, skip consumes them. MSP, GPS, the CLI and serial passthrough only read this way.
+    uint32_t (*peekContiguous)(serialPort_t *instance, const uint8_t **data);
+    void (*skip)(serialPort_t *instance, uint32_t count);
+    // Optional, copies as much of data as fits in the transmit buffer without waiting and returns how much that was.
+    uint32_t (*writeBufContiguous)(serialPort_t *instance, const uint8_t *data, uint32_t count);
 };
 
 void serialWrite(serialPort_t *instance, uint8_t ch);
@@ -145,3 +168,13 @@ uint32_t serialGetBaudRate(serialPort_t *instance);
 void serialWriteBufShim(void *instance, const uint8_t *data, int count);
 void serialBeginWrite(serialPort_t *instance);
 void serialEndWrite(serialPort_t *instance);
+bool serialSetRxFrameCallback(serialPort_t *instance, serialRxFrameCallbackPtr callback);
+uint32_t serialReadBuf(serialPort_t *instance, uint8_t *data, uint32_t count);
+uint32_t serialPeekContiguous(serialPort_t *instance, const uint8_t **data);
+void serialSkip(serialPort_t *instance, uint32_t count);
+uint32_t serialWriteBufContiguous(serialPort_t *instance, const uint8_t *data, uint32_t count);
+
+// Bulk operations on the serialPort_t ring buffers, for drivers which keep their data in them
+uint32_t serialBufferPeekContiguous(serialPort_t *instance, const uint8_t **data);
+void serialBufferSkip(serialPort_t *instance, uint32_t count);
+void serialBufferWrite(serialPort_t *instance, const uint8_t *data, uint32_t count);
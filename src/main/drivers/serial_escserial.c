@@ -866,7 +866,11 @@ const struct serialPortVTable escSerialVTable[] = {
         .setBaudRateCb = NULL,
         .writeBuf = NULL,
         .beginWrite = NULL,
-        .endWrite = NULL
+        .endWrite = NULL,
+        .setRxFrameCallback = NULL,
+        .peekContiguous = serialBufferPeekContiguous,
+        .skip = serialBufferSkip,
+        .writeBufContiguous = NULL,
     }
 };
 
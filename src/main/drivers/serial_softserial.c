@@ -35,6 +35,7 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/nvic.h"
@@ -611,6 +612,16 @@ void softSerialWriteByte(serialPort_t *s, uint8_t ch)
     s->txBufferHead = (s->txBufferHead + 1) % s->txBufferSize;
 }
 
+static uint32_t softSerialWriteBufContiguous(serialPort_t *s, const uint8_t *data, uint32_t count)
+{
+    count = MIN(count, softSerialTxBytesFree(s));
+    if (count > 0) {
+        serialBufferWrite(s, data, count);
+    }
+
+    return count;
+}
+
 void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate)
 {
     softSerial_t *softSerial = (softSerial_t *)s;
@@ -642,7 +653,11 @@ static const struct serialPortVTable softSerialVTable = {
     .setBaudRateCb = NULL,
     .writeBuf = NULL,
     .beginWrite = NULL,
-    .endWrite = NULL
+    .endWrite = NULL,
+    .setRxFrameCallback = NULL,
+    .peekContiguous = serialBufferPeekContiguous,
+    .skip = serialBufferSkip,
+    .writeBufContiguous = softSerialWriteBufContiguous,
 };
 
 #endif
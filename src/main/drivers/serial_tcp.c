@@ -27,12 +27,14 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #include "platform.h"
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "io/serial.h"
@@ -204,6 +206,24 @@ uint8_t tcpRead(serialPort_t *instance)
     return ch;
 }
 
+static uint32_t tcpPeekContiguous(serialPort_t *instance, const uint8_t **data)
+{
+    tcpPort_t *s = (tcpPort_t *)instance;
+    pthread_mutex_lock(&s->rxLock);
+    const uint32_t count = serialBufferPeekContiguous(instance, data);
+    pthread_mutex_unlock(&s->rxLock);
+
+    return count;
+}
+
+static void tcpSkip(serialPort_t *instance, uint32_t count)
+{
+    tcpPort_t *s = (tcpPort_t *)instance;
+    pthread_mutex_lock(&s->rxLock);
+    serialBufferSkip(instance, count);
+    pthread_mutex_unlock(&s->rxLock);
+}
+
 void tcpWrite(serialPort_t *instance, uint8_t ch)
 {
     tcpPort_t *s = (tcpPort_t *)instance;
@@ -220,6 +240,20 @@ void tcpWrite(serialPort_t *instance, uint8_t ch)
     tcpDataOut(s);
 }
 
+static uint32_t tcpWriteBufContiguous(serialPort_t *instance, const uint8_t *data, uint32_t count)
+{
+    tcpPort_t *s = (tcpPort_t *)instance;
+    count = MIN(count, tcpTotalTxBytesFree(instance));
+
+    pthread_mutex_lock(&s->txLock);
+    serialBufferWrite(instance, data, count);
+    pthread_mutex_unlock(&s->txLock);
+
+    tcpDataOut(s);
+
+    return count;
+}
+
 void tcpDataOut(tcpPort_t *instance)
 {
     tcpPort_t *s = (tcpPort_t *)instance;
@@ -245,17 +279,18 @@ void tcpDataIn(tcpPort_t *instance, uint8_t* ch, int size)
     tcpPort_t *s = (tcpPort_t *)instance;
     pthread_mutex_lock(&s->rxLock);
 
-    while (size--) {
-//        printf("%c", *ch);
-        s->port.rxBuffer[s->port.rxBufferHead] = *(ch++);
-        if (s->port.rxBufferHead + 1 >= s->port.rxBufferSize) {
-            s->port.rxBufferHead = 0;
-        } else {
-            s->port.rxBufferHead++;
-        }
-    }
+    // What doesn't fit in the receive buffer is dropped
+    const uint32_t head = s->port.rxBufferHead;
+    const uint32_t tail = s->port.rxBufferTail;
+    const uint32_t bytesFree = (head >= tail ? s->port.rxBufferSize : 0) + tail - head - 1;
+    const uint32_t count = MIN((uint32_t)size, bytesFree);
+    const uint32_t first = MIN(count, s->port.rxBufferSize - head);
+
+    memcpy(&s->rxBuffer[head], ch, first);
+    memcpy(s->rxBuffer, ch + first, count - first);
+    s->port.rxBufferHead = (head + count) % s->port.rxBufferSize;
+
     pthread_mutex_unlock(&s->rxLock);
-//    printf("\n");
 }
 
 static const struct serialPortVTable tcpVTable = {
@@ -271,4 +306,8 @@ static const struct serialPortVTable tcpVTable = {
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL,
+        .setRxFrameCallback = NULL,
+        .peekContiguous = tcpPeekContiguous,
+        .skip = tcpSkip,
+        .writeBufContiguous = tcpWriteBufContiguous,
 };
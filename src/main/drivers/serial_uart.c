@@ -34,14 +34,17 @@
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/dma.h"
 #include "drivers/dma_reqmap.h"
+#include "drivers/nvic.h"
 #include "drivers/rcc.h"
 #include "drivers/serial.h"
 #include "drivers/serial_uart.h"
 #include "drivers/serial_uart_impl.h"
+#include "drivers/time.h"
 
 #include "pg/serial_uart.h"
 
@@ -107,7 +110,7 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback,
     // common serial initialisation code should move to serialPort::init()
     s->port.rxBufferHead = s->port.rxBufferTail = 0;
     s->port.txBufferHead = s->port.txBufferTail = 0;
-    // callback works for IRQ-based RX ONLY
+    // callback works for IRQ-based RX ONLY, DMA RX delivers through serialSetRxFrameCallback()
     s->port.rxCallback = rxCallback;
     s->port.rxCallbackData = rxCallbackData;
     s->port.mode = mode;
@@ -133,23 +136,30 @@ static void uartSetMode(serialPort_t *instance, portMode_e mode)
     uartReconfigure(uartPort);
 }
 
+#ifdef USE_DMA
+// rxDMAPos and the DMA counter are distances from the end of the receive buffer, they count down as data arrives
+static uint32_t uartRxDMACounter(const uartPort_t *s)
+{
+#ifdef USE_HAL_DRIVER
+    return __HAL_DMA_GET_COUNTER(s->Handle.hdmarx);
+#else
+    return xDMA_GetCurrDataCounter(s->rxDMAResource);
+#endif
+}
+#endif
+
 static uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
 {
     const uartPort_t *s = (const uartPort_t*)instance;
 
 #ifdef USE_DMA
     if (s->rxDMAResource) {
-        // XXX Could be consolidated
-#ifdef USE_HAL_DRIVER
-        uint32_t rxDMAHead = __HAL_DMA_GET_COUNTER(s->Handle.hdmarx);
-#else
-        uint32_t rxDMAHead = xDMA_GetCurrDataCounter(s->rxDMAResource);
-#endif
+        const uint32_t rxDMAHead = uartRxDMACounter(s);
 
-        if (rxDMAHead >= s->rxDMAPos) {
-            return rxDMAHead - s->rxDMAPos;
+        if (s->rxDMAPos >= rxDMAHead) {
+            return s->rxDMAPos - rxDMAHead;
         } else {
-            return s->port.rxBufferSize + rxDMAHead - s->rxDMAPos;
+            return s->port.rxBufferSize + s->rxDMAPos - rxDMAHead;
         }
     }
 #endif
@@ -239,18 +249,38 @@ static uint8_t uartRead(serialPort_t *instance)
     return ch;
 }
 
-static void uartWrite(serialPort_t *instance, uint8_t ch)
+static uint32_t uartPeekContiguous(serialPort_t *instance, const uint8_t **data)
 {
+#ifdef USE_DMA
     uartPort_t *s = (uartPort_t *)instance;
 
-    s->port.txBuffer[s->port.txBufferHead] = ch;
+    if (s->rxDMAResource) {
+        const uint32_t rxDMAHead = uartRxDMACounter(s);
 
-    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
-        s->port.txBufferHead = 0;
-    } else {
-        s->port.txBufferHead++;
+        *data = (const uint8_t *)&s->port.rxBuffer[s->port.rxBufferSize - s->rxDMAPos];
+        return s->rxDMAPos >= rxDMAHead ? s->rxDMAPos - rxDMAHead : s->rxDMAPos;
     }
+#endif
 
+    return serialBufferPeekContiguous(instance, data);
+}
+
+static void uartSkip(serialPort_t *instance, uint32_t count)
+{
+#ifdef USE_DMA
+    uartPort_t *s = (uartPort_t *)instance;
+
+    if (s->rxDMAResource) {
+        s->rxDMAPos = s->rxDMAPos > count ? s->rxDMAPos - count : s->rxDMAPos + s->port.rxBufferSize - count;
+        return;
+    }
+#endif
+
+    serialBufferSkip(instance, count);
+}
+
+static void uartStartTx(uartPort_t *s)
+{
 #ifdef USE_DMA
     if (s->txDMAResource) {
         uartTryStartTxDMA(s);
@@ -265,6 +295,101 @@ static void uartWrite(serialPort_t *instance, uint8_t ch)
     }
 }
 
+static void uartWrite(serialPort_t *instance, uint8_t ch)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    s->port.txBuffer[s->port.txBufferHead] = ch;
+
+    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
+        s->port.txBufferHead = 0;
+    } else {
+        s->port.txBufferHead++;
+    }
+
+    uartStartTx(s);
+}
+
+static uint32_t uartWriteBufContiguous(serialPort_t *instance, const uint8_t *data, uint32_t count)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    count = MIN(count, uartTotalTxBytesFree(instance));
+    if (count > 0) {
+        serialBufferWrite(instance, data, count);
+        uartStartTx(s);
+    }
+
+    return count;
+}
+
+#ifdef USE_SERIAL_RX_FRAMES
+// The circular receive DMA keeps running and the idle line interrupt hands over what arrived since the previous idle line
+static bool uartSetRxFrameCallback(serialPort_t *instance, serialRxFrameCallbackPtr callback)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    if (!s->rxDMAResource || !(s->port.mode & MODE_RX)) {
+        return false;
+    }
+
+    s->port.rxFrameCallback = callback;
+    uartReconfigure(s);
+
+    // With receive DMA the UART interrupt may not have been enabled
+    const uartHardware_t *hardware = container_of(s, uartDevice_t, port)->hardware;
+#if defined(STM32F7) || defined(STM32H7)
+    HAL_NVIC_SetPriority(hardware->rxIrq, NVIC_PRIORITY_BASE(hardware->rxPriority), NVIC_PRIORITY_SUB(hardware->rxPriority));
+    HAL_NVIC_EnableIRQ(hardware->rxIrq);
+#else
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_PRIORITY_SUB(hardware->rxPriority);
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+#endif
+
+    return true;
+}
+
+// Called from the UART interrupt when the receive line goes idle
+void uartRxDmaFrameReceived(uartPort_t *s)
+{
+    // The line is idle one character after the last stop bit
+    const uint32_t characterBits = 10 + ((s->port.options & SERIAL_PARITY_EVEN) ? 1 : 0) + ((s->port.options & SERIAL_STOPBITS_2) ? 1 : 0);
+    const timeUs_t frameTimeUs = microsISR() - characterBits * 1000000 / s->port.baudRate;
+
+    const uint32_t counter = uartRxDMACounter(s);
+
+    // rxDMAPos is where the previous frame ended
+    const uint32_t size = s->port.rxBufferSize;
+    const uint32_t head = (size - counter) % size;
+    const uint32_t start = size - s->rxDMAPos;
+
+    if (head == start) {
+        return;
+    }
+
+    serialRxFrame_t frame;
+    frame.timeUs = frameTimeUs;
+    frame.data[0] = &s->port.rxBuffer[start];
+    frame.data[1] = s->port.rxBuffer;
+    if (head > start) {
+        frame.length[0] = head - start;
+        frame.length[1] = 0;
+    } else {
+        frame.length[0] = size - start;
+        frame.length[1] = head;
+    }
+
+    s->rxDMAPos = size - head;
+
+    s->port.rxFrameCallback(&frame, s->port.rxCallbackData);
+}
+#endif
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -279,6 +404,14 @@ const struct serialPortVTable uartVTable[] = {
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL,
+#ifdef USE_SERIAL_RX_FRAMES
+        .setRxFrameCallback = uartSetRxFrameCallback,
+#else
+        .setRxFrameCallback = NULL,
+#endif
+        .peekContiguous = uartPeekContiguous,
+        .skip = uartSkip,
+        .writeBufContiguous = uartWriteBufContiguous,
     }
 };
 
@@ -134,6 +134,12 @@ void uartReconfigure(uartPort_t *uartPort)
             HAL_UART_Receive_DMA(&uartPort->Handle, (uint8_t*)uartPort->port.rxBuffer, uartPort->port.rxBufferSize);
 
             uartPort->rxDMAPos = __HAL_DMA_GET_COUNTER(&uartPort->rxDMAHandle);
+#ifdef USE_SERIAL_RX_FRAMES
+            if (uartPort->port.rxFrameCallback) {
+                /* Enable Idle Line detection */
+                SET_BIT(uartPort->USARTx->CR1, USART_CR1_IDLEIE);
+            }
+#endif
         } else
 #endif
         {
@@ -247,7 +253,11 @@ void uartIrqHandler(uartPort_t *s)
 {
     UART_HandleTypeDef *huart = &s->Handle;
     /* UART in mode Receiver ---------------------------------------------------*/
-    if ((__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
+    if (
+#ifdef USE_DMA
+        !s->rxDMAResource &&
+#endif
+        (__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
         uint8_t rbyte = (uint8_t)(huart->Instance->RDR & (uint8_t) 0xff);
 
         if (s->port.rxCallback) {
@@ -318,6 +328,11 @@ void uartIrqHandler(uartPort_t *s)
     }
 
     if (__HAL_UART_GET_IT(huart, UART_IT_IDLE)) {
+#ifdef USE_SERIAL_RX_FRAMES
+        if (s->port.rxFrameCallback) {
+            uartRxDmaFrameReceived(s);
+        }
+#endif
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
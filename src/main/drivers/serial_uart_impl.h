@@ -203,6 +203,8 @@ void uartConfigureDma(uartDevice_t *uartdev);
 
 void uartDmaIrqHandler(dmaChannelDescriptor_t* descriptor);
 
+void uartRxDmaFrameReceived(uartPort_t *s);
+
 #if defined(STM32F3) || defined(STM32F7) || defined(STM32H7)
 #define UART_REG_RXD(base) ((base)->RDR)
 #define UART_REG_TXD(base) ((base)->TDR)
@@ -150,6 +150,11 @@ void uartReconfigure(uartPort_t *uartPort)
             xDMA_Cmd(uartPort->rxDMAResource, ENABLE);
             USART_DMACmd(uartPort->USARTx, USART_DMAReq_Rx, ENABLE);
             uartPort->rxDMAPos = xDMA_GetCurrDataCounter(uartPort->rxDMAResource);
+#ifdef USE_SERIAL_RX_FRAMES
+            if (uartPort->port.rxFrameCallback) {
+                USART_ITConfig(uartPort->USARTx, USART_IT_IDLE, ENABLE);
+            }
+#endif
         } else {
             USART_ClearITPendingBit(uartPort->USARTx, USART_IT_RXNE);
             USART_ITConfig(uartPort->USARTx, USART_IT_RXNE, ENABLE);
@@ -334,6 +334,11 @@ void uartIrqHandler(uartPort_t *s)
     }
 
     if (USART_GetITStatus(s->USARTx, USART_IT_IDLE) == SET) {
+#ifdef USE_SERIAL_RX_FRAMES
+        if (s->port.rxFrameCallback) {
+            uartRxDmaFrameReceived(s);
+        }
+#endif
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
@@ -27,6 +27,7 @@
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/io.h"
@@ -122,6 +123,20 @@ static uint8_t usbVcpRead(serialPort_t *instance)
     }
 }
 
+static uint32_t usbVcpPeekContiguous(serialPort_t *instance, const uint8_t **data)
+{
+    UNUSED(instance);
+
+    return CDC_Receive_Peek(data);
+}
+
+static void usbVcpSkip(serialPort_t *instance, uint32_t count)
+{
+    UNUSED(instance);
+
+    CDC_Receive_Skip(count);
+}
+
 static void usbVcpWriteBuf(serialPort_t *instance, const void *data, int count)
 {
     UNUSED(instance);
@@ -180,6 +195,21 @@ static void usbVcpWrite(serialPort_t *instance, uint8_t c)
     }
 }
 
+static uint32_t usbVcpWriteBufContiguous(serialPort_t *instance, const uint8_t *data, uint32_t count)
+{
+    vcpPort_t *port = container_of(instance, vcpPort_t, port);
+
+    if (!(usbIsConnected() && usbIsConfigured())) {
+        // Dropped, as by usbVcpWriteBuf()
+        return count;
+    }
+
+    // Bytes buffered by usbVcpWrite() go first
+    usbVcpFlush(port);
+
+    return CDC_Send_DATA(data, MIN(count, CDC_Send_FreeBytes()));
+}
+
 static void usbVcpBeginWrite(serialPort_t *instance)
 {
     vcpPort_t *port = container_of(instance, vcpPort_t, port);
@@ -212,7 +242,11 @@ static const struct serialPortVTable usbVTable[] = {
         .setBaudRateCb = usbVcpSetBaudRateCb,
         .writeBuf = usbVcpWriteBuf,
         .beginWrite = usbVcpBeginWrite,
-        .endWrite = usbVcpEndWrite
+        .endWrite = usbVcpEndWrite,
+        .setRxFrameCallback = NULL,
+        .peekContiguous = usbVcpPeekContiguous,
+        .skip = usbVcpSkip,
+        .writeBufContiguous = usbVcpWriteBufContiguous,
     }
 };
 
@@ -56,6 +56,7 @@
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
 #include "fc/runtime_config.h"
+#include "fc/rx_latency.h"
 #include "fc/stats.h"
 
 #include "flight/failsafe.h"
@@ -1182,6 +1183,10 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
 
     writeMotors();
 
+#ifdef USE_RX_LATENCY
+    rxLatencyMotorsUpdated();
+#endif
+
 #ifdef USE_DSHOT_TELEMETRY_STATS
     if (debugMode == DEBUG_DSHOT_RPM_ERRORS && useDshotTelemetry) {
         const uint8_t motorCount = MIN(getMotorCount(), 4);
@@ -1196,7 +1201,13 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
 
 static FAST_CODE_NOINLINE void subTaskRcCommand(timeUs_t currentTimeUs)
 {
+#ifdef USE_RX_LATENCY
+    if (isRXDataNew) {
+        rxLatencyFrameUsed(rxFrameTimeUs(), currentTimeUs);
+    }
+#else
     UNUSED(currentTimeUs);
+#endif
 
     // If we're armed, at minimum throttle, and we do arming via the
     // sticks, do not process yaw input from the rx.  We do this so the
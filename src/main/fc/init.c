@@ -182,6 +182,8 @@ serialPort_t *loopbackPort;
 
 uint8_t systemState = SYSTEM_STATE_INITIALISING;
 
+bootTiming_t bootTiming;
+
 void processLoopback(void)
 {
 #ifdef SOFTSERIAL_LOOPBACK
@@ -382,9 +384,13 @@ void init(void)
 
     initEEPROM();
 
+    timeUs_t startUs = micros();
     ensureEEPROMStructureIsValid();
+    bootTiming.configCheckUs = micros() - startUs;
 
+    startUs = micros();
     bool readSuccess = readEEPROM();
+    bootTiming.configLoadUs = micros() - startUs;
 
 #if defined(USE_BOARD_INFO)
     initBoardInformation();
@@ -395,6 +401,7 @@ void init(void)
     }
 
     systemState |= SYSTEM_STATE_CONFIG_LOADED;
+    bootTiming.configLoadedAtUs = micros();
 
 #ifdef USE_BRUSHED_ESC_AUTODETECT
     // Now detect again with the actually configured pin for motor 1, if it is not the default pin.
@@ -535,6 +542,7 @@ void init(void)
      * receiver may share timer with motors so motors MUST be initialized here. */
     motorDevInit(&motorConfig()->dev, idlePulse, getMotorCount());
     systemState |= SYSTEM_STATE_MOTORS_READY;
+    bootTiming.motorsReadyAtUs = micros();
 #else
     UNUSED(idlePulse);
 #endif
@@ -673,6 +681,7 @@ void init(void)
     }
 
     systemState |= SYSTEM_STATE_SENSORS_READY;
+    bootTiming.sensorsReadyAtUs = micros();
 
     // gyro.targetLooptime set in sensorsAutodetect(),
     // so we are ready to call validateAndFixGyroConfig(), pidInit(), and setAccelerationFilter()
@@ -958,4 +967,5 @@ void init(void)
     tasksInit();
 
     systemState |= SYSTEM_STATE_READY;
+    bootTiming.readyAtUs = micros();
 }
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 typedef enum {
     SYSTEM_STATE_INITIALISING   = 0,
     SYSTEM_STATE_CONFIG_LOADED  = (1 << 0),
@@ -31,5 +33,17 @@ typedef enum {
 
 extern uint8_t systemState;
 
+// Where the time goes between power up and being ready to arm, reported by the CLI status command.
+typedef struct bootTiming_s {
+    timeUs_t configCheckUs;         // validating and indexing the stored config
+    timeUs_t configLoadUs;          // loading the PGs from the stored config
+    timeUs_t configLoadedAtUs;      // times since power up at which each system state was reached
+    timeUs_t motorsReadyAtUs;
+    timeUs_t sensorsReadyAtUs;
+    timeUs_t readyAtUs;
+} bootTiming_t;
+
+extern bootTiming_t bootTiming;
+
 void init(void);
 void processLoopback(void);
@@ -0,0 +1,103 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Time from the last byte of an RX frame arriving to the first motor output computed from it.
+ * Receivers timestamp their frames when they complete, see rcFrameTimeUsFn, the PID loop reports
+ * when the frame becomes the setpoint and when the motors have been written.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_RX_LATENCY
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+
+#include "drivers/time.h"
+
+#include "fc/rx_latency.h"
+
+#define RX_LATENCY_MAX_US           50000   // older frames are left over from before a failsafe, not latency
+#define RX_LATENCY_AVERAGE_SAMPLES  32
+
+static rxLatencyStats_t stats;
+static timeUs_t pendingFrameTimeUs;
+static bool framePending;
+
+void rxLatencyFrameUsed(timeUs_t frameTimeUs, timeUs_t currentTimeUs)
+{
+    if (!frameTimeUs) {
+        return;
+    }
+
+    pendingFrameTimeUs = frameTimeUs;
+    framePending = true;
+
+    DEBUG_SET(DEBUG_RX_LATENCY, 1, cmpTimeUs(currentTimeUs, frameTimeUs));
+}
+
+void rxLatencyMotorsUpdated(void)
+{
+    if (!framePending) {
+        return;
+    }
+    framePending = false;
+
+    const timeDelta_t latencyUs = cmpTimeUs(micros(), pendingFrameTimeUs);
+    if (latencyUs < 0 || latencyUs > RX_LATENCY_MAX_US) {
+        return;
+    }
+
+    if (stats.count == 0) {
+        stats.minUs = latencyUs;
+        stats.maxUs = latencyUs;
+        stats.averageUs = latencyUs;
+    } else {
+        stats.minUs = MIN(stats.minUs, latencyUs);
+        stats.maxUs = MAX(stats.maxUs, latencyUs);
+        stats.averageUs += (latencyUs - stats.averageUs) / RX_LATENCY_AVERAGE_SAMPLES;
+    }
+    stats.lastUs = latencyUs;
+    stats.count++;
+    stats.histogram[MIN(latencyUs / RX_LATENCY_BUCKET_US, RX_LATENCY_BUCKET_COUNT - 1)]++;
+
+    DEBUG_SET(DEBUG_RX_LATENCY, 0, latencyUs);
+    DEBUG_SET(DEBUG_RX_LATENCY, 2, lrintf(stats.averageUs));
+}
+
+const rxLatencyStats_t *rxLatencyGetStats(void)
+{
+    return &stats;
+}
+
+void rxLatencyReset(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    framePending = false;
+}
+
+#endif // USE_RX_LATENCY
@@ -0,0 +1,40 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/time.h"
+
+#define RX_LATENCY_BUCKET_US        500
+#define RX_LATENCY_BUCKET_COUNT     8   // the last bucket takes everything from 3.5ms up
+
+typedef struct rxLatencyStats_s {
+    uint32_t count;                     // frames that made it to the motors
+    timeDelta_t lastUs;
+    timeDelta_t minUs;
+    timeDelta_t maxUs;
+    float averageUs;                    // moving average over the last few dozen frames
+    uint32_t histogram[RX_LATENCY_BUCKET_COUNT];
+} rxLatencyStats_t;
+
+void rxLatencyFrameUsed(timeUs_t frameTimeUs, timeUs_t currentTimeUs);
+void rxLatencyMotorsUpdated(void);
+const rxLatencyStats_t *rxLatencyGetStats(void);
+void rxLatencyReset(void);
@@ -38,6 +38,7 @@
 #include "drivers/accgyro/accgyro.h"
 #include "drivers/camera_control.h"
 #include "drivers/compass/compass.h"
+#include "drivers/max7456.h"
 #include "drivers/sensor.h"
 #include "drivers/serial.h"
 #include "drivers/serial_usb_vcp.h"
@@ -61,6 +62,7 @@
 #include "io/asyncfatfs/asyncfatfs.h"
 #include "io/beeper.h"
 #include "io/dashboard.h"
+#include "io/flashfs.h"
 #include "io/gps.h"
 #include "io/ledstrip.h"
 #include "io/piniobox.h"
@@ -166,10 +168,15 @@ static void taskUpdateRxMain(timeUs_t currentTimeUs)
         return;
     }
 
-    currentRxRefreshRate = constrain(currentTimeUs - lastRxTimeUs, 1000, 30000);
-    lastRxTimeUs = currentTimeUs;
+    // Use the arrival time of the frame where the receiver timestamps it, the jitter of this task doesn't belong in the interval
+    const timeUs_t frameTimeUs = rxFrameTimeUs();
+    const timeUs_t rxTimeUs = frameTimeUs != lastRxTimeUs ? frameTimeUs : currentTimeUs;
+    currentRxRefreshRate = constrain(cmpTimeUs(rxTimeUs, lastRxTimeUs), 1000, 30000);
+    lastRxTimeUs = rxTimeUs;
     isRXDataNew = true;
 
+    DEBUG_SET(DEBUG_RX_LATENCY, 3, currentRxRefreshRate);
+
 #ifdef USE_USB_CDC_HID
     if (!ARMING_FLAG(ARMED)) {
         sendRcDataToHid();
@@ -224,6 +231,48 @@ static void taskCameraControl(uint32_t currentTime)
 }
 #endif
 
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+static void taskFlashfs(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    flashfsEraseUpdate();
+}
+#endif
+
+#ifdef USE_MSP_STREAM
+static void taskMspStream(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+#ifdef USE_CLI
+    if (cliMode) {
+        return;
+    }
+#endif
+    mspSerialStreamProcess(mspFcProcessStreamCommand);
+}
+#endif
+
+#ifdef USE_OSD_FONT_QUEUE
+#define TASK_OSD_FONT_PERIOD_US TASK_PERIOD_HZ(200)
+
+// Idle until characters are queued, then take one programming step per period
+static bool taskOsdFontCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    return max7456NvmWritePending() && currentDeltaTimeUs >= TASK_OSD_FONT_PERIOD_US;
+}
+
+static void taskOsdFont(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    max7456UpdateNvmWrite();
+}
+#endif
+
 void tasksInit(void)
 {
     schedulerInit();
@@ -332,6 +381,18 @@ void tasksInit(void)
     setTaskEnabled(TASK_PINIOBOX, true);
 #endif
 
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+    setTaskEnabled(TASK_FLASHFS, flashfsIsSupported());
+#endif
+
+#ifdef USE_MSP_STREAM
+    setTaskEnabled(TASK_MSP_STREAM, true);
+#endif
+
+#ifdef USE_OSD_FONT_QUEUE
+    setTaskEnabled(TASK_OSD_FONT, max7456IsDeviceDetected());
+#endif
+
 #ifdef USE_CMS
 #ifdef USE_MSP_DISPLAYPORT
     setTaskEnabled(TASK_CMS, true);
@@ -423,8 +484,12 @@ cfTask_t cfTasks[TASK_COUNT] = {
 #endif
 
 #ifdef USE_OSD
+#ifdef USE_OSD_FRAME_SYNC
+    [TASK_OSD] = DEFINE_TASK("OSD", NULL, osdUpdateCheck, osdUpdate, TASK_PERIOD_HZ(60), TASK_PRIORITY_LOW),
+#else
     [TASK_OSD] = DEFINE_TASK("OSD", NULL, NULL, osdUpdate, TASK_PERIOD_HZ(60), TASK_PRIORITY_LOW),
 #endif
+#endif
 
 #ifdef USE_TELEMETRY
     [TASK_TELEMETRY] = DEFINE_TASK("TELEMETRY", NULL, NULL, taskTelemetry, TASK_PERIOD_HZ(250), TASK_PRIORITY_LOW),
@@ -466,6 +531,18 @@ cfTask_t cfTasks[TASK_COUNT] = {
     [TASK_PINIOBOX] = DEFINE_TASK("PINIOBOX", NULL, NULL, pinioBoxUpdate, TASK_PERIOD_HZ(20), TASK_PRIORITY_IDLE),
 #endif
 
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+    [TASK_FLASHFS] = DEFINE_TASK("FLASHFS", "ERASE", NULL, taskFlashfs, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
+#endif
+
+#ifdef USE_MSP_STREAM
+    [TASK_MSP_STREAM] = DEFINE_TASK("MSP", "STREAM", NULL, taskMspStream, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
+#endif
+
+#ifdef USE_OSD_FONT_QUEUE
+    [TASK_OSD_FONT] = DEFINE_TASK("OSD", "FONT", taskOsdFontCheck, taskOsdFont, TASK_OSD_FONT_PERIOD_US, TASK_PRIORITY_LOW),
+#endif
+
 #ifdef USE_RANGEFINDER
     [TASK_RANGEFINDER] = DEFINE_TASK("RANGEFINDER", NULL, NULL, rangefinderUpdate, TASK_PERIOD_HZ(10), TASK_PRIORITY_IDLE),
 #endif
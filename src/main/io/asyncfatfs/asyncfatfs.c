@@ -48,6 +48,7 @@
 
 #include "fat_standard.h"
 #include "drivers/sdcard.h"
+#include "common/bitarray.h"
 #include "common/maths.h"
 #include "common/time.h"
 #include "common/utils.h"
@@ -58,7 +59,14 @@
     #define ONLY_EXPOSE_FOR_TESTING static
 #endif
 
+// Targets may define their own cache size, every sector of cache costs 512 bytes of RAM
+#ifndef AFATFS_NUM_CACHE_SECTORS
+#if defined(STM32F7) || defined(STM32H7)
+#define AFATFS_NUM_CACHE_SECTORS 16
+#else
 #define AFATFS_NUM_CACHE_SECTORS 10
+#endif
+#endif
 
 // FAT filesystems are allowed to differ from these parameters, but we choose not to support those weird filesystems:
 #define AFATFS_SECTOR_SIZE  512
@@ -75,6 +83,13 @@
  */
 #define AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT 4
 
+/*
+ * While a multi-block write is streaming, flushes of other sectors are held back until the application has finished
+ * filling the next sector of the stream. This is the most flushes we'll hold back for before breaking the stream
+ * anyway, so that a file which stops being written to can't hold up the rest of the cache forever.
+ */
+#define AFATFS_MULTIPLE_BLOCK_WRITE_MAX_HOLD 250
+
 #define AFATFS_FILES_PER_DIRECTORY_SECTOR (AFATFS_SECTOR_SIZE / sizeof(fatDirectoryEntry_t))
 
 #define AFATFS_FAT32_FAT_ENTRIES_PER_SECTOR  (AFATFS_SECTOR_SIZE / sizeof(uint32_t))
@@ -115,6 +130,21 @@
 
 #define AFATFS_INTROSPEC_LOG_FILENAME "ASYNCFAT.LOG"
 
+/*
+ * Remember which FAT sectors (i.e. superclusters) are known to be completely occupied or completely free, so searches
+ * through the FAT can skip over them without reading them from the card again.
+ */
+#define AFATFS_USE_FAT_SUMMARY
+
+// Number of FAT sectors covered by the summary, each one costs two bits of RAM. Sectors beyond this are always read.
+#ifndef AFATFS_FAT_SUMMARY_MAX_SECTORS
+#if defined(STM32F7) || defined(STM32H7)
+#define AFATFS_FAT_SUMMARY_MAX_SECTORS 8192
+#else
+#define AFATFS_FAT_SUMMARY_MAX_SECTORS 4096
+#endif
+#endif
+
 typedef enum {
     AFATFS_SAVE_DIRECTORY_NORMAL,
     AFATFS_SAVE_DIRECTORY_FOR_CLOSE,
@@ -468,8 +498,24 @@ typedef struct afatfs_t {
     int cacheDirtyEntries; // The number of cache entries in the AFATFS_CACHE_STATE_DIRTY state
     bool cacheFlushInProgress;
 
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+    // The sector the card expects next in the multi-block write it is streaming, and how many more the write will accept
+    uint32_t multiWriteNextSector;
+    uint32_t multiWriteSectorsRemain;
+    uint16_t multiWriteHoldCount;
+#endif
+
     afatfsFile_t openFiles[AFATFS_MAX_OPEN_FILES];
 
+#ifdef AFATFS_USE_FAT_SUMMARY
+    /*
+     * One bit per FAT sector, set when the last full read of that sector found every entry occupied (fatSectorFull)
+     * or every entry free (fatSectorEmpty). Both bits clear means we don't know, so the sector must be read.
+     */
+    uint32_t fatSectorFull[AFATFS_FAT_SUMMARY_MAX_SECTORS / 32];
+    uint32_t fatSectorEmpty[AFATFS_FAT_SUMMARY_MAX_SECTORS / 32];
+#endif
+
 #ifdef AFATFS_USE_FREEFILE
     afatfsFile_t freeFile;
 #endif
@@ -645,6 +691,28 @@ static void afatfs_cacheSectorInit(afatfsCacheBlockDescriptor_t *descriptor, uin
     descriptor->discardable = 0;
 }
 
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+/**
+ * Keep track of the multi-block write the card is streaming after the given sector was handed to it for writing.
+ */
+static void afatfs_multiWriteAdvance(const afatfsCacheBlockDescriptor_t *descriptor)
+{
+    if (descriptor->consecutiveEraseBlockCount) {
+        // Either starts a new multi-block write or continues the current one
+        afatfs.multiWriteNextSector = descriptor->sectorIndex + 1;
+        afatfs.multiWriteSectorsRemain = descriptor->consecutiveEraseBlockCount - 1;
+    } else if (afatfs.multiWriteSectorsRemain > 0 && descriptor->sectorIndex == afatfs.multiWriteNextSector) {
+        afatfs.multiWriteNextSector++;
+        afatfs.multiWriteSectorsRemain--;
+    } else {
+        // A single block write, any multi-block write has been ended by the card
+        afatfs.multiWriteSectorsRemain = 0;
+    }
+
+    afatfs.multiWriteHoldCount = 0;
+}
+#endif
+
 /**
  * Called by the SD card driver when one of our read operations completes.
  */
@@ -692,6 +760,10 @@ static void afatfs_sdcardWriteComplete(sdcardBlockOperation_e operation, uint32_
                 // Write failed, remark the sector as dirty
                 afatfs.cacheDescriptor[i].state = AFATFS_CACHE_STATE_DIRTY;
                 afatfs.cacheDirtyEntries++;
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+                // The card has been reset
+                afatfs.multiWriteSectorsRemain = 0;
+#endif
             } else {
                 afatfs_assert(afatfs_cacheSectorGetMemory(i) == buffer);
 
@@ -721,12 +793,18 @@ static void afatfs_cacheFlushSector(int cacheIndex)
             afatfs.cacheDirtyEntries--;
             cacheDescriptor->state = AFATFS_CACHE_STATE_WRITING;
             afatfs.cacheFlushInProgress = true;
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+            afatfs_multiWriteAdvance(cacheDescriptor);
+#endif
             break;
 
         case SDCARD_OPERATION_SUCCESS:
             // Buffer is already transmitted
             afatfs.cacheDirtyEntries--;
             cacheDescriptor->state = AFATFS_CACHE_STATE_IN_SYNC;
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+            afatfs_multiWriteAdvance(cacheDescriptor);
+#endif
             break;
 
         case SDCARD_OPERATION_BUSY:
@@ -839,6 +917,29 @@ static int afatfs_allocateCacheSector(uint32_t sectorIndex)
 bool afatfs_flush(void)
 {
     if (afatfs.cacheDirtyEntries > 0) {
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+        /*
+         * If the card is streaming a multi-block write (a contiguous file being appended to), keep it fed. Flushing
+         * any other sector would end the multi-block write and make the card start over with a new one.
+         */
+        bool holdForMultiWrite = false;
+
+        if (afatfs.multiWriteSectorsRemain > 0) {
+            afatfsCacheBlockDescriptor_t *nextDescriptor = afatfs_findCacheSector(afatfs.multiWriteNextSector);
+
+            if (nextDescriptor && nextDescriptor->state == AFATFS_CACHE_STATE_DIRTY) {
+                if (!nextDescriptor->locked) {
+                    afatfs_cacheFlushSector(nextDescriptor - afatfs.cacheDescriptor);
+
+                    return false;
+                }
+
+                // The next sector is still being filled by the application
+                holdForMultiWrite = afatfs.multiWriteHoldCount < AFATFS_MULTIPLE_BLOCK_WRITE_MAX_HOLD;
+            }
+        }
+#endif
+
         // Flush the oldest flushable sector
         uint32_t earliestSectorTime = 0xFFFFFFFF;
         int earliestSectorIndex = -1;
@@ -853,6 +954,14 @@ bool afatfs_flush(void)
         }
 
         if (earliestSectorIndex > -1) {
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+            if (holdForMultiWrite) {
+                afatfs.multiWriteHoldCount++;
+
+                return false;
+            }
+#endif
+
             afatfs_cacheFlushSector(earliestSectorIndex);
 
             // That flush will take time to complete so we may as well tell caller to come back later
@@ -946,6 +1055,10 @@ static afatfsOperationStatus_e afatfs_cacheSector(uint32_t physicalSectorIndex,
             if ((sectorFlags & AFATFS_CACHE_READ) != 0) {
                 if (sdcard_readBlock(physicalSectorIndex, afatfs_cacheSectorGetMemory(cacheSectorIndex), afatfs_sdcardReadComplete, 0)) {
                     afatfs.cacheDescriptor[cacheSectorIndex].state = AFATFS_CACHE_STATE_READING;
+#ifdef AFATFS_MIN_MULTIPLE_BLOCK_WRITE_COUNT
+                    // Reads end the multi-block write
+                    afatfs.multiWriteSectorsRemain = 0;
+#endif
                 }
                 return AFATFS_OPERATION_IN_PROGRESS;
             }
@@ -1103,6 +1216,74 @@ static bool afatfs_FATIsEndOfChainMarker(uint32_t clusterNumber)
     }
 }
 
+#ifdef AFATFS_USE_FAT_SUMMARY
+
+/**
+ * Record whether the FAT sector with the given index, which we have just read in its entirety, is completely occupied
+ * or completely free.
+ */
+static void afatfs_fatSummaryUpdate(uint32_t fatSectorIndex, const afatfsFATSector_t sector)
+{
+    if (fatSectorIndex >= AFATFS_FAT_SUMMARY_MAX_SECTORS) {
+        return;
+    }
+
+    uint32_t fatEntriesPerSector = afatfs_fatEntriesPerSector();
+    uint32_t freeEntries = 0;
+
+    for (uint32_t i = 0; i < fatEntriesPerSector; i++) {
+        uint32_t clusterNumber;
+
+        if (afatfs.filesystemType == FAT_FILESYSTEM_TYPE_FAT16) {
+            clusterNumber = sector.fat16[i];
+        } else {
+            clusterNumber = fat32_decodeClusterNumber(sector.fat32[i]);
+        }
+
+        if (fat_isFreeSpace(clusterNumber)) {
+            freeEntries++;
+        }
+    }
+
+    if (freeEntries == 0) {
+        bitArraySet(afatfs.fatSectorFull, fatSectorIndex);
+    } else if (freeEntries == fatEntriesPerSector) {
+        bitArraySet(afatfs.fatSectorEmpty, fatSectorIndex);
+    }
+}
+
+/**
+ * Call when the FAT sector with the given index is about to be modified, so we stop trusting what we knew about it.
+ */
+static void afatfs_fatSummaryForget(uint32_t fatSectorIndex)
+{
+    if (fatSectorIndex < AFATFS_FAT_SUMMARY_MAX_SECTORS) {
+        bitArrayClr(afatfs.fatSectorFull, fatSectorIndex);
+        bitArrayClr(afatfs.fatSectorEmpty, fatSectorIndex);
+    }
+}
+
+/**
+ * Count the FAT sectors starting at fatSectorIndex which are flagged in the given summary bitmap.
+ */
+static uint32_t afatfs_fatSummaryCountFlagged(const uint32_t *summary, uint32_t fatSectorIndex)
+{
+    uint32_t index = fatSectorIndex;
+
+    while (index < AFATFS_FAT_SUMMARY_MAX_SECTORS && bitArrayGet(summary, index)) {
+        // Step over 32 sectors at a time when we're word-aligned
+        if (index % 32 == 0 && summary[index / 32] == 0xFFFFFFFF) {
+            index += 32;
+        } else {
+            index++;
+        }
+    }
+
+    return index - fatSectorIndex;
+}
+
+#endif
+
 /**
  * Look up the FAT to find out which cluster follows the one with the given number and store it into *nextCluster.
  *
@@ -1161,6 +1342,10 @@ static afatfsOperationStatus_e afatfs_FATSetNextCluster(uint32_t startCluster, u
     result = afatfs_cacheSector(fatPhysicalSector, &sector.bytes, AFATFS_CACHE_READ | AFATFS_CACHE_WRITE, 0);
 
     if (result == AFATFS_OPERATION_SUCCESS) {
+#ifdef AFATFS_USE_FAT_SUMMARY
+        afatfs_fatSummaryForget(fatSectorIndex);
+#endif
+
         if (afatfs.filesystemType == FAT_FILESYSTEM_TYPE_FAT16) {
             sector.fat16[fatSectorEntryIndex] = nextCluster;
         } else {
@@ -1251,14 +1436,41 @@ static afatfsFindClusterStatus_e afatfs_findClusterWithCondition(afatfsClusterSe
 
             // Maintain alignment
             *cluster = roundUpTo(*cluster, jump);
+            afatfs_getFATPositionForCluster(*cluster, &fatSectorIndex, &fatSectorEntryIndex);
             continue; // Go back to check that the new cluster number is within the volume
         }
 #endif
 
+#ifdef AFATFS_USE_FAT_SUMMARY
+        // A sector where every entry matches the condition has a match right here, no need to read it
+        if (fatSectorIndex < AFATFS_FAT_SUMMARY_MAX_SECTORS && bitArrayGet(lookingForFree ? afatfs.fatSectorEmpty : afatfs.fatSectorFull, fatSectorIndex)) {
+            if (*cluster < searchLimit) {
+                return AFATFS_FIND_CLUSTER_FOUND;
+            } else {
+                *cluster = searchLimit;
+                return AFATFS_FIND_CLUSTER_NOT_FOUND;
+            }
+        }
+
+        // And sectors where no entry matches can be skipped entirely
+        uint32_t skipSectors = afatfs_fatSummaryCountFlagged(lookingForFree ? afatfs.fatSectorFull : afatfs.fatSectorEmpty, fatSectorIndex);
+
+        if (skipSectors > 0) {
+            *cluster += skipSectors * fatEntriesPerSector - fatSectorEntryIndex;
+            fatSectorIndex += skipSectors;
+            fatSectorEntryIndex = 0;
+            continue;
+        }
+#endif
+
         afatfsOperationStatus_e status = afatfs_cacheSector(afatfs_fatSectorToPhysical(0, fatSectorIndex), &sector.bytes, AFATFS_CACHE_READ | AFATFS_CACHE_DISCARDABLE, 0);
 
         switch (status) {
             case AFATFS_OPERATION_SUCCESS:
+#ifdef AFATFS_USE_FAT_SUMMARY
+                afatfs_fatSummaryUpdate(fatSectorIndex, sector);
+#endif
+
                 do {
                     uint32_t clusterNumber;
 
@@ -1388,6 +1600,10 @@ static afatfsOperationStatus_e afatfs_FATFillWithPattern(afatfsFATPattern_e patt
             return result;
         }
 
+#ifdef AFATFS_USE_FAT_SUMMARY
+        afatfs_fatSummaryForget(fatSectorIndex);
+#endif
+
 #ifdef AFATFS_DEBUG_VERBOSE
         if (pattern == AFATFS_FAT_PATTERN_FREE) {
             fprintf(stderr, "Marking cluster %u to %u as free in FAT sector %u...\n", *startCluster, endCluster, fatPhysicalSector);
@@ -1432,6 +1648,7 @@ static afatfsOperationStatus_e afatfs_FATFillWithPattern(afatfsFATPattern_e patt
             break;
         }
 
+        fatSectorIndex++;
         fatPhysicalSector++;
         eraseSectorCount--;
         firstEntryIndex = 0;
@@ -2486,6 +2703,7 @@ static afatfsOperationStatus_e afatfs_ftruncateContinue(afatfsFilePtr_t file, bo
 
                 // Searches for unallocated regular clusters should be told about this free cluster now
                 afatfs.lastClusterAllocated = MIN(afatfs.lastClusterAllocated, opState->currentCluster - 1);
+                afatfs.filesystemFull = false;
             }
 
             opState->phase = AFATFS_TRUNCATE_FILE_SUCCESS;
@@ -152,6 +152,14 @@ static bool layerCopy(displayPort_t *displayPort, displayPortLayer_e destLayer,
     return max7456LayerCopy(destLayer, sourceLayer);
 }
 
+#ifdef USE_OSD_FRAME_SYNC
+static timeDelta_t commitDelay(const displayPort_t *displayPort, timeUs_t currentTimeUs)
+{
+    UNUSED(displayPort);
+    return max7456CommitDelayUs(currentTimeUs);
+}
+#endif
+
 static const displayPortVTable_t max7456VTable = {
     .grab = grab,
     .release = release,
@@ -168,6 +176,9 @@ static const displayPortVTable_t max7456VTable = {
     .layerSupported = layerSupported,
     .layerSelect = layerSelect,
     .layerCopy = layerCopy,
+#ifdef USE_OSD_FRAME_SYNC
+    .commitDelay = commitDelay,
+#endif
 };
 
 displayPort_t *max7456DisplayPortInit(const vcdProfile_t *vcdProfile)
@@ -27,6 +27,7 @@
 
 #ifdef USE_MSP_DISPLAYPORT
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/display.h"
@@ -57,9 +58,152 @@ static int output(displayPort_t *displayPort, uint8_t cmd, uint8_t *buf, int len
     return mspSerialPush(displayPortProfileMsp()->displayPortSerial, cmd, buf, len, MSP_DIRECTION_REPLY);
 }
 
+#ifdef USE_MSP_DISPLAYPORT_BATCH
+/*
+ * Batched writes keep the screen locally and only send the cells that differ from what the
+ * receiver is showing. Changed cells are packed as positioned runs into as few MSP_DP_WRITE_BATCH
+ * frames as the TX buffer has room for:
+ *
+ *   subcmd, flags, { row, col, attribute, length, characters[length] } ...
+ *
+ * The frame that completes the update carries MSP_DP_BATCH_FLAG_COMMIT, which tells the receiver to
+ * show the screen, so a partial update is never displayed.
+ */
+
+#define MSP_DP_MAX_ROWS             13
+#define MSP_DP_MAX_COLS             30
+#define MSP_DP_SCREEN_SIZE          (MSP_DP_MAX_ROWS * MSP_DP_MAX_COLS)
+
+#define MSP_DP_BATCH_MAX_PAYLOAD    240 // keeps a frame within the MSP v1 size byte and the MSP TX pipeline
+#define MSP_DP_FRAME_OVERHEAD       6   // '$', 'M', '>', size, command and checksum
+#define MSP_DP_BATCH_HEADER_SIZE    2   // subcmd and flags
+#define MSP_DP_RUN_HEADER_SIZE      4   // row, col, attribute and length
+
+static bool batchWrites;
+static bool commitPending;
+static uint8_t screenBuffer[MSP_DP_SCREEN_SIZE];
+static uint8_t remoteBuffer[MSP_DP_SCREEN_SIZE];    // what the receiver is showing
+
+// Set when a cell of screenBuffer is written with a new character, cleared once it matches remoteBuffer
+static uint32_t dirtyBits[(MSP_DP_SCREEN_SIZE + 31) / 32];
+#define SET_DIRTY(pos) (dirtyBits[(pos) / 32] |= (1U << ((pos) % 32)))
+#define CLR_DIRTY(pos) (dirtyBits[(pos) / 32] &= ~(1U << ((pos) % 32)))
+#define IS_DIRTY(pos) (dirtyBits[(pos) / 32] & (1U << ((pos) % 32)))
+
+static void setChar(int pos, uint8_t c)
+{
+    if (screenBuffer[pos] != c) {
+        screenBuffer[pos] = c;
+        SET_DIRTY(pos);
+    }
+}
+
+static bool cellChanged(int pos)
+{
+    return IS_DIRTY(pos) && screenBuffer[pos] != remoteBuffer[pos];
+}
+
+// Returns the first cell from pos on that differs from the receiver, or MSP_DP_SCREEN_SIZE
+static int nextChangedCell(int pos)
+{
+    while (pos < MSP_DP_SCREEN_SIZE) {
+        if (!dirtyBits[pos / 32]) {
+            pos = (pos / 32 + 1) * 32;
+            continue;
+        }
+        if (IS_DIRTY(pos)) {
+            if (screenBuffer[pos] != remoteBuffer[pos]) {
+                return pos;
+            }
+            // changed back before it was sent
+            CLR_DIRTY(pos);
+        }
+        pos++;
+    }
+    return MSP_DP_SCREEN_SIZE;
+}
+
+static void invalidateRemoteScreen(displayPort_t *displayPort)
+{
+    uint8_t subcmd[] = { MSP_DP_CLEAR_SCREEN };
+    output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+
+    memset(remoteBuffer, ' ', sizeof(remoteBuffer));
+    memset(dirtyBits, 0xff, sizeof(dirtyBits));
+    commitPending = true;
+}
+
+static int flushBatch(displayPort_t *displayPort)
+{
+    uint8_t buf[MSP_DP_BATCH_MAX_PAYLOAD];
+    int pos = 0;
+    int sent = 0;
+
+    while (true) {
+        const uint32_t bytesFree = mspSerialTxBytesFree();
+        if (bytesFree < MSP_DP_FRAME_OVERHEAD + MSP_DP_BATCH_HEADER_SIZE + MSP_DP_RUN_HEADER_SIZE + MSP_DP_MAX_COLS) {
+            break;
+        }
+        const int maxLen = MIN(bytesFree - MSP_DP_FRAME_OVERHEAD, (uint32_t)MSP_DP_BATCH_MAX_PAYLOAD);
+        const int frameStart = pos;
+        int len = MSP_DP_BATCH_HEADER_SIZE;
+
+        while ((pos = nextChangedCell(pos)) < MSP_DP_SCREEN_SIZE) {
+            // extend the run through the row, taking in unchanged gaps shorter than a run header
+            const int rowEnd = (pos / MSP_DP_MAX_COLS + 1) * MSP_DP_MAX_COLS;
+            int runEnd = pos + 1;
+            for (int scan = runEnd; scan < rowEnd && scan - runEnd < MSP_DP_RUN_HEADER_SIZE; scan++) {
+                if (cellChanged(scan)) {
+                    runEnd = scan + 1;
+                }
+            }
+
+            const int runLength = runEnd - pos;
+            if (len + MSP_DP_RUN_HEADER_SIZE + runLength > maxLen) {
+                break;
+            }
+            buf[len++] = pos / MSP_DP_MAX_COLS;
+            buf[len++] = pos % MSP_DP_MAX_COLS;
+            buf[len++] = 0; // attribute
+            buf[len++] = runLength;
+            memcpy(&buf[len], &screenBuffer[pos], runLength);
+            len += runLength;
+            pos = runEnd;
+        }
+
+        const bool complete = (pos == MSP_DP_SCREEN_SIZE);
+        if (len == MSP_DP_BATCH_HEADER_SIZE && !(complete && commitPending)) {
+            break;
+        }
+
+        buf[0] = MSP_DP_WRITE_BATCH;
+        buf[1] = complete ? MSP_DP_BATCH_FLAG_COMMIT : 0;
+        const int frameBytes = output(displayPort, MSP_DISPLAYPORT, buf, len);
+        if (frameBytes == 0) {
+            // no room after all, the cells stay dirty for the next attempt
+            break;
+        }
+        sent += frameBytes;
+
+        // every cell up to pos that differed was in a run, the others already matched
+        memcpy(&remoteBuffer[frameStart], &screenBuffer[frameStart], pos - frameStart);
+        for (int i = frameStart; i < pos; i++) {
+            CLR_DIRTY(i);
+        }
+        commitPending = !complete;
+
+        if (complete) {
+            break;
+        }
+    }
+
+    return sent;
+}
+#endif // USE_MSP_DISPLAYPORT_BATCH
+
 static int heartbeat(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 0 };
+    uint8_t subcmd[] = { MSP_DP_HEARTBEAT };
 
     // heartbeat is used to:
     // a) ensure display is not released by MW OSD software
@@ -69,26 +213,45 @@ static int heartbeat(displayPort_t *displayPort)
 
 static int grab(displayPort_t *displayPort)
 {
+#ifdef USE_MSP_DISPLAYPORT_BATCH
+    if (batchWrites) {
+        // the receiver may have shown something else meanwhile
+        invalidateRemoteScreen(displayPort);
+    }
+#endif
     return heartbeat(displayPort);
 }
 
 static int release(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 1 };
+    uint8_t subcmd[] = { MSP_DP_RELEASE };
 
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
 static int clearScreen(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 2 };
+#ifdef USE_MSP_DISPLAYPORT_BATCH
+    if (batchWrites) {
+        for (int pos = 0; pos < MSP_DP_SCREEN_SIZE; pos++) {
+            setChar(pos, ' ');
+        }
+        return 0;
+    }
+#endif
+    uint8_t subcmd[] = { MSP_DP_CLEAR_SCREEN };
 
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
 static int drawScreen(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 4 };
+#ifdef USE_MSP_DISPLAYPORT_BATCH
+    if (batchWrites) {
+        return flushBatch(displayPort);
+    }
+#endif
+    uint8_t subcmd[] = { MSP_DP_DRAW_SCREEN };
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
@@ -102,12 +265,23 @@ static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, con
 #define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
     uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
 
+#ifdef USE_MSP_DISPLAYPORT_BATCH
+    if (batchWrites) {
+        if (row < displayPort->rows) {
+            for (int pos = row * MSP_DP_MAX_COLS + col; *string && col < displayPort->cols; string++, col++, pos++) {
+                setChar(pos, *string);
+            }
+        }
+        return 0;
+    }
+#endif
+
     int len = strlen(string);
     if (len >= MSP_OSD_MAX_STRING_LENGTH) {
         len = MSP_OSD_MAX_STRING_LENGTH;
     }
 
-    buf[0] = 3;
+    buf[0] = MSP_DP_WRITE_STRING;
     buf[1] = row;
     buf[2] = col;
     buf[3] = 0;
@@ -118,6 +292,14 @@ static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, con
 
 static int writeChar(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t c)
 {
+#ifdef USE_MSP_DISPLAYPORT_BATCH
+    if (batchWrites) {
+        if (row < displayPort->rows && col < displayPort->cols) {
+            setChar(row * MSP_DP_MAX_COLS + col, c);
+        }
+        return 0;
+    }
+#endif
     char buf[2];
 
     buf[0] = c;
@@ -134,6 +316,11 @@ static bool isTransferInProgress(const displayPort_t *displayPort)
 static bool isSynced(const displayPort_t *displayPort)
 {
     UNUSED(displayPort);
+#ifdef USE_MSP_DISPLAYPORT_BATCH
+    if (batchWrites) {
+        return !commitPending && nextChangedCell(0) == MSP_DP_SCREEN_SIZE;
+    }
+#endif
     return true;
 }
 
@@ -141,6 +328,11 @@ static void resync(displayPort_t *displayPort)
 {
     displayPort->rows = 13 + displayPortProfileMsp()->rowAdjust; // XXX Will reflect NTSC/PAL in the future
     displayPort->cols = 30 + displayPortProfileMsp()->colAdjust;
+#ifdef USE_MSP_DISPLAYPORT_BATCH
+    if (batchWrites) {
+        invalidateRemoteScreen(displayPort);
+    }
+#endif
     drawScreen(displayPort);
 }
 
@@ -170,6 +362,9 @@ static const displayPortVTable_t mspDisplayPortVTable = {
 
 displayPort_t *displayPortMspInit(void)
 {
+#ifdef USE_MSP_DISPLAYPORT_BATCH
+    batchWrites = displayPortProfileMsp()->batchWrites;
+#endif
     displayInit(&mspDisplayPort, &mspDisplayPortVTable);
     resync(&mspDisplayPort);
     return &mspDisplayPort;
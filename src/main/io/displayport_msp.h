@@ -22,4 +22,16 @@
 
 #include "pg/displayport_profiles.h"
 
+// MSP_DISPLAYPORT subcommands
+typedef enum {
+    MSP_DP_HEARTBEAT = 0,       // keep the display from being released
+    MSP_DP_RELEASE = 1,         // give the display back to the receiver
+    MSP_DP_CLEAR_SCREEN = 2,    // clear the display
+    MSP_DP_WRITE_STRING = 3,    // write a string at given coordinates
+    MSP_DP_DRAW_SCREEN = 4,     // trigger a screen draw
+    MSP_DP_WRITE_BATCH = 8,     // positioned runs of characters, see displayport_msp.c
+} displayportMspCommand_e;
+
+#define MSP_DP_BATCH_FLAG_COMMIT    0x01    // the last frame of an update, draw the screen
+
 struct displayPort_s *displayPortMspInit(void);
@@ -34,11 +34,16 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "platform.h"
 
+#include "common/bitarray.h"
+#include "common/crc.h"
+#include "common/maths.h"
 #include "common/printf.h"
+#include "common/utils.h"
 #include "drivers/flash.h"
 
 #include "io/flashfs.h"
@@ -76,11 +81,523 @@ static void flashfsSetTailAddress(uint32_t address)
     tailAddress = address;
 }
 
+#ifdef USE_FLASHFS_LOG_INDEX
+/*
+ * The log index is an append-only table in the FLASHFS_INDEX partition with one record for every log which was
+ * closed. Records are never rewritten, only added to the end of the table, so an index slot is either blank (all
+ * bits set to 1) or holds a record which is validated by its CRC. On NAND devices a page can't be programmed twice
+ * so every record gets a page of its own.
+ *
+ * If the power goes while a log is being written no record is added for it, flashfsIdentifyStartOfFreeSpace()
+ * then falls back to searching for the free space behind the last indexed log.
+ *
+ * The background erase adds marker records to the index when it starts and finishes, see below.
+ */
+
+#define FLASHFS_LOG_INDEX_MAGIC 0xA5
+#define FLASHFS_LOG_INDEX_MAGIC_ERASE_STARTED 0x5A
+#define FLASHFS_LOG_INDEX_MAGIC_ERASE_FINISHED 0x3C
+
+typedef struct flashfsLogIndexRecord_s {
+    uint8_t magic;
+    uint8_t crc; // CRC8 DVB-S2 of the fields following it
+    uint16_t logNumber;
+    uint32_t startAddress;
+    uint32_t length;
+    uint32_t timestamp;
+} flashfsLogIndexRecord_t;
+
+STATIC_ASSERT(sizeof(flashfsLogIndexRecord_t) == 16, flashfsLogIndexRecord_t_size_mismatch);
+
+static const flashPartition_t *logIndexPartition = NULL;
+static uint32_t logIndexAddress = 0;
+static uint32_t logIndexSlotSize = 0;
+static uint16_t logIndexSlotCount = 0;
+static uint16_t logIndexSlotsUsed = 0;
+
+static uint16_t logNextNumber = 1;
+static bool logIsOpen = false;
+static flashfsLogEntry_t logOpenEntry;
+
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+// The newest erase marker in the index is an unfinished erase
+static bool logIndexErasePending = false;
+#endif
+
+static uint8_t flashfsLogIndexRecordCrc(const flashfsLogIndexRecord_t *record)
+{
+    return crc8_dvb_s2_update(0, &record->logNumber, sizeof(*record) - offsetof(flashfsLogIndexRecord_t, logNumber));
+}
+
+static bool flashfsLogIndexReadSlot(int slot, flashfsLogIndexRecord_t *record)
+{
+    return flashReadBytes(logIndexAddress + slot * logIndexSlotSize, (uint8_t *)record, sizeof(*record)) == sizeof(*record);
+}
+
+static bool flashfsLogIndexReadRecord(int slot, flashfsLogIndexRecord_t *record)
+{
+    return flashfsLogIndexReadSlot(slot, record) && record->crc == flashfsLogIndexRecordCrc(record);
+}
+
+static void flashfsLogIndexWriteRecord(flashfsLogIndexRecord_t *record)
+{
+    record->crc = flashfsLogIndexRecordCrc(record);
+
+    flashPageProgram(logIndexAddress + logIndexSlotsUsed * logIndexSlotSize, (const uint8_t *)record, sizeof(*record));
+    flashFlush();
+
+    logIndexSlotsUsed++;
+}
+
+static bool flashfsLogIndexSlotIsBlank(int slot)
+{
+    union {
+        flashfsLogIndexRecord_t record;
+        uint32_t ints[sizeof(flashfsLogIndexRecord_t) / sizeof(uint32_t)];
+    } slotContents;
+
+    if (!flashfsLogIndexReadSlot(slot, &slotContents.record)) {
+        // Report the slot as used rather than risk programming over a record
+        return false;
+    }
+
+    for (unsigned i = 0; i < ARRAYLEN(slotContents.ints); i++) {
+        if (slotContents.ints[i] != 0xFFFFFFFF) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void flashfsLogIndexReset(void)
+{
+    logIndexSlotsUsed = 0;
+    logNextNumber = 1;
+    logIsOpen = false;
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+    logIndexErasePending = false;
+#endif
+}
+
+static void flashfsLogIndexInit(void)
+{
+    logIndexPartition = flashPartitionFindByType(FLASH_PARTITION_TYPE_FLASHFS_INDEX);
+    logIndexSlotCount = 0;
+
+    flashfsLogIndexReset();
+
+    if (!logIndexPartition) {
+        return;
+    }
+
+    logIndexSlotSize = (flashGeometry->flashType == FLASH_TYPE_NAND) ? flashGeometry->pageSize : sizeof(flashfsLogIndexRecord_t);
+    logIndexAddress = logIndexPartition->startSector * flashGeometry->sectorSize;
+    logIndexSlotCount = MIN(FLASH_PARTITION_SECTOR_COUNT(logIndexPartition) * flashGeometry->sectorSize / logIndexSlotSize, (uint32_t)UINT16_MAX);
+
+    // Used slots are contiguous from the start of the index, so binary search for the first blank one
+    int left = 0;
+    int right = logIndexSlotCount;
+
+    while (left < right) {
+        const int mid = (left + right) / 2;
+
+        if (flashfsLogIndexSlotIsBlank(mid)) {
+            right = mid;
+        } else {
+            left = mid + 1;
+        }
+    }
+
+    logIndexSlotsUsed = left;
+
+    bool foundLog = false;
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+    bool foundEraseMarker = false;
+#else
+    const bool foundEraseMarker = true;
+#endif
+
+    for (int slot = logIndexSlotsUsed - 1; slot >= 0 && !(foundLog && foundEraseMarker); slot--) {
+        flashfsLogIndexRecord_t record;
+        if (!flashfsLogIndexReadRecord(slot, &record)) {
+            continue;
+        }
+
+        if (record.magic == FLASHFS_LOG_INDEX_MAGIC && !foundLog) {
+            logNextNumber = record.logNumber + 1;
+            foundLog = true;
+        }
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+        if ((record.magic == FLASHFS_LOG_INDEX_MAGIC_ERASE_STARTED || record.magic == FLASHFS_LOG_INDEX_MAGIC_ERASE_FINISHED) && !foundEraseMarker) {
+            logIndexErasePending = (record.magic == FLASHFS_LOG_INDEX_MAGIC_ERASE_STARTED);
+            foundEraseMarker = true;
+        }
+#endif
+    }
+}
+
+/**
+ * Return the address following the newest indexed log, or 0 if there are no logs in the index.
+ */
+static uint32_t flashfsLogIndexGetEndOfLogs(void)
+{
+    for (int slot = logIndexSlotsUsed - 1; slot >= 0; slot--) {
+        flashfsLogEntry_t entry;
+        if (flashfsLogGetEntry(slot, &entry)) {
+            uint32_t endAddress = entry.startAddress + entry.length;
+
+            if (flashGeometry->flashType == FLASH_TYPE_NAND) {
+                // flashfsClose() moves the tail to the next page boundary on NAND
+                const uint32_t pageSize = flashGeometry->pageSize;
+                endAddress = (endAddress + pageSize - 1) & ~(pageSize - 1);
+            }
+
+            return endAddress;
+        }
+    }
+
+    return 0;
+}
+
+static void flashfsLogIndexAppend(uint32_t endAddress)
+{
+    if (!logIsOpen) {
+        return;
+    }
+
+    logIsOpen = false;
+
+    if (endAddress <= logOpenEntry.startAddress || logIndexSlotsUsed >= logIndexSlotCount) {
+        // Nothing was logged, or the index is full
+        return;
+    }
+
+    flashfsLogIndexRecord_t record = {
+        .magic = FLASHFS_LOG_INDEX_MAGIC,
+        .logNumber = logOpenEntry.logNumber,
+        .startAddress = logOpenEntry.startAddress,
+        .length = endAddress - logOpenEntry.startAddress,
+        .timestamp = logOpenEntry.timestamp,
+    };
+    flashfsLogIndexWriteRecord(&record);
+
+    logNextNumber = record.logNumber + 1;
+}
+
+/**
+ * Mark the current file pointer as the start of a new log. The log is added to the index when flashfsClose() is called.
+ */
+void flashfsLogBegin(uint32_t timestamp)
+{
+    logOpenEntry.logNumber = logNextNumber;
+    logOpenEntry.startAddress = flashfsGetOffset();
+    logOpenEntry.length = 0;
+    logOpenEntry.timestamp = timestamp;
+
+    logIsOpen = true;
+}
+
+/**
+ * Returns the number of the log being written, or of the last log written if there is no open log, or -1 if there
+ * are no logs.
+ */
+int32_t flashfsLogGetCurrentNumber(void)
+{
+    if (logIsOpen) {
+        return logOpenEntry.logNumber;
+    }
+
+    return logNextNumber > 1 ? logNextNumber - 1 : -1;
+}
+
+/**
+ * Returns the number of used index slots. Slots which hold a damaged record or an erase marker are included in the
+ * count.
+ */
+int flashfsLogGetCount(void)
+{
+    return logIndexSlotsUsed;
+}
+
+/**
+ * Read the index slot with the given index (0 is the oldest). Returns false if the slot is unused, damaged or
+ * doesn't hold a log.
+ */
+bool flashfsLogGetEntry(int index, flashfsLogEntry_t *entry)
+{
+    flashfsLogIndexRecord_t record;
+
+    if (index < 0 || index >= logIndexSlotsUsed || !flashfsLogIndexReadRecord(index, &record)) {
+        return false;
+    }
+
+    if (record.magic != FLASHFS_LOG_INDEX_MAGIC) {
+        return false;
+    }
+
+    entry->logNumber = record.logNumber;
+    entry->startAddress = record.startAddress;
+    entry->length = record.length;
+    entry->timestamp = record.timestamp;
+
+    return true;
+}
+
+bool flashfsLogFindByNumber(uint16_t logNumber, flashfsLogEntry_t *entry)
+{
+    // Newest logs are the ones most likely to be asked for
+    for (int slot = logIndexSlotsUsed - 1; slot >= 0; slot--) {
+        if (flashfsLogGetEntry(slot, entry) && entry->logNumber == logNumber) {
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif // USE_FLASHFS_LOG_INDEX
+
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+/*
+ * Erasing the whole device takes from seconds (NOR) to minutes (large NAND) during which the flash can't be used, so
+ * flashfsEraseCompletely() only marks the sectors as dirty and flashfsEraseUpdate() erases them one by one from a
+ * low priority task. The index is erased first and an "erase started" marker is added to it, then the data sectors
+ * are erased in order starting at the write head, and finally an "erase finished" marker is added.
+ *
+ * A log can be started straight away, when the write head reaches a dirty sector it is erased on demand. While a log
+ * is being written the background erase only keeps FLASHFS_ERASE_AHEAD_SECTORS erased ahead of the write head to
+ * leave the flash bandwidth to the log.
+ *
+ * If the power goes before the erase is finished the index still holds the "erase started" marker as its newest
+ * marker, and flashfsInit() resumes the erase behind the newest indexed log.
+ */
+
+#define FLASHFS_ERASE_MAX_SECTORS 2048
+#define FLASHFS_ERASE_AHEAD_SECTORS 2
+
+typedef enum {
+    FLASHFS_ERASE_IDLE = 0,
+    FLASHFS_ERASE_INDEX,    // Erasing the index sectors
+    FLASHFS_ERASE_DATA,     // Erasing the data sectors, the index records the erase as started
+    FLASHFS_ERASE_FINISH,   // The index has to record the erase as finished
+} flashfsEraseState_e;
+
+static flashfsEraseState_e eraseState = FLASHFS_ERASE_IDLE;
+static uint32_t eraseDirtySectors[FLASHFS_ERASE_MAX_SECTORS / 32];
+static uint32_t eraseLastTailAddress = 0;
+
+static bool flashfsEraseIsSupported(void)
+{
+    return logIndexPartition && flashGeometry->sectors <= FLASHFS_ERASE_MAX_SECTORS;
+}
+
+static void flashfsEraseMarkDirty(flashSector_t startSector, flashSector_t endSector)
+{
+    for (flashSector_t sector = startSector; sector <= endSector; sector++) {
+        bitArraySet(eraseDirtySectors, sector);
+    }
+}
+
+static void flashfsEraseSector(flashSector_t sector)
+{
+    flashEraseSector(sector * flashGeometry->sectorSize);
+    bitArrayClr(eraseDirtySectors, sector);
+}
+
+/**
+ * Returns the first dirty sector of the FLASHFS partition at or after the given sector, or -1 if there is none.
+ */
+static int flashfsEraseFindDirtySector(flashSector_t firstSector)
+{
+    for (unsigned sector = firstSector; sector <= flashPartition->endSector; sector++) {
+        if ((sector % 32) == 0 && eraseDirtySectors[sector / 32] == 0) {
+            // Skip 32 clean sectors at a time
+            sector += 31;
+        } else if (bitArrayGet(eraseDirtySectors, sector)) {
+            return sector;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Returns true if an index record can be programmed now.
+ *
+ * A NAND chip holds the part of the page at the write head that was sent so far in its page buffer. Programming a
+ * record elsewhere would program that partial page, and the log would then program the same page a second time.
+ */
+static bool flashfsLogIndexCanWriteMarker(void)
+{
+    return flashGeometry->flashType != FLASH_TYPE_NAND || !logIsOpen || (tailAddress % flashGeometry->pageSize) == 0;
+}
+
+static void flashfsLogIndexWriteMarker(uint8_t magic)
+{
+    if (logIndexSlotsUsed >= logIndexSlotCount) {
+        return;
+    }
+
+    flashfsLogIndexRecord_t record = {
+        .magic = magic,
+    };
+    flashfsLogIndexWriteRecord(&record);
+}
+
+/**
+ * Take the next step of the erase. Sectors starting at or after limitAddress are left dirty for now.
+ *
+ * The flash must be ready.
+ */
+static void flashfsEraseStep(uint32_t limitAddress)
+{
+    switch (eraseState) {
+    case FLASHFS_ERASE_IDLE:
+        break;
+
+    case FLASHFS_ERASE_INDEX:
+        for (flashSector_t sector = logIndexPartition->startSector; sector <= logIndexPartition->endSector; sector++) {
+            if (bitArrayGet(eraseDirtySectors, sector)) {
+                flashfsEraseSector(sector);
+
+                return;
+            }
+        }
+
+        if (!flashfsLogIndexCanWriteMarker()) {
+            return;
+        }
+
+        flashfsLogIndexWriteMarker(FLASHFS_LOG_INDEX_MAGIC_ERASE_STARTED);
+        eraseState = FLASHFS_ERASE_DATA;
+
+        break;
+
+    case FLASHFS_ERASE_DATA: {
+        int sector = flashfsEraseFindDirtySector(tailAddress / flashGeometry->sectorSize);
+        if (sector < 0) {
+            // Catch any dirty sectors behind the write head
+            sector = flashfsEraseFindDirtySector(flashPartition->startSector);
+        }
+
+        if (sector < 0) {
+            eraseState = FLASHFS_ERASE_FINISH;
+        } else if (sector * flashGeometry->sectorSize < limitAddress) {
+            flashfsEraseSector(sector);
+        }
+
+        break;
+    }
+
+    case FLASHFS_ERASE_FINISH:
+        // Stays in this state until the log reaches a page boundary or is closed
+        if (!flashfsLogIndexCanWriteMarker()) {
+            break;
+        }
+
+        flashfsLogIndexWriteMarker(FLASHFS_LOG_INDEX_MAGIC_ERASE_FINISHED);
+        eraseState = FLASHFS_ERASE_IDLE;
+
+        break;
+    }
+}
+
+/**
+ * Make sure the sector holding the given address is erased before it is programmed.
+ *
+ * In synchronous mode, erases the sector (and anything the erase has to do before it) straight away.
+ *
+ * In asynchronous mode, starts the next step of the erase and returns false if the sector is still dirty.
+ */
+static bool flashfsEraseBeforeWrite(uint32_t address, bool sync)
+{
+    const flashSector_t sector = address / flashGeometry->sectorSize;
+
+    while (eraseState != FLASHFS_ERASE_IDLE && bitArrayGet(eraseDirtySectors, sector)) {
+        if (!sync) {
+            if (flashIsReady()) {
+                flashfsEraseStep(flashfsSize);
+            }
+
+            return false;
+        }
+
+        flashWaitForReady();
+        flashfsEraseStep(flashfsSize);
+    }
+
+    return true;
+}
+
+/**
+ * Resume an erase which was interrupted by a power loss, starting at the first sector behind the newest indexed log.
+ */
+static void flashfsEraseInit(void)
+{
+    eraseState = FLASHFS_ERASE_IDLE;
+    memset(eraseDirtySectors, 0, sizeof(eraseDirtySectors));
+
+    if (!flashfsEraseIsSupported() || !logIndexErasePending) {
+        return;
+    }
+
+    const uint32_t sectorSize = flashGeometry->sectorSize;
+    const flashSector_t firstDirtySector = (flashfsLogIndexGetEndOfLogs() + sectorSize - 1) / sectorSize;
+
+    if (firstDirtySector <= flashPartition->endSector) {
+        flashfsEraseMarkDirty(firstDirtySector, flashPartition->endSector);
+    }
+
+    eraseState = FLASHFS_ERASE_DATA;
+}
+
+/**
+ * Returns true while a background erase is in progress.
+ */
+bool flashfsIsErasing(void)
+{
+    return eraseState != FLASHFS_ERASE_IDLE;
+}
+
+/**
+ * Called periodically to progress a background erase.
+ */
+void flashfsEraseUpdate(void)
+{
+    if (eraseState == FLASHFS_ERASE_IDLE || !flashIsReady()) {
+        return;
+    }
+
+    const bool logging = (tailAddress != eraseLastTailAddress) || !flashfsBufferIsEmpty();
+    eraseLastTailAddress = tailAddress;
+
+    flashfsEraseStep(logging ? tailAddress + FLASHFS_ERASE_AHEAD_SECTORS * flashGeometry->sectorSize : flashfsSize);
+}
+#endif // USE_FLASHFS_BACKGROUND_ERASE
+
 void flashfsEraseCompletely(void)
 {
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+    if (flashGeometry->sectors > 0 && flashfsEraseIsSupported()) {
+        flashfsEraseMarkDirty(flashPartition->startSector, flashPartition->endSector);
+        flashfsEraseMarkDirty(logIndexPartition->startSector, logIndexPartition->endSector);
+
+        eraseState = FLASHFS_ERASE_INDEX;
+        eraseLastTailAddress = 0;
+    } else
+#endif
     if (flashGeometry->sectors > 0 && flashPartitionCount() > 0) {
-        // if there's a single FLASHFS partition and it uses the entire flash then do a full erase
-        const bool doFullErase = (flashPartitionCount() == 1) && (FLASH_PARTITION_SECTOR_COUNT(flashPartition) == flashGeometry->sectors);
+        int flashfsPartitionCount = 1;
+        uint32_t flashfsSectorCount = FLASH_PARTITION_SECTOR_COUNT(flashPartition);
+#ifdef USE_FLASHFS_LOG_INDEX
+        if (logIndexPartition) {
+            flashfsPartitionCount++;
+            flashfsSectorCount += FLASH_PARTITION_SECTOR_COUNT(logIndexPartition);
+        }
+#endif
+
+        // if the FLASHFS partition (and its index) are the only partitions and use the entire flash then do a full erase
+        const bool doFullErase = (flashPartitionCount() == flashfsPartitionCount) && (flashfsSectorCount == flashGeometry->sectors);
         if (doFullErase) {
             flashEraseCompletely();
         } else {
@@ -95,9 +612,21 @@ void flashfsEraseCompletely(void)
                 uint32_t sectorAddress = sectorIndex * flashGeometry->sectorSize;
                 flashEraseSector(sectorAddress);
             }
+
+#ifdef USE_FLASHFS_LOG_INDEX
+            if (logIndexPartition) {
+                for (flashSector_t sectorIndex = logIndexPartition->startSector; sectorIndex <= logIndexPartition->endSector; sectorIndex++) {
+                    flashEraseSector(sectorIndex * flashGeometry->sectorSize);
+                }
+            }
+#endif
         }
     }
 
+#ifdef USE_FLASHFS_LOG_INDEX
+    flashfsLogIndexReset();
+#endif
+
     flashfsClearBuffer();
 
     flashfsSetTailAddress(0);
@@ -232,6 +761,12 @@ static uint32_t flashfsWriteBuffers(uint8_t const **buffers, uint32_t *bufferSiz
             break;
         }
 
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+        if (!flashfsEraseBeforeWrite(tailAddress, sync)) {
+            break;
+        }
+#endif
+
         flashPageProgramBegin(tailAddress);
 
         bytesRemainThisIteration = bytesTotalThisIteration;
@@ -513,6 +1048,9 @@ int flashfsReadAbs(uint32_t address, uint8_t *buffer, unsigned int len)
 
 /**
  * Find the offset of the start of the free space on the device (or the size of the device if it is full).
+ *
+ * With the log index the free space normally starts right behind the newest indexed log, which only needs
+ * a single read to confirm.
  */
 int flashfsIdentifyStartOfFreeSpace(void)
 {
@@ -550,6 +1088,43 @@ int flashfsIdentifyStartOfFreeSpace(void)
     int i;
     bool blockErased;
 
+#ifdef USE_FLASHFS_LOG_INDEX
+    const uint32_t endOfLogs = flashfsLogIndexGetEndOfLogs();
+    if (endOfLogs >= flashfsSize) {
+        return flashfsSize;
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+    } else if (endOfLogs == 0 && logIndexErasePending) {
+        // Nothing was logged since the interrupted erase started
+        return 0;
+#endif
+    } else if (endOfLogs > 0) {
+        if (flashReadBytes(endOfLogs, testBuffer.bytes, FREE_BLOCK_TEST_SIZE_BYTES) == FREE_BLOCK_TEST_SIZE_BYTES) {
+            blockErased = true;
+            for (i = 0; i < FREE_BLOCK_TEST_SIZE_INTS; i++) {
+                if (testBuffer.ints[i] != 0xFFFFFFFF) {
+                    blockErased = false;
+                    break;
+                }
+            }
+
+            if (blockErased) {
+                return endOfLogs;
+            }
+        }
+
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+        if (logIndexErasePending) {
+            // The sectors behind the newest log haven't all been erased yet, so continue at the first one the erase will resume from
+            const uint32_t sectorSize = flashGeometry->sectorSize;
+            return MIN((endOfLogs + sectorSize - 1) / sectorSize * sectorSize, flashfsSize);
+        }
+#endif
+
+        // Something was written after the newest indexed log, so only search the space behind it
+        left = endOfLogs / FREE_BLOCK_SIZE;
+    }
+#endif
+
     while (left < right) {
         mid = (left + right) / 2;
 
@@ -592,6 +1167,13 @@ bool flashfsIsEOF(void)
 
 void flashfsClose(void)
 {
+#ifdef USE_FLASHFS_LOG_INDEX
+    const uint32_t endOfLog = flashfsGetOffset();
+
+    // The whole log has to be on the flash, and on NAND its last page programmed, before the index record is written
+    flashfsFlushSync();
+#endif
+
     switch(flashGeometry->flashType) {
     case FLASH_TYPE_NOR:
         break;
@@ -605,6 +1187,10 @@ void flashfsClose(void)
 
         break;
     }
+
+#ifdef USE_FLASHFS_LOG_INDEX
+    flashfsLogIndexAppend(endOfLog);
+#endif
 }
 
 /**
@@ -623,6 +1209,13 @@ void flashfsInit(void)
 
     flashfsSize = FLASH_PARTITION_SECTOR_COUNT(flashPartition) * flashGeometry->sectorSize;
 
+#ifdef USE_FLASHFS_LOG_INDEX
+    flashfsLogIndexInit();
+#endif
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+    flashfsEraseInit();
+#endif
+
     // Start the file pointer off at the beginning of free space so caller can start writing immediately
     flashfsSeekAbs(flashfsIdentifyStartOfFreeSpace());
 }
@@ -631,6 +1224,12 @@ void flashfsInit(void)
 bool flashfsVerifyEntireFlash(void)
 {
     flashfsEraseCompletely();
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+    while (flashfsIsErasing()) {
+        flashWaitForReady();
+        flashfsEraseUpdate();
+    }
+#endif
     flashfsInit();
 
     uint32_t address = 0;
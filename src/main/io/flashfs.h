@@ -57,3 +57,23 @@ bool flashfsIsEOF(void);
 
 bool flashfsVerifyEntireFlash(void);
 
+#ifdef USE_FLASHFS_LOG_INDEX
+typedef struct flashfsLogEntry_s {
+    uint16_t logNumber;
+    uint32_t startAddress;
+    uint32_t length;
+    uint32_t timestamp; // Seconds since Jan 1 1970, or 0 if the time was not known
+} flashfsLogEntry_t;
+
+void flashfsLogBegin(uint32_t timestamp);
+int32_t flashfsLogGetCurrentNumber(void);
+int flashfsLogGetCount(void);
+bool flashfsLogGetEntry(int index, flashfsLogEntry_t *entry);
+bool flashfsLogFindByNumber(uint16_t logNumber, flashfsLogEntry_t *entry);
+#endif
+
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+bool flashfsIsErasing(void);
+void flashfsEraseUpdate(void);
+#endif
+
@@ -490,8 +490,14 @@ void gpsUpdate(timeUs_t currentTimeUs)
 {
     // read out available GPS bytes
     if (gpsPort) {
-        while (serialRxBytesWaiting(gpsPort))
-            gpsNewData(serialRead(gpsPort));
+        const uint8_t *data;
+        uint32_t count;
+        while ((count = serialPeekContiguous(gpsPort, &data)) > 0) {
+            for (uint32_t i = 0; i < count; i++) {
+                gpsNewData(data[i]);
+            }
+            serialSkip(gpsPort, count);
+        }
     } else if (GPS_update & GPS_MSP_UPDATE) { // GPS data received via MSP
         gpsSetState(GPS_RECEIVING_DATA);
         gpsData.lastMessage = millis();
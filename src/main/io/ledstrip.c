@@ -291,7 +291,8 @@ static const char baseFunctionCodes[LED_BASEFUNCTION_COUNT]   = { 'C', 'F', 'A',
 static const char overlayCodes[LED_OVERLAY_COUNT]   = { 'T', 'O', 'B', 'V', 'I', 'W' };
 
 #define CHUNK_BUFFER_SIZE 11
-bool parseLedStripConfig(int ledIndex, const char *config)
+// Leaves the LED counts and grid as they were, reevaluateLedConfig() brings them up to date after the last change
+bool parseLedStripConfigEntry(int ledIndex, const char *config)
 {
     if (ledIndex >= LED_MAX_STRIP_LENGTH)
         return false;
@@ -373,6 +374,15 @@ bool parseLedStripConfig(int ledIndex, const char *config)
 
     *ledConfig = DEFINE_LED(x, y, color, direction_flags, baseFunction, overlay_flags, 0);
 
+    return true;
+}
+
+bool parseLedStripConfig(int ledIndex, const char *config)
+{
+    if (!parseLedStripConfigEntry(ledIndex, config)) {
+        return false;
+    }
+
     reevaluateLedConfig();
 
     return true;
@@ -217,6 +217,7 @@ static inline bool ledGetDirectionBit(const ledConfig_t *lcfg, int id) { return
 
 bool parseColor(int index, const char *colorConfig);
 
+bool parseLedStripConfigEntry(int ledIndex, const char *config);
 bool parseLedStripConfig(int ledIndex, const char *config);
 void generateLedConfig(ledConfig_t *ledConfig, char *ledConfigBuffer, size_t bufferSize);
 void reevaluateLedConfig(void);
@@ -515,6 +515,23 @@ static void nopConsumer(uint8_t data)
     UNUSED(data);
 }
 
+// Forwards what has been received on one port, as far as the other port's transmit buffer takes it.
+static void serialPassthroughForward(serialPort_t *from, serialPort_t *to, serialConsumer *consumer)
+{
+    const uint8_t *data;
+    uint32_t count = serialPeekContiguous(from, &data);
+
+    if (count > 0) {
+        LED0_ON;
+        count = serialWriteBufContiguous(to, data, count);
+        for (uint32_t i = 0; i < count; i++) {
+            consumer(data[i]);
+        }
+        serialSkip(from, count);
+        LED0_OFF;
+    }
+}
+
 /*
  A high-level serial passthrough implementation. Used by cli to start an
  arbitrary serial passthrough "proxy". Optional callbacks can be given to allow
@@ -534,31 +551,15 @@ void serialPassthrough(serialPort_t *left, serialPort_t *right, serialConsumer *
     LED1_OFF;
 
     // Either port might be open in a mode other than MODE_RXTX. We rely on
-    // serialRxBytesWaiting() to do the right thing for a TX only port. No
+    // serialPeekContiguous() to do the right thing for a TX only port. No
     // special handling is necessary OR performed.
     while (1) {
         // TODO: maintain a timestamp of last data received. Use this to
         // implement a guard interval and check for `+++` as an escape sequence
         // to return to CLI command mode.
         // https://en.wikipedia.org/wiki/Escape_sequence#Modem_control
-        if (serialRxBytesWaiting(left)) {
-            LED0_ON;
-            uint8_t c = serialRead(left);
-            // Make sure there is space in the tx buffer
-            while (!serialTxBytesFree(right));
-            serialWrite(right, c);
-            leftC(c);
-            LED0_OFF;
-         }
-         if (serialRxBytesWaiting(right)) {
-             LED0_ON;
-             uint8_t c = serialRead(right);
-             // Make sure there is space in the tx buffer
-             while (!serialTxBytesFree(left));
-             serialWrite(left, c);
-             rightC(c);
-             LED0_OFF;
-         }
-     }
- }
+        serialPassthroughForward(left, right, leftC);
+        serialPassthroughForward(right, left, rightC);
+    }
+}
  #endif
@@ -30,6 +30,8 @@
 
 #ifdef  USE_SERIAL_4WAY_BLHELI_INTERFACE
 
+#include "common/crc.h"
+
 #include "drivers/buf_writer.h"
 #include "drivers/io.h"
 #include "drivers/serial.h"
@@ -282,53 +284,6 @@ void esc4wayRelease(void)
 #define ACK_I_INVALID_PARAM     0x09
 #define ACK_D_GENERAL_ERROR     0x0F
 
-/* Copyright (c) 2002, 2003, 2004  Marek Michalkiewicz
-   Copyright (c) 2005, 2007 Joerg Wunsch
-   Copyright (c) 2013 Dave Hylands
-   Copyright (c) 2013 Frederic Nadeau
-   All rights reserved.
-
-   Redistribution and use in source and binary forms, with or without
-   modification, are permitted provided that the following conditions are met:
-
-   * Redistributions of source code must retain the above copyright
-     notice, this list of conditions and the following disclaimer.
-
-   * Redistributions in binary form must reproduce the above copyright
-     notice, this list of conditions and the following disclaimer in
-     the documentation and/or other materials provided with the
-     distribution.
-
-   * Neither the name of the copyright holders nor the names of
-     contributors may be used to endorse or promote products derived
-     from this software without specific prior written permission.
-
-  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
-  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
-  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
-  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
-  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
-  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
-  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
-  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
-  POSSIBILITY OF SUCH DAMAGE. */
-uint16_t _crc_xmodem_update (uint16_t crc, uint8_t data) {
-        int i;
-
-        crc = crc ^ ((uint16_t)data << 8);
-        for (i=0; i < 8; i++) {
-            if (crc & 0x8000)
-                crc = (crc << 1) ^ 0x1021;
-            else
-                crc <<= 1;
-        }
-        return crc;
-}
-// * End copyright
-
-
 #define ATMEL_DEVICE_MATCH ((pDeviceInfo->words[0] == 0x9307) || (pDeviceInfo->words[0] == 0x930A) || \
         (pDeviceInfo->words[0] == 0x930F) || (pDeviceInfo->words[0] == 0x940B))
 
@@ -400,7 +355,7 @@ static uint8_16_u CRC_in;
 static uint8_t ReadByteCrc(void)
 {
     uint8_t b = ReadByte();
-    CRC_in.word = _crc_xmodem_update(CRC_in.word, b);
+    CRC_in.word = crc16_ccitt(CRC_in.word, b);
     return b;
 }
 
@@ -413,7 +368,7 @@ static uint8_16_u CRCout;
 static void WriteByteCrc(uint8_t b)
 {
     WriteByte(b);
-    CRCout.word = _crc_xmodem_update(CRCout.word, b);
+    CRCout.word = crc16_ccitt(CRCout.word, b);
 }
 
 void esc4wayProcess(serialPort_t *mspPort)
@@ -35,10 +35,12 @@
 #include "build/version.h"
 
 #include "cli/cli.h"
+#include "cli/settings.h"
 
 #include "common/axis.h"
 #include "common/bitarray.h"
 #include "common/color.h"
+#include "common/crc.h"
 #include "common/huffman.h"
 #include "common/maths.h"
 #include "common/streambuf.h"
@@ -75,6 +77,7 @@
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
+#include "fc/rx_latency.h"
 
 #include "flight/failsafe.h"
 #include "flight/gps_rescue.h"
@@ -102,6 +105,7 @@
 
 #include "msp/msp_box.h"
 #include "msp/msp_protocol.h"
+#include "msp/msp_protocol_v2_betaflight.h"
 #include "msp/msp_serial.h"
 
 #include "osd/osd.h"
@@ -112,6 +116,7 @@
 #include "pg/gyrodev.h"
 #include "pg/max7456.h"
 #include "pg/motor.h"
+#include "pg/pg.h"
 #include "pg/rx.h"
 #include "pg/rx_spi.h"
 #include "pg/usb.h"
@@ -170,7 +175,8 @@ typedef enum {
 
 typedef enum {
     MSP_FLASHFS_FLAG_READY       = 1,
-    MSP_FLASHFS_FLAG_SUPPORTED  = 2
+    MSP_FLASHFS_FLAG_SUPPORTED  = 2,
+    MSP_FLASHFS_FLAG_ERASING    = 4
 } mspFlashFsFlags_e;
 
 #define RATEPROFILE_MASK (1 << 7)
@@ -383,7 +389,15 @@ static void serializeDataflashSummaryReply(sbuf_t *dst)
 #ifdef USE_FLASHFS
     if (flashfsIsSupported()) {
         uint8_t flags = MSP_FLASHFS_FLAG_SUPPORTED;
-        flags |= (flashfsIsReady() ? MSP_FLASHFS_FLAG_READY : 0);
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+        // Configurators wait for the ready flag after MSP_DATAFLASH_ERASE, so it stays clear until the background erase is done
+        if (flashfsIsErasing()) {
+            flags |= MSP_FLASHFS_FLAG_ERASING;
+        } else
+#endif
+        {
+            flags |= (flashfsIsReady() ? MSP_FLASHFS_FLAG_READY : 0);
+        }
 
         const flashPartition_t *flashPartition = flashPartitionFindByType(FLASH_PARTITION_TYPE_FLASHFS);
 
@@ -409,7 +423,10 @@ enum compressionType_e {
     HUFFMAN
 };
 
-static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, bool allowCompression)
+/*
+ * Reads are truncated at endAddress, which is the end of the volume or of the log being read.
+ */
+static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, const uint32_t endAddress, bool useLegacyFormat, bool allowCompression)
 {
     STATIC_ASSERT(MSP_PORT_DATAFLASH_INFO_SIZE >= 16, MSP_PORT_DATAFLASH_INFO_SIZE_invalid);
 
@@ -419,10 +436,9 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
         readLen = bytesRemainingInBuf;
     }
     // size will be lower than that requested if we reach end of volume
-    const uint32_t flashfsSize = flashfsGetSize();
-    if (readLen > flashfsSize - address) {
+    if (readLen > endAddress - address) {
         // truncate the request
-        readLen = flashfsSize - address;
+        readLen = endAddress - address;
     }
     sbufWriteU32(dst, address);
 
@@ -474,9 +490,9 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
 
         uint16_t bytesReadTotal = 0;
         // read until output buffer overflows or flash is exhausted
-        while (state.bytesWritten < state.outBufLen && address + bytesReadTotal < flashfsSize) {
+        while (state.bytesWritten < state.outBufLen && address + bytesReadTotal < endAddress) {
             const int bytesRead = flashfsReadAbs(address + bytesReadTotal, readBuffer,
-                MIN(sizeof(readBuffer), flashfsSize - address - bytesReadTotal));
+                MIN(sizeof(readBuffer), endAddress - address - bytesReadTotal));
 
             const int status = huffmanEncodeBufStreaming(&state, readBuffer, bytesRead, huffmanTable);
             if (status == -1) {
@@ -502,11 +518,170 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
 }
 #endif // USE_FLASHFS
 
+#ifdef USE_MSP_PG_TRANSFER
+// Lets a client tell whether its copy of a parameter group is still up to date
+static uint16_t mspPgCrc(const pgRegistry_t *reg)
+{
+    return crc16_ccitt_update(0, reg->address, pgSize(reg));
+}
+
+// A raw write of length bytes of data at offset into a parameter group, not yet applied
+typedef struct mspPgWrite_s {
+    const pgRegistry_t *reg;
+    const uint8_t *data;
+    int offset;
+    int length;
+} mspPgWrite_t;
+
+// The group as it would be after the write
+static uint8_t mspPgWriteByte(const mspPgWrite_t *write, int position)
+{
+    if (position >= write->offset && position < write->offset + write->length) {
+        return write->data[position - write->offset];
+    }
+    return write->reg->address[position];
+}
+
+static int mspPgWriteValue(const mspPgWrite_t *write, const clivalue_t *var, int position)
+{
+    switch (var->type & VALUE_TYPE_MASK) {
+    case VAR_UINT8:
+        return mspPgWriteByte(write, position);
+    case VAR_INT8:
+        return (int8_t)mspPgWriteByte(write, position);
+    case VAR_UINT16:
+        return (uint16_t)(mspPgWriteByte(write, position) | mspPgWriteByte(write, position + 1) << 8);
+    case VAR_INT16:
+        return (int16_t)(mspPgWriteByte(write, position) | mspPgWriteByte(write, position + 1) << 8);
+    default:
+        return mspPgWriteByte(write, position) | mspPgWriteByte(write, position + 1) << 8
+            | mspPgWriteByte(write, position + 2) << 16 | (uint32_t)mspPgWriteByte(write, position + 3) << 24;
+    }
+}
+
+static int mspPgValueSize(const clivalue_t *var)
+{
+    switch (var->type & VALUE_TYPE_MASK) {
+    case VAR_UINT8:
+    case VAR_INT8:
+        return sizeof(uint8_t);
+    case VAR_UINT16:
+    case VAR_INT16:
+        return sizeof(uint16_t);
+    default:
+        return sizeof(uint32_t);
+    }
+}
+
+// Whether the value would be accepted by the CLI, with the same checks it makes with set
+static bool mspPgWriteValueIsValid(const mspPgWrite_t *write, const clivalue_t *var, int position)
+{
+    const int value = mspPgWriteValue(write, var, position);
+
+    switch (var->type & VALUE_MODE_MASK) {
+    case MODE_DIRECT:
+        if ((var->type & VALUE_TYPE_MASK) == VAR_UINT32) {
+            return (uint32_t)value <= var->config.u32Max;
+        } else if ((var->type & VALUE_TYPE_MASK) == VAR_UINT8 || (var->type & VALUE_TYPE_MASK) == VAR_UINT16) {
+            return value >= var->config.minmaxUnsigned.min && value <= var->config.minmaxUnsigned.max;
+        } else {
+            return value >= var->config.minmax.min && value <= var->config.minmax.max;
+        }
+    case MODE_LOOKUP:
+        return (uint32_t)value < lookupTables[var->config.lookup.tableIndex].valueCount;
+    case MODE_STRING:
+        for (int i = 0; i <= var->config.string.maxlength; i++) {
+            if (mspPgWriteByte(write, position + i) == 0) {
+                return true;
+            }
+        }
+        return false;
+    default:
+        // Every value of an array or a bit is valid
+        return true;
+    }
+}
+
+/*
+ * Raw writes are only taken where the settings table can check them. Every setting the write touches has to be in
+ * the range the CLI accepts, and the bytes no setting describes (padding, IO tags and the tables with their own
+ * commands) have to stay as they are.
+ */
+static bool mspPgWriteIsValid(const mspPgWrite_t *write)
+{
+    uint32_t described[(MSP_PORT_INBUF_SIZE + 31) / 32] = { 0 };
+    const pgRegistry_t *reg = write->reg;
+
+    if (write->length > MSP_PORT_INBUF_SIZE) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < valueTableEntryCount; i++) {
+        const clivalue_t *var = &valueTable[i];
+        if (var->pgn != pgN(reg)) {
+            continue;
+        }
+        if ((var->type & VALUE_MODE_MASK) == MODE_STRING && (var->config.string.flags & STRING_FLAGS_WRITEONCE)) {
+            continue;
+        }
+
+        int size;
+        switch (var->type & VALUE_MODE_MASK) {
+        case MODE_ARRAY:
+            size = mspPgValueSize(var) * var->config.array.length;
+            break;
+        case MODE_STRING:
+            size = var->config.string.maxlength + 1;
+            break;
+        default:
+            size = mspPgValueSize(var);
+            break;
+        }
+
+        // Profile settings are in every element of the group, the others only in the first
+        const uint8_t section = var->type & VALUE_SECTION_MASK;
+        const int elementCount = (section == PROFILE_VALUE || section == PROFILE_RATE_VALUE) ? reg->length : 1;
+        for (int element = 0; element < elementCount; element++) {
+            const int position = element * pgElementSize(reg) + var->offset;
+            if (position + size <= write->offset || position >= write->offset + write->length) {
+                continue;
+            }
+            if (!mspPgWriteValueIsValid(write, var, position)) {
+                return false;
+            }
+            for (int j = MAX(position, write->offset); j < MIN(position + size, write->offset + write->length); j++) {
+                bitArraySet(described, j - write->offset);
+            }
+        }
+    }
+
+    for (int i = 0; i < write->length; i++) {
+        if (!bitArrayGet(described, i) && write->data[i] != reg->address[write->offset + i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif
+
+#ifdef USE_OSD_FONT_QUEUE
+static void serializeOsdFontStatus(sbuf_t *dst)
+{
+    max7456NvmWriteStatus_t status;
+    max7456GetNvmWriteStatus(&status);
+
+    sbufWriteU8(dst, status.queued);
+    sbufWriteU8(dst, status.free);
+    sbufWriteU16(dst, status.written);
+}
+#endif
+
 /*
  * Returns true if the command was processd, false otherwise.
  * May set mspPostProcessFunc to a function to be called once the command has been processed
  */
-static bool mspCommonProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+static bool mspCommonProcessOutCommand(int16_t cmdMSP, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
 {
     UNUSED(mspPostProcessFn);
 
@@ -889,7 +1064,7 @@ static bool mspCommonProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst, mspPostProce
     return true;
 }
 
-static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
+static bool mspProcessOutCommand(int16_t cmdMSP, sbuf_t *dst)
 {
     bool unsupportedCommand = false;
 
@@ -1775,7 +1950,7 @@ static bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
     return !unsupportedCommand;
 }
 
-static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, uint8_t cmdMSP, sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *src, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
 {
 
     switch (cmdMSP) {
@@ -1899,6 +2074,253 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, uint8_
         break;
 #endif // USE_VTX_TABLE
 
+#ifdef USE_FLASHFS_LOG_INDEX
+    case MSP2_BETAFLIGHT_DATAFLASH_LOG_LIST:
+        {
+            // Damaged index entries are skipped, the reply ends with the index to continue the listing from
+            const int logCount = flashfsLogGetCount();
+            int index = sbufBytesRemaining(src) >= (int)sizeof(uint16_t) ? sbufReadU16(src) : 0;
+
+            sbufWriteU16(dst, logCount);
+            uint8_t *entryCountPtr = sbufPtr(dst);
+            sbufWriteU8(dst, 0);
+
+            uint8_t entryCount = 0;
+            // 14 bytes for each entry and 2 bytes for the next index
+            while (index < logCount && entryCount < UINT8_MAX && sbufBytesRemaining(dst) >= 14 + 2) {
+                flashfsLogEntry_t entry;
+                if (flashfsLogGetEntry(index, &entry)) {
+                    sbufWriteU16(dst, entry.logNumber);
+                    sbufWriteU32(dst, entry.startAddress);
+                    sbufWriteU32(dst, entry.length);
+                    sbufWriteU32(dst, entry.timestamp);
+                    entryCount++;
+                }
+                index++;
+            }
+
+            *entryCountPtr = entryCount;
+            sbufWriteU16(dst, index);
+        }
+        break;
+
+    case MSP2_BETAFLIGHT_DATAFLASH_LOG_READ:
+        {
+            if (sbufBytesRemaining(src) < (int)(sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint16_t))) {
+                return MSP_RESULT_ERROR;
+            }
+
+            const uint16_t logNumber = sbufReadU16(src);
+            const uint32_t logOffset = sbufReadU32(src);
+            const uint16_t readLength = sbufReadU16(src);
+            const bool allowCompression = sbufBytesRemaining(src) ? sbufReadU8(src) : false;
+
+            flashfsLogEntry_t entry;
+            if (!flashfsLogFindByNumber(logNumber, &entry) || logOffset > entry.length) {
+                return MSP_RESULT_ERROR;
+            }
+
+            sbufWriteU16(dst, logNumber);
+            serializeDataflashReadReply(dst, entry.startAddress + logOffset, readLength, entry.startAddress + entry.length, false, allowCompression);
+        }
+        break;
+#endif // USE_FLASHFS_LOG_INDEX
+
+#ifdef USE_MSP_PG_TRANSFER
+    case MSP2_BETAFLIGHT_PG_LIST:
+        {
+            // The reply ends with the index to continue the listing from
+            const int pgCount = PG_REGISTRY_SIZE;
+            int index = sbufBytesRemaining(src) >= (int)sizeof(uint16_t) ? sbufReadU16(src) : 0;
+
+            sbufWriteU16(dst, pgCount);
+            uint8_t *entryCountPtr = sbufPtr(dst);
+            sbufWriteU8(dst, 0);
+
+            uint8_t entryCount = 0;
+            // 7 bytes for each entry and 2 bytes for the next index
+            while (index < pgCount && entryCount < UINT8_MAX && sbufBytesRemaining(dst) >= 7 + 2) {
+                const pgRegistry_t *reg = &__pg_registry_start[index];
+
+                sbufWriteU16(dst, pgN(reg));
+                sbufWriteU8(dst, pgVersion(reg));
+                sbufWriteU16(dst, pgSize(reg));
+                sbufWriteU16(dst, mspPgCrc(reg));
+                entryCount++;
+                index++;
+            }
+
+            *entryCountPtr = entryCount;
+            sbufWriteU16(dst, index);
+        }
+        break;
+
+    case MSP2_BETAFLIGHT_PG_READ:
+        {
+            if (sbufBytesRemaining(src) < 2 * (int)sizeof(uint16_t)) {
+                return MSP_RESULT_ERROR;
+            }
+
+            const pgn_t pgn = sbufReadU16(src);
+            const uint16_t offset = sbufReadU16(src);
+
+            const pgRegistry_t *reg = pgFind(pgn);
+            if (!reg || offset > pgSize(reg)) {
+                return MSP_RESULT_ERROR;
+            }
+
+            sbufWriteU16(dst, pgn);
+            sbufWriteU8(dst, pgVersion(reg));
+            sbufWriteU16(dst, pgSize(reg));
+            sbufWriteU16(dst, mspPgCrc(reg));
+            sbufWriteU16(dst, offset);
+
+            // Big groups take several reads
+            const int length = MIN(pgSize(reg) - offset, sbufBytesRemaining(dst));
+            sbufWriteData(dst, reg->address + offset, length);
+        }
+        break;
+
+    case MSP2_BETAFLIGHT_PG_WRITE:
+        {
+            if (ARMING_FLAG(ARMED) || sbufBytesRemaining(src) < (int)(sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint16_t))) {
+                return MSP_RESULT_ERROR;
+            }
+
+            const pgn_t pgn = sbufReadU16(src);
+            const uint8_t version = sbufReadU8(src);
+            const uint16_t offset = sbufReadU16(src);
+            const int length = sbufBytesRemaining(src);
+
+            // Groups saved by another firmware version can't be taken as they are
+            const pgRegistry_t *reg = pgFind(pgn);
+            if (!reg || version != pgVersion(reg) || offset + length > pgSize(reg)) {
+                return MSP_RESULT_ERROR;
+            }
+
+            // The group is only changed once the whole write has been checked
+            const mspPgWrite_t write = { .reg = reg, .data = sbufPtr(src), .offset = offset, .length = length };
+            if (!mspPgWriteIsValid(&write)) {
+                return MSP_RESULT_ERROR;
+            }
+            sbufReadData(src, reg->address + offset, length);
+
+            // So the client can check the whole group arrived as it meant, MSP_EEPROM_WRITE saves it
+            sbufWriteU16(dst, mspPgCrc(reg));
+        }
+        break;
+#endif
+
+#ifdef USE_MSP_DATAFLASH_STREAM
+    case MSP2_BETAFLIGHT_DATAFLASH_STREAM:
+        {
+            if (sbufBytesRemaining(src) < (int)(sizeof(uint32_t) + sizeof(uint32_t))) {
+                return MSP_RESULT_ERROR;
+            }
+
+            const uint32_t address = sbufReadU32(src);
+            uint32_t length = sbufReadU32(src);
+            const uint16_t chunkSize = sbufBytesRemaining(src) >= (int)sizeof(uint16_t) ? sbufReadU16(src) : MSP_STREAM_TRANSFER_MAX_CHUNK_SIZE;
+
+            if (address > flashfsGetSize()) {
+                return MSP_RESULT_ERROR;
+            }
+            length = MIN(length, flashfsGetSize() - address);
+
+            // The chunks follow as the port can take them, a length of 0 stops the stream
+            if (!mspSerialStreamTransferStart(srcDesc, MSP2_BETAFLIGHT_DATAFLASH_CHUNK, address, length, chunkSize)) {
+                return MSP_RESULT_ERROR;
+            }
+
+            sbufWriteU32(dst, address);
+            sbufWriteU32(dst, length);
+        }
+        break;
+#endif
+
+#ifdef USE_OSD_FONT_QUEUE
+    case MSP2_BETAFLIGHT_OSD_FONT_WRITE:
+        {
+            // A first character address followed by the 54 bytes of each character, as many as fit the queue are taken
+            if (ARMING_FLAG(ARMED) || sbufBytesRemaining(src) < 1 + MAX7456_NVM_CHAR_SIZE) {
+                return MSP_RESULT_ERROR;
+            }
+
+            const uint8_t address = sbufReadU8(src);
+            uint8_t accepted = 0;
+            while (sbufBytesRemaining(src) >= MAX7456_NVM_CHAR_SIZE && address + accepted <= UINT8_MAX) {
+                if (!max7456QueueNvmWrite(address + accepted, sbufPtr(src))) {
+                    break;
+                }
+                sbufAdvance(src, MAX7456_NVM_CHAR_SIZE);
+                accepted++;
+            }
+
+            sbufWriteU8(dst, accepted);
+            serializeOsdFontStatus(dst);
+        }
+        break;
+
+    case MSP2_BETAFLIGHT_OSD_FONT_STATUS:
+        serializeOsdFontStatus(dst);
+        break;
+#endif
+
+#ifdef USE_RX_LATENCY
+    case MSP2_BETAFLIGHT_RX_LATENCY:
+        {
+            // The statistics are sent as they were, a non-zero argument starts a new measurement afterwards
+            const bool reset = sbufBytesRemaining(src) ? sbufReadU8(src) : false;
+            const rxLatencyStats_t *stats = rxLatencyGetStats();
+
+            sbufWriteU32(dst, stats->count);
+            sbufWriteU16(dst, stats->lastUs);
+            sbufWriteU16(dst, stats->minUs);
+            sbufWriteU16(dst, stats->maxUs);
+            sbufWriteU16(dst, lrintf(stats->averageUs));
+            sbufWriteU16(dst, RX_LATENCY_BUCKET_US);
+            sbufWriteU8(dst, RX_LATENCY_BUCKET_COUNT);
+            for (int i = 0; i < RX_LATENCY_BUCKET_COUNT; i++) {
+                sbufWriteU32(dst, stats->histogram[i]);
+            }
+
+            if (reset) {
+                rxLatencyReset();
+            }
+        }
+        break;
+#endif
+
+#ifdef USE_MSP_STREAM
+    case MSP2_BETAFLIGHT_STREAM_SUBSCRIBE:
+        {
+            // The payload is a list of (message, interval in ms) pairs, an empty list ends the stream
+            mspStreamSubscription_t subscriptions[MSP_STREAM_MAX_SUBSCRIPTIONS];
+            int count = 0;
+
+            while (sbufBytesRemaining(src) >= 2 * (int)sizeof(uint16_t)) {
+                const uint16_t cmd = sbufReadU16(src);
+                const uint16_t intervalMs = sbufReadU16(src);
+
+                if (count == MSP_STREAM_MAX_SUBSCRIPTIONS) {
+                    return MSP_RESULT_ERROR;
+                }
+                if (intervalMs > 0) {
+                    subscriptions[count].cmd = cmd;
+                    subscriptions[count].intervalMs = MAX(intervalMs, MSP_STREAM_MIN_INTERVAL_MS);
+                    count++;
+                }
+            }
+
+            if (!mspSerialStreamSubscribe(srcDesc, subscriptions, count)) {
+                return MSP_RESULT_ERROR;
+            }
+
+            sbufWriteU8(dst, count);
+        }
+        break;
+#endif
+
     case MSP_RESET_CONF:
         {
 #if defined(USE_CUSTOM_DEFAULTS)
@@ -1957,11 +2379,43 @@ static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
         useLegacyFormat = true;
     }
 
-    serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, allowCompression);
+    serializeDataflashReadReply(dst, readAddress, readLength, flashfsGetSize(), useLegacyFormat, allowCompression);
+}
+#endif
+
+#ifdef USE_MSP_DATAFLASH_STREAM
+/*
+ * One chunk of a dataflash stream: sequence number, address, length, data and a CRC16 of the data, so the client can
+ * tell which chunks went missing or arrived damaged and ask for those ranges again.
+ */
+static bool serializeDataflashChunk(sbuf_t *dst, sbuf_t *src)
+{
+    if (sbufBytesRemaining(src) < (int)(sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint16_t))) {
+        return false;
+    }
+
+    const uint16_t seq = sbufReadU16(src);
+    const uint32_t address = sbufReadU32(src);
+    const uint16_t size = MIN(sbufReadU16(src), sbufBytesRemaining(dst) - MSP_PORT_DATAFLASH_INFO_SIZE);
+
+    sbufWriteU16(dst, seq);
+    sbufWriteU32(dst, address);
+
+    uint8_t *data = sbufPtr(dst) + sizeof(uint16_t);
+    const int bytesRead = flashfsReadAbs(address, data, size);
+    if (bytesRead <= 0) {
+        return false;
+    }
+
+    sbufWriteU16(dst, bytesRead);
+    sbufAdvance(dst, bytesRead);
+    sbufWriteU16(dst, crc16_ccitt_update(0, data, bytesRead));
+
+    return true;
 }
 #endif
 
-static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP, sbuf_t *src)
+static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *src)
 {
     uint32_t i;
     uint8_t value;
@@ -3084,7 +3538,7 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP,
     return MSP_RESULT_ACK;
 }
 
-static mspResult_e mspCommonProcessInCommand(mspDescriptor_t srcDesc, uint8_t cmdMSP, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
+static mspResult_e mspCommonProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn)
 {
     UNUSED(mspPostProcessFn);
     const unsigned int dataSize = sbufBytesRemaining(src);
@@ -3288,9 +3742,18 @@ static mspResult_e mspCommonProcessInCommand(mspDescriptor_t srcDesc, uint8_t cm
                 font_data[i] = sbufReadU8(src);
             }
             // !!TODO - replace this with a device independent implementation
+#ifdef USE_OSD_FONT_QUEUE
+            // Only waits for the NVM when a client sends characters faster than they can be programmed
+            while (!max7456QueueNvmWrite(addr, font_data)) {
+                if (!max7456UpdateNvmWrite()) {
+                    return MSP_RESULT_ERROR;
+                }
+            }
+#else
             if (!max7456WriteNvm(addr, font_data)) {
                 return MSP_RESULT_ERROR;
             }
+#endif
         }
         break;
 #else
@@ -3312,7 +3775,7 @@ mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPa
     int ret = MSP_RESULT_ACK;
     sbuf_t *dst = &reply->buf;
     sbuf_t *src = &cmd->buf;
-    const uint8_t cmdMSP = cmd->cmd;
+    const int16_t cmdMSP = cmd->cmd;
     // initialize reply by default
     reply->cmd = cmd->cmd;
 
@@ -3339,6 +3802,37 @@ mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPa
     return ret;
 }
 
+#ifdef USE_MSP_STREAM
+/*
+ * Streamed messages are sent without a request, so only messages that take no arguments and change nothing can be
+ * subscribed to.
+ */
+mspResult_e mspFcProcessStreamCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(srcDesc);
+
+    sbuf_t *dst = &reply->buf;
+    const int16_t cmdMSP = cmd->cmd;
+    reply->cmd = cmd->cmd;
+
+#ifdef USE_MSP_DATAFLASH_STREAM
+    if (cmdMSP == MSP2_BETAFLIGHT_DATAFLASH_CHUNK) {
+        // Only sent for a dataflash stream, which asks for the chunk it wants
+        reply->result = serializeDataflashChunk(dst, &cmd->buf) ? MSP_RESULT_ACK : MSP_RESULT_ERROR;
+        return reply->result;
+    }
+#endif
+
+    if (mspCommonProcessOutCommand(cmdMSP, dst, mspPostProcessFn) || mspProcessOutCommand(cmdMSP, dst)) {
+        reply->result = MSP_RESULT_ACK;
+    } else {
+        reply->result = MSP_RESULT_CMD_UNKNOWN;
+    }
+
+    return reply->result;
+}
+#endif
+
 void mspFcProcessReply(mspPacket_t *reply)
 {
     sbuf_t *src = &reply->buf;
@@ -0,0 +1,35 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// MSPv2 commands specific to Betaflight, only reachable with MSPv2 framing.
+
+#define MSP2_BETAFLIGHT_DATAFLASH_LOG_LIST  0x3000  //out message         List the logs in the flash log index
+#define MSP2_BETAFLIGHT_DATAFLASH_LOG_READ  0x3001  //out message         Read a block of data from a log in the flash log index
+#define MSP2_BETAFLIGHT_STREAM_SUBSCRIBE    0x3002  //in/out message      Replace the set of messages the FC pushes to this port, with their intervals
+#define MSP2_BETAFLIGHT_PG_LIST             0x3003  //out message         List the parameter groups with their version, size and CRC
+#define MSP2_BETAFLIGHT_PG_READ             0x3004  //out message         Read the binary contents of a parameter group
+#define MSP2_BETAFLIGHT_PG_WRITE            0x3005  //in/out message      Write the binary contents of a parameter group
+#define MSP2_BETAFLIGHT_DATAFLASH_STREAM    0x3006  //in/out message      Stream a range of the dataflash to this port as DATAFLASH_CHUNK messages
+#define MSP2_BETAFLIGHT_DATAFLASH_CHUNK     0x3007  //out message         One chunk of a dataflash stream, with its sequence number and CRC
+#define MSP2_BETAFLIGHT_OSD_FONT_WRITE      0x3008  //in/out message      Queue a block of consecutive OSD font characters to be programmed in the background
+#define MSP2_BETAFLIGHT_OSD_FONT_STATUS     0x3009  //out message         Progress of the OSD font characters being programmed
+#define MSP2_BETAFLIGHT_RX_LATENCY          0x300A  //out message         Distribution of the time from RX frame arrival to motor output, optionally reset
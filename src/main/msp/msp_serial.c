@@ -28,11 +28,13 @@
 
 #include "cli/cli.h"
 
+#include "common/maths.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
 #include "common/crc.h"
 
 #include "drivers/system.h"
+#include "drivers/time.h"
 
 #include "io/displayport_msp.h"
 
@@ -42,6 +44,13 @@
 
 static mspPort_t mspPorts[MAX_MSP_PORT_COUNT];
 
+// Replies are written behind room for the largest header, so mspSerialEncode() can put the frame together in place
+#define MSP_SERIAL_MAX_HEADER_SIZE   (3 + sizeof(mspHeaderV1_t) + sizeof(mspHeaderV2_t) + sizeof(mspHeaderJUMBO_t))
+#define MSP_SERIAL_MAX_CHECKSUM_SIZE 2
+
+static uint8_t mspSerialOutFrame[MSP_SERIAL_MAX_HEADER_SIZE + MSP_PORT_OUTBUF_SIZE + MSP_SERIAL_MAX_CHECKSUM_SIZE];
+static uint8_t * const mspSerialOutBuf = &mspSerialOutFrame[MSP_SERIAL_MAX_HEADER_SIZE];
+
 static void resetMspPort(mspPort_t *mspPortToReset, serialPort_t *serialPort, bool sharedWithTelemetry)
 {
     memset(mspPortToReset, 0, sizeof(mspPort_t));
@@ -280,47 +289,151 @@ static uint8_t mspSerialChecksumBuf(uint8_t checksum, const uint8_t *data, int l
     return checksum;
 }
 
+#ifdef USE_MSP_PIPELINE
+// Commands queued up in the RX buffer are handled back to back, up to these limits
+#define MSP_SERIAL_MAX_COMMANDS_PER_PASS 16
+#define MSP_SERIAL_PROCESS_BUDGET_US     500
+
+static int mspSerialPendingTxLength(const mspPort_t *msp)
+{
+    return msp->pendingTxEnd - msp->pendingTxStart;
+}
+
+// Move as much of the pending data into the TX buffer as it has room for
+static void mspSerialFlushPendingTx(mspPort_t *msp)
+{
+    const int length = MIN(mspSerialPendingTxLength(msp), (int)serialTxBytesFree(msp->port));
+
+    if (length > 0) {
+        serialBeginWrite(msp->port);
+        serialWriteBuf(msp->port, &msp->pendingTx[msp->pendingTxStart], length);
+        serialEndWrite(msp->port);
+        msp->pendingTxStart += length;
+    }
+
+    if (msp->pendingTxStart == msp->pendingTxEnd) {
+        msp->pendingTxStart = 0;
+        msp->pendingTxEnd = 0;
+    }
+}
+
+static void mspSerialAppendPendingTx(mspPort_t *msp, const uint8_t *data, int len)
+{
+    memcpy(&msp->pendingTx[msp->pendingTxEnd], data, len);
+    msp->pendingTxEnd += len;
+}
+#endif
+
 #define JUMBO_FRAME_SIZE_LIMIT 255
-static int mspSerialSendFrame(mspPort_t *msp, const uint8_t * hdr, int hdrLen, const uint8_t * data, int dataLen, const uint8_t * crc, int crcLen)
+
+#ifdef USE_MSP_STREAM
+// Number of bytes mspSerialEncode() adds around a payload of dataLen bytes
+static int mspSerialFrameOverhead(mspVersion_e mspVersion, int dataLen)
+{
+    switch (mspVersion) {
+    case MSP_V1:
+        return 3 + sizeof(mspHeaderV1_t) + (dataLen >= JUMBO_FRAME_SIZE_LIMIT ? sizeof(mspHeaderJUMBO_t) : 0) + 1;
+    case MSP_V2_OVER_V1:
+        dataLen += sizeof(mspHeaderV2_t) + 1;
+        return 3 + sizeof(mspHeaderV1_t) + sizeof(mspHeaderV2_t) + (dataLen >= JUMBO_FRAME_SIZE_LIMIT ? sizeof(mspHeaderJUMBO_t) : 0) + 2;
+    case MSP_V2_NATIVE:
+        return 3 + sizeof(mspHeaderV2_t) + 1;
+    default:
+        return 0;
+    }
+}
+#endif
+
+static int mspSerialSendFrame(mspPort_t *msp, const uint8_t *frame, int frameLength)
 {
     // We are allowed to send out the response if
     //  a) TX buffer is completely empty (we are talking to well-behaving party that follows request-response scheduling;
     //     this allows us to transmit jumbo frames bigger than TX buffer (serialWriteBuf will block, but for jumbo frames we don't care)
     //  b) Response fits into TX buffer
-    const int totalFrameLength = hdrLen + dataLen + crcLen;
-    if (!isSerialTransmitBufferEmpty(msp->port) && ((int)serialTxBytesFree(msp->port) < totalFrameLength))
+
+#ifdef USE_MSP_PIPELINE
+    //  c) Response fits into the pending TX buffer, which drains into the TX buffer as it empties
+    mspSerialFlushPendingTx(msp);
+
+    if (mspSerialPendingTxLength(msp) > 0 || (int)serialTxBytesFree(msp->port) < frameLength) {
+        if (msp->pendingTxStart > 0) {
+            memmove(msp->pendingTx, &msp->pendingTx[msp->pendingTxStart], mspSerialPendingTxLength(msp));
+            msp->pendingTxEnd -= msp->pendingTxStart;
+            msp->pendingTxStart = 0;
+        }
+
+        if (MSP_PORT_PENDING_TX_SIZE - msp->pendingTxEnd >= frameLength) {
+            mspSerialAppendPendingTx(msp, frame, frameLength);
+
+            return frameLength;
+        }
+
+        if (mspSerialPendingTxLength(msp) > 0) {
+            // Can't jump the queue
+            return 0;
+        }
+    }
+#endif
+
+    if (!isSerialTransmitBufferEmpty(msp->port) && ((int)serialTxBytesFree(msp->port) < frameLength))
         return 0;
 
     // Transmit frame
     serialBeginWrite(msp->port);
-    serialWriteBuf(msp->port, hdr, hdrLen);
-    serialWriteBuf(msp->port, data, dataLen);
-    serialWriteBuf(msp->port, crc, crcLen);
+    serialWriteBuf(msp->port, frame, frameLength);
     serialEndWrite(msp->port);
 
-    return totalFrameLength;
+    return frameLength;
 }
 
+// The frame is built around the payload in mspSerialOutFrame, so it goes to the port in one piece without being copied
 static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e mspVersion)
 {
     static const uint8_t mspMagic[MSP_VERSION_COUNT] = MSP_VERSION_MAGIC_INITIALIZER;
     const int dataLen = sbufBytesRemaining(&packet->buf);
-    uint8_t hdrBuf[16] = { '$', mspMagic[mspVersion], packet->result == MSP_RESULT_ERROR ? '!' : '>'};
-    uint8_t crcBuf[2];
-    uint8_t checksum;
+    uint8_t *data = sbufPtr(&packet->buf);
     int hdrLen = 3;
+
+    if (data != mspSerialOutBuf) {
+        // Pushed payloads live elsewhere
+        if (dataLen > MSP_PORT_OUTBUF_SIZE) {
+            return 0;
+        }
+        memcpy(mspSerialOutBuf, data, dataLen);
+        data = mspSerialOutBuf;
+    }
+
+    switch (mspVersion) {
+    case MSP_V1:
+        hdrLen += sizeof(mspHeaderV1_t) + (dataLen >= JUMBO_FRAME_SIZE_LIMIT ? sizeof(mspHeaderJUMBO_t) : 0);
+        break;
+    case MSP_V2_OVER_V1:
+        hdrLen += sizeof(mspHeaderV1_t) + sizeof(mspHeaderV2_t) + (sizeof(mspHeaderV2_t) + dataLen + 1 >= JUMBO_FRAME_SIZE_LIMIT ? sizeof(mspHeaderJUMBO_t) : 0);
+        break;
+    case MSP_V2_NATIVE:
+        hdrLen += sizeof(mspHeaderV2_t);
+        break;
+    default:
+        // Shouldn't get here
+        return 0;
+    }
+
+    uint8_t *hdrBuf = data - hdrLen;
+    uint8_t *crcBuf = data + dataLen;
     int crcLen = 0;
 
+    hdrBuf[0] = '$';
+    hdrBuf[1] = mspMagic[mspVersion];
+    hdrBuf[2] = packet->result == MSP_RESULT_ERROR ? '!' : '>';
+
     #define V1_CHECKSUM_STARTPOS 3
     if (mspVersion == MSP_V1) {
-        mspHeaderV1_t * hdrV1 = (mspHeaderV1_t *)&hdrBuf[hdrLen];
-        hdrLen += sizeof(mspHeaderV1_t);
+        mspHeaderV1_t * hdrV1 = (mspHeaderV1_t *)&hdrBuf[V1_CHECKSUM_STARTPOS];
         hdrV1->cmd = packet->cmd;
 
         // Add JUMBO-frame header if necessary
         if (dataLen >= JUMBO_FRAME_SIZE_LIMIT) {
-            mspHeaderJUMBO_t * hdrJUMBO = (mspHeaderJUMBO_t *)&hdrBuf[hdrLen];
-            hdrLen += sizeof(mspHeaderJUMBO_t);
+            mspHeaderJUMBO_t * hdrJUMBO = (mspHeaderJUMBO_t *)&hdrBuf[V1_CHECKSUM_STARTPOS + sizeof(mspHeaderV1_t)];
 
             hdrV1->size = JUMBO_FRAME_SIZE_LIMIT;
             hdrJUMBO->size = dataLen;
@@ -329,26 +442,20 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
             hdrV1->size = dataLen;
         }
 
-        // Pre-calculate CRC
-        checksum = mspSerialChecksumBuf(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS);
-        checksum = mspSerialChecksumBuf(checksum, sbufPtr(&packet->buf), dataLen);
-        crcBuf[crcLen++] = checksum;
+        // Headers and payload are contiguous, one pass covers both
+        crcBuf[crcLen] = mspSerialChecksumBuf(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS + dataLen);
+        crcLen++;
     }
     else if (mspVersion == MSP_V2_OVER_V1) {
-        mspHeaderV1_t * hdrV1 = (mspHeaderV1_t *)&hdrBuf[hdrLen];
-
-        hdrLen += sizeof(mspHeaderV1_t);
-
-        mspHeaderV2_t * hdrV2 = (mspHeaderV2_t *)&hdrBuf[hdrLen];
-        hdrLen += sizeof(mspHeaderV2_t);
+        mspHeaderV1_t * hdrV1 = (mspHeaderV1_t *)&hdrBuf[V1_CHECKSUM_STARTPOS];
+        mspHeaderV2_t * hdrV2 = (mspHeaderV2_t *)&hdrBuf[V1_CHECKSUM_STARTPOS + sizeof(mspHeaderV1_t)];
 
         const int v1PayloadSize = sizeof(mspHeaderV2_t) + dataLen + 1;  // MSPv2 header + data payload + MSPv2 checksum
         hdrV1->cmd = MSP_V2_FRAME_ID;
 
         // Add JUMBO-frame header if necessary
         if (v1PayloadSize >= JUMBO_FRAME_SIZE_LIMIT) {
-            mspHeaderJUMBO_t * hdrJUMBO = (mspHeaderJUMBO_t *)&hdrBuf[hdrLen];
-            hdrLen += sizeof(mspHeaderJUMBO_t);
+            mspHeaderJUMBO_t * hdrJUMBO = (mspHeaderJUMBO_t *)&hdrBuf[V1_CHECKSUM_STARTPOS + sizeof(mspHeaderV1_t) + sizeof(mspHeaderV2_t)];
 
             hdrV1->size = JUMBO_FRAME_SIZE_LIMIT;
             hdrJUMBO->size = v1PayloadSize;
@@ -363,43 +470,31 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
         hdrV2->size = dataLen;
 
         // V2 CRC: only V2 header + data payload
-        checksum = crc8_dvb_s2_update(0, (uint8_t *)hdrV2, sizeof(mspHeaderV2_t));
-        checksum = crc8_dvb_s2_update(checksum, sbufPtr(&packet->buf), dataLen);
-        crcBuf[crcLen++] = checksum;
+        uint8_t checksum = crc8_dvb_s2_update(0, (uint8_t *)hdrV2, sizeof(mspHeaderV2_t));
+        crcBuf[crcLen++] = crc8_dvb_s2_update(checksum, data, dataLen);
 
         // V1 CRC: All headers + data payload + V2 CRC byte
-        checksum = mspSerialChecksumBuf(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS);
-        checksum = mspSerialChecksumBuf(checksum, sbufPtr(&packet->buf), dataLen);
-        checksum = mspSerialChecksumBuf(checksum, crcBuf, crcLen);
-        crcBuf[crcLen++] = checksum;
+        crcBuf[crcLen] = mspSerialChecksumBuf(0, hdrBuf + V1_CHECKSUM_STARTPOS, hdrLen - V1_CHECKSUM_STARTPOS + dataLen + crcLen);
+        crcLen++;
     }
-    else if (mspVersion == MSP_V2_NATIVE) {
-        mspHeaderV2_t * hdrV2 = (mspHeaderV2_t *)&hdrBuf[hdrLen];
-        hdrLen += sizeof(mspHeaderV2_t);
+    else {
+        mspHeaderV2_t * hdrV2 = (mspHeaderV2_t *)&hdrBuf[V1_CHECKSUM_STARTPOS];
 
         hdrV2->flags = packet->flags;
         hdrV2->cmd = packet->cmd;
         hdrV2->size = dataLen;
 
-        checksum = crc8_dvb_s2_update(0, (uint8_t *)hdrV2, sizeof(mspHeaderV2_t));
-        checksum = crc8_dvb_s2_update(checksum, sbufPtr(&packet->buf), dataLen);
-        crcBuf[crcLen++] = checksum;
-    }
-    else {
-        // Shouldn't get here
-        return 0;
+        crcBuf[crcLen++] = crc8_dvb_s2_update(0, (uint8_t *)hdrV2, sizeof(mspHeaderV2_t) + dataLen);
     }
 
     // Send the frame
-    return mspSerialSendFrame(msp, hdrBuf, hdrLen, sbufPtr(&packet->buf), dataLen, crcBuf, crcLen);
+    return mspSerialSendFrame(msp, hdrBuf, hdrLen + dataLen + crcLen);
 }
 
 static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
 {
-    static uint8_t outBuf[MSP_PORT_OUTBUF_SIZE];
-
     mspPacket_t reply = {
-        .buf = { .ptr = outBuf, .end = ARRAYEND(outBuf), },
+        .buf = { .ptr = mspSerialOutBuf, .end = mspSerialOutBuf + MSP_PORT_OUTBUF_SIZE, },
         .cmd = -1,
         .flags = 0,
         .result = 0,
@@ -461,6 +556,12 @@ static void mspProcessPendingRequest(mspPort_t * mspPort)
 #endif
 #ifdef USE_CLI
     case MSP_PENDING_CLI:
+#ifdef USE_MSP_STREAM
+        mspPort->streamSubscriptionCount = 0;
+#endif
+#ifdef USE_MSP_DATAFLASH_STREAM
+        mspPort->transferEndAddress = mspPort->transferAddress;
+#endif
         cliEnter(mspPort->port);
         break;
 #endif
@@ -499,6 +600,17 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
             continue;
         }
 
+#ifdef USE_MSP_PIPELINE
+        mspSerialFlushPendingTx(mspPort);
+        if (mspSerialPendingTxLength(mspPort) > 0) {
+            // Let the client take the replies it has coming before we read more commands
+            continue;
+        }
+
+        const timeUs_t startTimeUs = micros();
+        int commandCount = 0;
+#endif
+
         mspPostProcessFnPtr mspPostProcessFn = NULL;
 
         if (serialRxBytesWaiting(mspPort->port)) {
@@ -506,27 +618,53 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
             mspPort->lastActivityMs = millis();
             mspPort->pendingRequest = MSP_PENDING_NONE;
 
-            while (serialRxBytesWaiting(mspPort->port)) {
-                const uint8_t c = serialRead(mspPort->port);
-                const bool consumed = mspSerialProcessReceivedData(mspPort, c);
+            // Parse straight out of the receive buffer, what has been parsed is consumed before anything else reads the port
+            const uint8_t *rxData;
+            uint32_t rxCount;
+            bool commandProcessed = false;
 
-                if (!consumed && evaluateNonMspData == MSP_EVALUATE_NON_MSP_DATA) {
-                    mspEvaluateNonMspData(mspPort, c);
-                }
+            while (!commandProcessed && (rxCount = serialPeekContiguous(mspPort->port, &rxData)) > 0) {
+                uint32_t rxUsed = 0;
 
-                if (mspPort->c_state == MSP_COMMAND_RECEIVED) {
-                    if (mspPort->packetType == MSP_PACKET_COMMAND) {
-                        mspPostProcessFn = mspSerialProcessReceivedCommand(mspPort, mspProcessCommandFn);
-                    } else if (mspPort->packetType == MSP_PACKET_REPLY) {
-                        mspSerialProcessReceivedReply(mspPort, mspProcessReplyFn);
+                while (rxUsed < rxCount) {
+                    const uint8_t c = rxData[rxUsed++];
+                    const bool consumed = mspSerialProcessReceivedData(mspPort, c);
+
+                    if (!consumed && evaluateNonMspData == MSP_EVALUATE_NON_MSP_DATA) {
+                        mspEvaluateNonMspData(mspPort, c);
                     }
 
-                    mspPort->c_state = MSP_IDLE;
-                    break; // process one command at a time so as not to block.
+                    if (mspPort->c_state == MSP_COMMAND_RECEIVED) {
+                        if (mspPort->packetType == MSP_PACKET_COMMAND) {
+                            mspPostProcessFn = mspSerialProcessReceivedCommand(mspPort, mspProcessCommandFn);
+                        } else if (mspPort->packetType == MSP_PACKET_REPLY) {
+                            mspSerialProcessReceivedReply(mspPort, mspProcessReplyFn);
+                        }
+
+                        mspPort->c_state = MSP_IDLE;
+
+#ifdef USE_MSP_PIPELINE
+                        // Carry on with the next queued command while there's time and the replies go straight out
+                        if (!mspPostProcessFn && mspSerialPendingTxLength(mspPort) == 0
+                            && ++commandCount < MSP_SERIAL_MAX_COMMANDS_PER_PASS
+                            && cmpTimeUs(micros(), startTimeUs) < MSP_SERIAL_PROCESS_BUDGET_US) {
+                            continue;
+                        }
+#endif
+                        commandProcessed = true;
+                        break; // process one command at a time so as not to block.
+                    }
                 }
+
+                serialSkip(mspPort->port, rxUsed);
             }
 
             if (mspPostProcessFn) {
+#ifdef USE_MSP_PIPELINE
+                serialWriteBuf(mspPort->port, &mspPort->pendingTx[mspPort->pendingTxStart], mspSerialPendingTxLength(mspPort));
+                mspPort->pendingTxStart = 0;
+                mspPort->pendingTxEnd = 0;
+#endif
                 waitForSerialPortToFinishTransmitting(mspPort->port);
                 mspPostProcessFn(mspPort->port);
             }
@@ -598,6 +736,13 @@ uint32_t mspSerialTxBytesFree(void)
             continue;
         }
 
+#ifdef USE_MSP_PIPELINE
+        // Anything sent now queues up behind the pending data
+        if (mspSerialPendingTxLength(mspPort) > 0) {
+            return 0;
+        }
+#endif
+
         const uint32_t bytesFree = serialTxBytesFree(mspPort->port);
         if (bytesFree < ret) {
             ret = bytesFree;
@@ -606,3 +751,259 @@ uint32_t mspSerialTxBytesFree(void)
 
     return ret;
 }
+
+#ifdef USE_MSP_STREAM
+// Leave this much room in the TX buffer for replies to requests, streamed messages wait until it's there
+#define MSP_STREAM_TX_RESERVE 32
+// The most frames one port may stream per pass, so a fast port can't hold up the others
+#define MSP_STREAM_MAX_FRAMES_PER_PASS 4
+
+/*
+ * Replace the set of messages pushed to the MSP port with the given descriptor.
+ *
+ * Returns false if the descriptor doesn't belong to a serial MSP port.
+ */
+bool mspSerialStreamSubscribe(mspDescriptor_t descriptor, const mspStreamSubscription_t *subscriptions, int count)
+{
+    if (count > MSP_STREAM_MAX_SUBSCRIPTIONS) {
+        return false;
+    }
+
+    for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
+        mspPort_t * const mspPort = &mspPorts[portIndex];
+        if (!mspPort->port || mspPort->descriptor != descriptor) {
+            continue;
+        }
+
+        const timeMs_t currentTimeMs = millis();
+        for (int i = 0; i < count; i++) {
+            mspPort->streamSubscriptions[i] = subscriptions[i];
+            mspPort->streamSubscriptions[i].nextDueMs = currentTimeMs;
+        }
+        mspPort->streamSubscriptionCount = count;
+        mspPort->streamNextIndex = 0;
+        // Stream in the same framing the client used to subscribe
+        mspPort->streamVersion = mspPort->mspVersion;
+
+        return true;
+    }
+
+    return false;
+}
+
+static void mspSerialStreamRemove(mspPort_t *mspPort, int index)
+{
+    mspPort->streamSubscriptionCount--;
+    memmove(&mspPort->streamSubscriptions[index], &mspPort->streamSubscriptions[index + 1], (mspPort->streamSubscriptionCount - index) * sizeof(mspStreamSubscription_t));
+}
+
+static void mspSerialStreamPort(mspPort_t *mspPort, mspProcessCommandFnPtr mspProcessStreamCommandFn, timeMs_t currentTimeMs)
+{
+    int framesSent = 0;
+    int checked = 0;
+
+    while (checked < mspPort->streamSubscriptionCount && framesSent < MSP_STREAM_MAX_FRAMES_PER_PASS) {
+        if (mspPort->streamNextIndex >= mspPort->streamSubscriptionCount) {
+            mspPort->streamNextIndex = 0;
+        }
+
+        mspStreamSubscription_t *subscription = &mspPort->streamSubscriptions[mspPort->streamNextIndex];
+
+        if (cmp32(currentTimeMs, subscription->nextDueMs) < 0) {
+            mspPort->streamNextIndex++;
+            checked++;
+            continue;
+        }
+
+        mspPacket_t reply = {
+            .buf = { .ptr = mspSerialOutBuf, .end = mspSerialOutBuf + MSP_PORT_OUTBUF_SIZE, },
+            .cmd = -1,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REPLY,
+        };
+        mspPacket_t command = {
+            .buf = { .ptr = NULL, .end = NULL, },
+            .cmd = subscription->cmd,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REQUEST,
+        };
+        mspPostProcessFnPtr mspPostProcessFn = NULL;
+
+        if (mspProcessStreamCommandFn(mspPort->descriptor, &command, &reply, &mspPostProcessFn) != MSP_RESULT_ACK) {
+            // Not something we can stream
+            mspSerialStreamRemove(mspPort, mspPort->streamNextIndex);
+            continue;
+        }
+
+        sbufSwitchToReader(&reply.buf, mspSerialOutBuf);
+
+        const int frameLength = sbufBytesRemaining(&reply.buf) + mspSerialFrameOverhead(mspPort->streamVersion, sbufBytesRemaining(&reply.buf));
+        const bool txEmpty = isSerialTransmitBufferEmpty(mspPort->port);
+
+        if (frameLength + (txEmpty ? 0 : MSP_STREAM_TX_RESERVE) > (int)serialTxBytesFree(mspPort->port)) {
+            if (!txEmpty) {
+                // The client isn't keeping up, this message goes first when there is room again
+                return;
+            }
+
+            // It will never fit in this port's TX buffer
+            mspSerialStreamRemove(mspPort, mspPort->streamNextIndex);
+            continue;
+        }
+
+        mspSerialEncode(mspPort, &reply, mspPort->streamVersion);
+        framesSent++;
+
+        // Keep to the interval on average, but don't try to catch up on messages we missed
+        subscription->nextDueMs += subscription->intervalMs;
+        if (cmp32(currentTimeMs, subscription->nextDueMs) >= 0) {
+            subscription->nextDueMs = currentTimeMs + subscription->intervalMs;
+        }
+
+        mspPort->streamNextIndex++;
+        checked++;
+    }
+}
+
+#ifdef USE_MSP_DATAFLASH_STREAM
+// Transfers may fill the TX buffer, but must not hold the task up for long when the port drains quickly
+#define MSP_STREAM_TRANSFER_MAX_FRAMES_PER_PASS 16
+// No further chunk is started once a pass has taken this long
+#define MSP_STREAM_TRANSFER_MAX_US_PER_PASS     300
+
+/*
+ * Send length bytes starting at address to the MSP port with the given descriptor, as consecutive cmd messages of up to
+ * chunkSize bytes each. A length of 0 stops the transfer running on the port.
+ *
+ * Returns false if the descriptor doesn't belong to a serial MSP port.
+ */
+bool mspSerialStreamTransferStart(mspDescriptor_t descriptor, uint16_t cmd, uint32_t address, uint32_t length, uint16_t chunkSize)
+{
+    for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
+        mspPort_t * const mspPort = &mspPorts[portIndex];
+        if (!mspPort->port || mspPort->descriptor != descriptor) {
+            continue;
+        }
+
+        mspPort->transferCmd = cmd;
+        mspPort->transferChunkSize = constrain(chunkSize, MSP_STREAM_TRANSFER_MIN_CHUNK_SIZE, MSP_STREAM_TRANSFER_MAX_CHUNK_SIZE);
+        mspPort->transferSeq = 0;
+        mspPort->transferAddress = address;
+        mspPort->transferEndAddress = address + length;
+        mspPort->streamVersion = mspPort->mspVersion;
+
+        return true;
+    }
+
+    return false;
+}
+
+static bool mspSerialStreamTransferActive(const mspPort_t *mspPort)
+{
+    return mspPort->transferAddress < mspPort->transferEndAddress;
+}
+
+/*
+ * The chunk messages are asked for with the sequence number, address and size of the chunk. Their reply carries at
+ * most MSP_PORT_DATAFLASH_INFO_SIZE bytes besides the data.
+ */
+static void mspSerialStreamTransfer(mspPort_t *mspPort, mspProcessCommandFnPtr mspProcessStreamCommandFn)
+{
+    const timeUs_t startUs = micros();
+    int framesSent = 0;
+
+    while (mspSerialStreamTransferActive(mspPort) && framesSent < MSP_STREAM_TRANSFER_MAX_FRAMES_PER_PASS
+        && cmpTimeUs(micros(), startUs) < MSP_STREAM_TRANSFER_MAX_US_PER_PASS) {
+        const uint16_t chunkSize = MIN(mspPort->transferChunkSize, mspPort->transferEndAddress - mspPort->transferAddress);
+        const int replyLength = chunkSize + MSP_PORT_DATAFLASH_INFO_SIZE;
+        const int frameLength = replyLength + mspSerialFrameOverhead(mspPort->streamVersion, replyLength);
+        const bool txEmpty = isSerialTransmitBufferEmpty(mspPort->port);
+
+        if (frameLength + (txEmpty ? 0 : MSP_STREAM_TX_RESERVE) > (int)serialTxBytesFree(mspPort->port)) {
+            if (!txEmpty || mspPort->transferChunkSize <= MSP_STREAM_TRANSFER_MIN_CHUNK_SIZE) {
+                return;
+            }
+
+            // It will never fit in this port's TX buffer
+            mspPort->transferChunkSize = MAX(mspPort->transferChunkSize / 2, MSP_STREAM_TRANSFER_MIN_CHUNK_SIZE);
+            continue;
+        }
+
+        uint8_t requestBuf[sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint16_t)];
+        sbuf_t request;
+        sbufInit(&request, requestBuf, ARRAYEND(requestBuf));
+        sbufWriteU16(&request, mspPort->transferSeq);
+        sbufWriteU32(&request, mspPort->transferAddress);
+        sbufWriteU16(&request, chunkSize);
+        sbufSwitchToReader(&request, requestBuf);
+
+        mspPacket_t reply = {
+            .buf = { .ptr = mspSerialOutBuf, .end = mspSerialOutBuf + MSP_PORT_OUTBUF_SIZE, },
+            .cmd = -1,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REPLY,
+        };
+        mspPacket_t command = {
+            .buf = request,
+            .cmd = mspPort->transferCmd,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REQUEST,
+        };
+        mspPostProcessFnPtr mspPostProcessFn = NULL;
+
+        if (mspProcessStreamCommandFn(mspPort->descriptor, &command, &reply, &mspPostProcessFn) != MSP_RESULT_ACK) {
+            // Nothing more to send
+            mspPort->transferEndAddress = mspPort->transferAddress;
+            return;
+        }
+
+        sbufSwitchToReader(&reply.buf, mspSerialOutBuf);
+        mspSerialEncode(mspPort, &reply, mspPort->streamVersion);
+        framesSent++;
+
+        mspPort->transferAddress += chunkSize;
+        mspPort->transferSeq++;
+    }
+}
+#endif
+
+/*
+ * Push the messages that MSP clients have subscribed to, and any transfers they asked for, as far as their TX buffers
+ * allow.
+ *
+ * Called periodically by the scheduler.
+ */
+void mspSerialStreamProcess(mspProcessCommandFnPtr mspProcessStreamCommandFn)
+{
+    const timeMs_t currentTimeMs = millis();
+
+    for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
+        mspPort_t * const mspPort = &mspPorts[portIndex];
+        if (!mspPort->port) {
+            continue;
+        }
+
+#ifdef USE_MSP_PIPELINE
+        // Replies to requests go first
+        if (mspSerialPendingTxLength(mspPort) > 0) {
+            continue;
+        }
+#endif
+
+        if (mspPort->streamSubscriptionCount) {
+            mspSerialStreamPort(mspPort, mspProcessStreamCommandFn, currentTimeMs);
+        }
+
+#ifdef USE_MSP_DATAFLASH_STREAM
+        // Transfers take whatever bandwidth the subscriptions leave
+        if (mspSerialStreamTransferActive(mspPort)) {
+            mspSerialStreamTransfer(mspPort, mspProcessStreamCommandFn);
+        }
+#endif
+    }
+}
+#endif
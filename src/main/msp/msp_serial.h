@@ -97,6 +97,29 @@ typedef struct __attribute__((packed)) {
 
 #define MSP_MAX_HEADER_SIZE     9
 
+#ifdef USE_MSP_PIPELINE
+// Room for replies that don't fit in the serial port's TX buffer straight away
+#define MSP_PORT_PENDING_TX_SIZE 256
+#endif
+
+#ifdef USE_MSP_STREAM
+#define MSP_STREAM_MAX_SUBSCRIPTIONS 8
+#define MSP_STREAM_MIN_INTERVAL_MS   10
+
+typedef struct mspStreamSubscription_s {
+    uint16_t cmd;
+    uint16_t intervalMs;
+    timeMs_t nextDueMs;
+} mspStreamSubscription_t;
+#endif
+
+#ifdef USE_MSP_DATAFLASH_STREAM
+// Transfers shrink their chunks until they fit in the port's TX buffer, but no further than this
+#define MSP_STREAM_TRANSFER_MIN_CHUNK_SIZE 16
+// Each chunk is a blocking read of the dataflash from a scheduler task, about 200us at 20MHz SPI
+#define MSP_STREAM_TRANSFER_MAX_CHUNK_SIZE 512
+#endif
+
 struct serialPort_s;
 typedef struct mspPort_s {
     struct serialPort_s *port; // null when port unused.
@@ -114,6 +137,26 @@ typedef struct mspPort_s {
     uint8_t checksum2;
     bool sharedWithTelemetry;
     mspDescriptor_t descriptor;
+#ifdef USE_MSP_PIPELINE
+    // Frames waiting for space in the TX buffer, they go out before anything else sent to this port
+    uint8_t pendingTx[MSP_PORT_PENDING_TX_SIZE];
+    uint16_t pendingTxStart;
+    uint16_t pendingTxEnd;
+#endif
+#ifdef USE_MSP_STREAM
+    mspStreamSubscription_t streamSubscriptions[MSP_STREAM_MAX_SUBSCRIPTIONS];
+    uint8_t streamSubscriptionCount;
+    uint8_t streamNextIndex;    // Round robin position, so a busy port doesn't always starve the same messages
+    mspVersion_e streamVersion;
+#endif
+#ifdef USE_MSP_DATAFLASH_STREAM
+    // A range of data sent as consecutive chunks, as fast as the TX buffer empties
+    uint16_t transferCmd;
+    uint16_t transferChunkSize;
+    uint16_t transferSeq;
+    uint32_t transferAddress;
+    uint32_t transferEndAddress;
+#endif
 } mspPort_t;
 
 void mspSerialInit(void);
@@ -124,3 +167,10 @@ void mspSerialReleasePortIfAllocated(struct serialPort_s *serialPort);
 void mspSerialReleaseSharedTelemetryPorts(void);
 int mspSerialPush(serialPortIdentifier_e port, uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction);
 uint32_t mspSerialTxBytesFree(void);
+#ifdef USE_MSP_STREAM
+bool mspSerialStreamSubscribe(mspDescriptor_t descriptor, const mspStreamSubscription_t *subscriptions, int count);
+void mspSerialStreamProcess(mspProcessCommandFnPtr mspProcessStreamCommandFn);
+#endif
+#ifdef USE_MSP_DATAFLASH_STREAM
+bool mspSerialStreamTransferStart(mspDescriptor_t descriptor, uint16_t cmd, uint32_t address, uint32_t length, uint16_t chunkSize);
+#endif
@@ -115,6 +115,20 @@ static statistic_t stats;
 timeUs_t resumeRefreshAt = 0;
 #define REFRESH_1S    1000 * 1000
 
+#define OSD_TASK_PERIOD_US (1000000 / 60)
+
+// redraw values in buffer every DRAW_FREQ_DENOM OSD task periods
+#ifdef USE_MAX7456
+#define DRAW_FREQ_DENOM 5
+#else
+#define DRAW_FREQ_DENOM 10 // MWOSD @ 115200 baud (
+#endif
+
+#ifdef USE_OSD_FRAME_SYNC
+static timeUs_t osdNextRefreshUs = 0;
+static bool osdCommitPending = false;   // the display holds changes for the next commit window
+#endif
+
 static uint8_t armState;
 #ifdef USE_OSD_PROFILES
 static uint8_t osdProfile = 1;
@@ -222,7 +236,9 @@ void changeOsdProfileIndex(uint8_t profileIndex)
     if (profileIndex <= OSD_PROFILE_COUNT) {
         osdConfigMutable()->osdProfileIndex = profileIndex;
         setOsdProfile(profileIndex);
-        osdAnalyzeActiveElements();
+        // the layouts of all profiles are already compiled
+        osdSelectActiveElementsProfile(profileIndex);
+        osdDrawActiveElementsBackground(osdDisplayPort);
     }
 }
 #endif
@@ -913,6 +929,28 @@ STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs)
     }
 }
 
+#ifdef USE_OSD_FRAME_SYNC
+/*
+ * A frame synchronised display only writes its changes in the vertical blanking interval. The OSD
+ * task then runs when the values are due to be redrawn and when the display can take the changes,
+ * rather than periodically.
+ */
+bool osdUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    const timeDelta_t commitDelayUs = displayCommitDelay(osdDisplayPort, currentTimeUs);
+
+    if (commitDelayUs == DISPLAYPORT_NOT_FRAME_SYNCED) {
+        return currentDeltaTimeUs >= OSD_TASK_PERIOD_US;
+    }
+
+    if (cmpTimeUs(currentTimeUs, osdNextRefreshUs) >= 0) {
+        return true;
+    }
+
+    return commitDelayUs == 0 && osdCommitPending;
+}
+#endif
+
 /*
  * Called periodically by the scheduler
  */
@@ -931,6 +969,21 @@ void osdUpdate(timeUs_t currentTimeUs)
     }
 #endif // MAX7456_DMA_CHANNEL_TX
 
+#ifdef USE_OSD_FRAME_SYNC
+    if (displayCommitDelay(osdDisplayPort, currentTimeUs) != DISPLAYPORT_NOT_FRAME_SYNCED) {
+        if (cmpTimeUs(currentTimeUs, osdNextRefreshUs) >= 0) {
+            osdNextRefreshUs = currentTimeUs + DRAW_FREQ_DENOM * OSD_TASK_PERIOD_US;
+            osdRefresh(currentTimeUs);
+            showVisualBeeper = false;
+        }
+        // writes nothing outside the vertical blanking interval
+        displayDrawScreen(osdDisplayPort);
+        // asked once per run rather than on every scheduler pass, other writers are picked up at the next refresh
+        osdCommitPending = !displayIsSynced(osdDisplayPort);
+        return;
+    }
+#endif
+
 #ifdef USE_SLOW_MSP_DISPLAYPORT_RATE_WHEN_UNARMED
     static uint32_t idlecounter = 0;
     if (!ARMING_FLAG(ARMED)) {
@@ -940,13 +993,6 @@ void osdUpdate(timeUs_t currentTimeUs)
     }
 #endif
 
-    // redraw values in buffer
-#ifdef USE_MAX7456
-#define DRAW_FREQ_DENOM 5
-#else
-#define DRAW_FREQ_DENOM 10 // MWOSD @ 115200 baud (
-#endif
-
     if (counter % DRAW_FREQ_DENOM == 0) {
         osdRefresh(currentTimeUs);
         showVisualBeeper = false;
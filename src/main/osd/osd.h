@@ -304,6 +304,7 @@ extern escSensorData_t *osdEscDataCombined;
 struct displayPort_s;
 void osdInit(struct displayPort_s *osdDisplayPort);
 bool osdInitialized(void);
+bool osdUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 void osdUpdate(timeUs_t currentTimeUs);
 void osdStatSetState(uint8_t statIndex, bool enabled);
 bool osdStatGetState(uint8_t statIndex);
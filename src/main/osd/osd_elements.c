@@ -51,6 +51,14 @@
     Add the mapping for the element ID to the background drawing function to the
     osdElementBackgroundFunction array.
 
+    Choose how often the element is re-rendered.
+    --------------------------------------------
+    Elements are re-rendered on every OSD refresh unless a slower class is given
+    in the osdElementRefreshClass array. If the element's text only depends on a
+    single runtime value, add a function returning that value to the
+    osdElementValueFunction array so it's only re-rendered when the value changes.
+    In between the last rendered text is redrawn from a cache.
+
     Accelerometer reqirement:
     -------------------------
     If the new element utilizes the accelerometer, add it to the osdElementsNeedAccelerometer() function.
@@ -77,7 +85,6 @@
 
 #include "common/axis.h"
 #include "common/maths.h"
-#include "common/printf.h"
 #include "common/typeconversion.h"
 #include "common/utils.h"
 
@@ -167,8 +174,21 @@ static const char compassBar[] = {
   SYM_HEADING_LINE, SYM_HEADING_DIVIDED_LINE, SYM_HEADING_LINE
 };
 
-static unsigned activeOsdElementCount = 0;
-static uint8_t activeOsdElementArray[OSD_ITEM_COUNT];
+// An element of a compiled layout, its position decoded from the config
+typedef struct osdLayoutElement_s {
+    uint8_t item;
+    uint8_t posX;
+    uint8_t posY;
+} osdLayoutElement_t;
+
+typedef struct osdLayout_s {
+    uint8_t count;
+    osdLayoutElement_t elements[OSD_ITEM_COUNT];
+} osdLayout_t;
+
+// The active elements of every OSD profile, in drawing order
+static osdLayout_t osdLayouts[OSD_PROFILE_COUNT];
+static const osdLayout_t *activeLayout = &osdLayouts[0];
 static bool backgroundLayerSupported = false;
 
 // Blink control
@@ -209,8 +229,7 @@ static void renderOsdEscRpmOrFreq(getEscRpmOrFreqFnPtr escFnPtr, osdElementParms
     for (int i=0; i < getMotorCount(); i++) {
         char rpmStr[6];
         const int rpm = MIN((*escFnPtr)(i),99999);
-        const int len = tfp_sprintf(rpmStr, "%d", rpm);
-        rpmStr[len] = '\0';
+        formatInt(rpmStr, rpm, 0, ' ');
         displayWrite(element->osdDisplayPort, x, y + i, rpmStr);
     }
     element->drawElement = false;
@@ -233,12 +252,9 @@ static void osdFormatAltitudeString(char * buff, int32_t altitudeCm)
 {
     const int alt = osdGetMetersToSelectedUnit(altitudeCm) / 10;
 
-    int pos = 0;
-    buff[pos++] = SYM_ALTITUDE;
-    if (alt < 0) {
-        buff[pos++] = '-';
-    }
-    tfp_sprintf(buff + pos, "%01d.%01d%c", abs(alt) / 10 , abs(alt) % 10, osdGetMetersToSelectedUnitSymbol());
+    buff = formatChar(buff, SYM_ALTITUDE);
+    buff = formatFixed(buff, alt, 1, 0);
+    formatChar(buff, osdGetMetersToSelectedUnitSymbol());
 }
 
 #ifdef USE_GPS
@@ -249,13 +265,8 @@ static void osdFormatCoordinate(char *buff, char sym, int32_t val)
     // We show 7 decimals, so we need to use 12 characters:
     // eg: s-180.1234567z   s=symbol, z=zero terminator, decimal separator  between 0 and 1
 
-    int pos = 0;
-    buff[pos++] = sym;
-    if (val < 0) {
-        buff[pos++] = '-';
-        val = -val;
-    }
-    tfp_sprintf(buff + pos, "%d.%07d", val / GPS_DEGREES_DIVIDER, val % GPS_DEGREES_DIVIDER);
+    buff = formatChar(buff, sym);
+    formatFixed(buff, val, 7, 0);
 }
 #endif // USE_GPS
 
@@ -283,20 +294,28 @@ void osdFormatDistanceString(char *ptr, int distance, char leadingSymbol)
     }
 
     if (convertedDistance < unitTransition) {
-        tfp_sprintf(ptr, "%d%c", convertedDistance, unitSymbol);
+        ptr = formatInt(ptr, convertedDistance, 0, ' ');
+        formatChar(ptr, unitSymbol);
     } else {
         const int displayDistance = convertedDistance * 100 / unitTransition;
         if (displayDistance >= 1000) { // >= 10 miles or km - 1 decimal place
-            tfp_sprintf(ptr, "%d.%d%c", displayDistance / 100, (displayDistance / 10) % 10, unitSymbolExtended);
+            ptr = formatFixed(ptr, displayDistance / 10, 1, 0);
         } else {                     // < 10 miles or km - 2 decimal places
-            tfp_sprintf(ptr, "%d.%02d%c", displayDistance / 100, displayDistance % 100, unitSymbolExtended);
+            ptr = formatFixed(ptr, displayDistance, 2, 0);
         }
+        formatChar(ptr, unitSymbolExtended);
     }
 }
 
 static void osdFormatPID(char * buff, const char * label, const pidf_t * pid)
 {
-    tfp_sprintf(buff, "%s %3d %3d %3d", label, pid->P, pid->I, pid->D);
+    buff = formatString(buff, label);
+    buff = formatChar(buff, ' ');
+    buff = formatInt(buff, pid->P, 3, ' ');
+    buff = formatChar(buff, ' ');
+    buff = formatInt(buff, pid->I, 3, ' ');
+    buff = formatChar(buff, ' ');
+    formatInt(buff, pid->D, 3, ' ');
 }
 
 #ifdef USE_RTC_TIME
@@ -317,25 +336,24 @@ bool osdFormatRtcDateTime(char *buffer)
 
 void osdFormatTime(char * buff, osd_timer_precision_e precision, timeUs_t time)
 {
-    int seconds = time / 1000000;
-    const int minutes = seconds / 60;
-    seconds = seconds % 60;
+    buff = formatMinutesSeconds(buff, time / 1000000);
 
     switch (precision) {
     case OSD_TIMER_PREC_SECOND:
     default:
-        tfp_sprintf(buff, "%02d:%02d", minutes, seconds);
         break;
     case OSD_TIMER_PREC_HUNDREDTHS:
         {
             const int hundredths = (time / 10000) % 100;
-            tfp_sprintf(buff, "%02d:%02d.%02d", minutes, seconds, hundredths);
+            buff = formatChar(buff, '.');
+            formatUnsigned(buff, hundredths, 2, '0');
             break;
         }
     case OSD_TIMER_PREC_TENTHS:
         {
             const int tenths = (time / 100000) % 10;
-            tfp_sprintf(buff, "%02d:%02d.%01d", minutes, seconds, tenths);
+            buff = formatChar(buff, '.');
+            formatUnsigned(buff, tenths, 1, '0');
             break;
         }
     }
@@ -510,7 +528,9 @@ static void osdElementAdjustmentRange(osdElementParms_t *element)
 {
     const char *name = getAdjustmentsRangeName();
     if (name) {
-        tfp_sprintf(element->buff, "%s: %3d", name, getAdjustmentsRangeValue());
+        char *p = formatString(element->buff, name);
+        p = formatString(p, ": ");
+        formatInt(p, getAdjustmentsRangeValue(), 3, ' ');
     }
 }
 #endif // USE_OSD_ADJUSTMENTS
@@ -538,7 +558,11 @@ static void osdElementAltitude(osdElementParms_t *element)
 static void osdElementAngleRollPitch(osdElementParms_t *element)
 {
     const int angle = (element->item == OSD_PITCH_ANGLE) ? attitude.values.pitch : attitude.values.roll;
-    tfp_sprintf(element->buff, "%c%c%02d.%01d", (element->item == OSD_PITCH_ANGLE) ? SYM_PITCH : SYM_ROLL , angle < 0 ? '-' : ' ', abs(angle / 10), abs(angle % 10));
+    char *p = formatChar(element->buff, (element->item == OSD_PITCH_ANGLE) ? SYM_PITCH : SYM_ROLL);
+    p = formatChar(p, angle < 0 ? '-' : ' ');
+    p = formatUnsigned(p, abs(angle) / 10, 2, '0');
+    p = formatChar(p, '.');
+    formatUnsigned(p, abs(angle) % 10, 1, '0');
 }
 #endif
 
@@ -579,8 +603,9 @@ static void osdElementArtificialHorizon(osdElementParms_t *element)
 static void osdElementAverageCellVoltage(osdElementParms_t *element)
 {
     const int cellV = getBatteryAverageCellVoltage();
-    element->buff[0] = osdGetBatterySymbol(cellV);
-    tfp_sprintf(element->buff + 1, "%d.%02d%c", cellV / 100, cellV % 100, SYM_VOLT);
+    char *p = formatChar(element->buff, osdGetBatterySymbol(cellV));
+    p = formatFixed(p, cellV, 2, 0);
+    formatChar(p, SYM_VOLT);
 }
 
 static void osdElementCompassBar(osdElementParms_t *element)
@@ -592,7 +617,10 @@ static void osdElementCompassBar(osdElementParms_t *element)
 #ifdef USE_ADC_INTERNAL
 static void osdElementCoreTemperature(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "C%c%3d%c", SYM_TEMPERATURE, osdConvertTemperatureToSelectedUnit(getCoreTemperatureCelsius()), osdGetTemperatureSymbolForSelectedUnit());
+    char *p = formatChar(element->buff, 'C');
+    p = formatChar(p, SYM_TEMPERATURE);
+    p = formatInt(p, osdConvertTemperatureToSelectedUnit(getCoreTemperatureCelsius()), 3, ' ');
+    formatChar(p, osdGetTemperatureSymbolForSelectedUnit());
 }
 #endif // USE_ADC_INTERNAL
 
@@ -668,18 +696,23 @@ static void osdBackgroundCrosshairs(osdElementParms_t *element)
 static void osdElementCurrentDraw(osdElementParms_t *element)
 {
     const int32_t amperage = getAmperage();
-    tfp_sprintf(element->buff, "%3d.%02d%c", abs(amperage) / 100, abs(amperage) % 100, SYM_AMP);
+    char *p = formatFixed(element->buff, abs(amperage), 2, 6);
+    formatChar(p, SYM_AMP);
 }
 
 static void osdElementDebug(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "DBG %5d %5d %5d %5d", debug[0], debug[1], debug[2], debug[3]);
+    char *p = formatString(element->buff, "DBG");
+    for (int i = 0; i < 4; i++) {
+        p = formatChar(p, ' ');
+        p = formatInt(p, debug[i], 5, ' ');
+    }
 }
 
 static void osdElementDisarmed(osdElementParms_t *element)
 {
     if (!ARMING_FLAG(ARMED)) {
-        tfp_sprintf(element->buff, "DISARMED");
+        strcpy(element->buff, "DISARMED");
     }
 }
 
@@ -704,7 +737,7 @@ static void osdBackgroundDisplayName(osdElementParms_t *element)
 static void osdElementRateProfileName(osdElementParms_t *element)
 {
     if (strlen(currentControlRateProfile->profileName) == 0) {
-        tfp_sprintf(element->buff, "RATE_%u", getCurrentControlRateProfileIndex() + 1);
+        formatUnsigned(formatString(element->buff, "RATE_"), getCurrentControlRateProfileIndex() + 1, 0, ' ');
     } else {
         unsigned i;
         for (i = 0; i < MAX_PROFILE_NAME_LENGTH; i++) {
@@ -721,7 +754,7 @@ static void osdElementRateProfileName(osdElementParms_t *element)
 static void osdElementPidProfileName(osdElementParms_t *element)
 {
     if (strlen(currentPidProfile->profileName) == 0) {
-        tfp_sprintf(element->buff, "PID_%u", getCurrentPidProfileIndex() + 1);
+        formatUnsigned(formatString(element->buff, "PID_"), getCurrentPidProfileIndex() + 1, 0, ' ');
     } else {
         unsigned i;
         for (i = 0; i < MAX_PROFILE_NAME_LENGTH; i++) {
@@ -742,7 +775,7 @@ static void osdElementOsdProfileName(osdElementParms_t *element)
     uint8_t profileIndex = getCurrentOsdProfileIndex();
 
     if (strlen(osdConfig()->profile[profileIndex - 1]) == 0) {
-        tfp_sprintf(element->buff, "OSD_%u", profileIndex);
+        formatUnsigned(formatString(element->buff, "OSD_"), profileIndex, 0, ' ');
     } else {
         unsigned i;
         for (i = 0; i < OSD_PROFILE_NAME_LENGTH; i++) {
@@ -761,7 +794,10 @@ static void osdElementOsdProfileName(osdElementParms_t *element)
 static void osdElementEscTemperature(osdElementParms_t *element)
 {
     if (featureIsEnabled(FEATURE_ESC_SENSOR)) {
-        tfp_sprintf(element->buff, "E%c%3d%c", SYM_TEMPERATURE, osdConvertTemperatureToSelectedUnit(osdEscDataCombined->temperature), osdGetTemperatureSymbolForSelectedUnit());
+        char *p = formatChar(element->buff, 'E');
+        p = formatChar(p, SYM_TEMPERATURE);
+        p = formatInt(p, osdConvertTemperatureToSelectedUnit(osdEscDataCombined->temperature), 3, ' ');
+        formatChar(p, osdGetTemperatureSymbolForSelectedUnit());
     }
 }
 #endif // USE_ESC_SENSOR
@@ -810,7 +846,8 @@ static void osdElementFlymode(osdElementParms_t *element)
 static void osdElementGForce(osdElementParms_t *element)
 {
     const int gForce = lrintf(osdGForce * 10);
-    tfp_sprintf(element->buff, "%01d.%01dG", gForce / 10, gForce % 10);
+    char *p = formatFixed(element->buff, gForce, 1, 0);
+    formatChar(p, 'G');
 }
 #endif // USE_ACC
 
@@ -821,7 +858,9 @@ static void osdElementGpsFlightDistance(osdElementParms_t *element)
         osdFormatDistanceString(element->buff, GPS_distanceFlownInCm / 100, SYM_TOTAL_DISTANCE);
     } else {
         // We use this symbol when we don't have a FIX
-        tfp_sprintf(element->buff, "%c%c", SYM_TOTAL_DISTANCE, SYM_HYPHEN);
+        element->buff[0] = SYM_TOTAL_DISTANCE;
+        element->buff[1] = SYM_HYPHEN;
+        element->buff[2] = '\0';
     }
 }
 
@@ -867,16 +906,20 @@ static void osdElementGpsLongitude(osdElementParms_t *element)
 
 static void osdElementGpsSats(osdElementParms_t *element)
 {
+    char *p = formatChar(element->buff, SYM_SAT_L);
+    p = formatChar(p, SYM_SAT_R);
+    p = formatUnsigned(p, gpsSol.numSat, 2, ' ');
     if (osdConfig()->gps_sats_show_hdop) {
-        tfp_sprintf(element->buff, "%c%c%2d %d.%d", SYM_SAT_L, SYM_SAT_R, gpsSol.numSat, gpsSol.hdop / 100, (gpsSol.hdop / 10) % 10);
-    } else {
-        tfp_sprintf(element->buff, "%c%c%2d", SYM_SAT_L, SYM_SAT_R, gpsSol.numSat);
+        p = formatChar(p, ' ');
+        formatFixed(p, gpsSol.hdop / 10, 1, 0);
     }
 }
 
 static void osdElementGpsSpeed(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%c%3d%c", SYM_SPEED, osdGetSpeedToSelectedUnit(gpsConfig()->gps_use_3d_speed ? gpsSol.speed3d : gpsSol.groundSpeed), osdGetSpeedToSelectedUnitSymbol());
+    char *p = formatChar(element->buff, SYM_SPEED);
+    p = formatInt(p, osdGetSpeedToSelectedUnit(gpsConfig()->gps_use_3d_speed ? gpsSol.speed3d : gpsSol.groundSpeed), 3, ' ');
+    formatChar(p, osdGetSpeedToSelectedUnitSymbol());
 }
 #endif // USE_GPS
 
@@ -903,13 +946,13 @@ static void osdElementLinkQuality(osdElementParms_t *element)
     uint16_t osdLinkQuality = 0;
     if (linkQualitySource == LQ_SOURCE_RX_PROTOCOL_CRSF) { // 0-300
         osdLinkQuality = rxGetLinkQuality()  / 3.41;
-        tfp_sprintf(element->buff, "%c%3d", SYM_LINK_QUALITY, osdLinkQuality);
+        formatUnsigned(formatChar(element->buff, SYM_LINK_QUALITY), osdLinkQuality, 3, ' ');
     } else { // 0-9
         osdLinkQuality = rxGetLinkQuality() * 10 / LINK_QUALITY_MAX_VALUE;
         if (osdLinkQuality >= 10) {
             osdLinkQuality = 9;
         }
-        tfp_sprintf(element->buff, "%c%1d", SYM_LINK_QUALITY, osdLinkQuality);
+        formatUnsigned(formatChar(element->buff, SYM_LINK_QUALITY), osdLinkQuality, 1, ' ');
     }
 }
 #endif // USE_RX_LINK_QUALITY_INFO
@@ -918,16 +961,15 @@ static void osdElementLinkQuality(osdElementParms_t *element)
 static void osdElementLogStatus(osdElementParms_t *element)
 {
     if (IS_RC_MODE_ACTIVE(BOXBLACKBOX)) {
+        char *p = formatChar(element->buff, SYM_BBLOG);
         if (!isBlackboxDeviceWorking()) {
-            tfp_sprintf(element->buff, "%c!", SYM_BBLOG);
+            formatChar(p, '!');
         } else if (isBlackboxDeviceFull()) {
-            tfp_sprintf(element->buff, "%c>", SYM_BBLOG);
+            formatChar(p, '>');
         } else {
             int32_t logNumber = blackboxGetLogNumber();
             if (logNumber >= 0) {
-                tfp_sprintf(element->buff, "%c%d", SYM_BBLOG, logNumber);
-            } else {
-                tfp_sprintf(element->buff, "%c", SYM_BBLOG);
+                formatInt(p, logNumber, 0, ' ');
             }
         }
     }
@@ -936,7 +978,8 @@ static void osdElementLogStatus(osdElementParms_t *element)
 
 static void osdElementMahDrawn(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%4d%c", getMAhDrawn(), SYM_MAH);
+    char *p = formatInt(element->buff, getMAhDrawn(), 4, ' ');
+    formatChar(p, SYM_MAH);
 }
 
 static void osdElementMainBatteryUsage(osdElementParms_t *element)
@@ -966,12 +1009,12 @@ static void osdElementMainBatteryVoltage(osdElementParms_t *element)
 {
     const int batteryVoltage = (getBatteryVoltage() + 5) / 10;
 
-    element->buff[0] = osdGetBatterySymbol(getBatteryAverageCellVoltage());
-    if (batteryVoltage >= 100) {
-        tfp_sprintf(element->buff + 1, "%d.%d%c", batteryVoltage / 10, batteryVoltage % 10, SYM_VOLT);
-    } else {
-        tfp_sprintf(element->buff + 1, "%d.%d0%c", batteryVoltage / 10, batteryVoltage % 10, SYM_VOLT);
+    char *p = formatChar(element->buff, osdGetBatterySymbol(getBatteryAverageCellVoltage()));
+    p = formatFixed(p, batteryVoltage, 1, 0);
+    if (batteryVoltage < 100) {
+        p = formatChar(p, '0');
     }
+    formatChar(p, SYM_VOLT);
 }
 
 static void osdElementMotorDiagnostics(osdElementParms_t *element)
@@ -991,7 +1034,7 @@ static void osdElementMotorDiagnostics(osdElementParms_t *element)
 static void osdElementNumericalHeading(osdElementParms_t *element)
 {
     const int heading = DECIDEGREES_TO_DEGREES(attitude.values.yaw);
-    tfp_sprintf(element->buff, "%c%03d", osdGetDirectionSymbolFromHeading(heading), heading);
+    formatInt(formatChar(element->buff, osdGetDirectionSymbolFromHeading(heading)), heading, 3, '0');
 }
 
 #ifdef USE_VARIO
@@ -1008,7 +1051,9 @@ static void osdElementNumericalVario(osdElementParms_t *element)
     if (haveBaro || haveGps) {
         const int verticalSpeed = osdGetMetersToSelectedUnit(getEstimatedVario());
         const char directionSymbol = verticalSpeed < 0 ? SYM_ARROW_SMALL_DOWN : SYM_ARROW_SMALL_UP;
-        tfp_sprintf(element->buff, "%c%01d.%01d%c", directionSymbol, abs(verticalSpeed / 100), abs((verticalSpeed % 100) / 10), osdGetVarioToSelectedUnitSymbol());
+        char *p = formatChar(element->buff, directionSymbol);
+        p = formatFixed(p, abs(verticalSpeed) / 10, 1, 0);
+        formatChar(p, osdGetVarioToSelectedUnitSymbol());
     } else {
         // We use this symbol when we don't have a valid measure
         element->buff[0] = SYM_HYPHEN;
@@ -1019,7 +1064,9 @@ static void osdElementNumericalVario(osdElementParms_t *element)
 
 static void osdElementPidRateProfile(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%d-%d", getCurrentPidProfileIndex() + 1, getCurrentControlRateProfileIndex() + 1);
+    char *p = formatUnsigned(element->buff, getCurrentPidProfileIndex() + 1, 0, ' ');
+    p = formatChar(p, '-');
+    formatUnsigned(p, getCurrentControlRateProfileIndex() + 1, 0, ' ');
 }
 
 static void osdElementPidsPitch(osdElementParms_t *element)
@@ -1039,7 +1086,8 @@ static void osdElementPidsYaw(osdElementParms_t *element)
 
 static void osdElementPower(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%4dW", getAmperage() * getBatteryVoltage() / 10000);
+    char *p = formatInt(element->buff, getAmperage() * getBatteryVoltage() / 10000, 4, ' ');
+    formatChar(p, 'W');
 }
 
 static void osdElementRcChannels(osdElementParms_t *element)
@@ -1051,10 +1099,8 @@ static void osdElementRcChannels(osdElementParms_t *element)
         if (osdConfig()->rcChannels[i] >= 0) {
             // Translate (1000, 2000) to (-1000, 1000)
             int data = scaleRange(rcData[osdConfig()->rcChannels[i]], PWM_RANGE_MIN, PWM_RANGE_MAX, -1000, 1000);
-            // Opt for the simplest formatting for now.
-            // Decimal notation can be added when tfp_sprintf supports float among fancy options.
             char fmtbuf[6];
-            tfp_sprintf(fmtbuf, "%5d", data);
+            formatInt(fmtbuf, data, 5, ' ');
             displayWrite(element->osdDisplayPort, xpos, ypos + i, fmtbuf);
         }
     }
@@ -1067,9 +1113,9 @@ static void osdElementRemainingTimeEstimate(osdElementParms_t *element)
     const int mAhDrawn = getMAhDrawn();
 
     if (mAhDrawn <= 0.1 * osdConfig()->cap_alarm) {  // also handles the mAhDrawn == 0 condition
-        tfp_sprintf(element->buff, "--:--");
+        strcpy(element->buff, "--:--");
     } else if (mAhDrawn > osdConfig()->cap_alarm) {
-        tfp_sprintf(element->buff, "00:00");
+        strcpy(element->buff, "00:00");
     } else {
         const int remaining_time = (int)((osdConfig()->cap_alarm - mAhDrawn) * ((float)osdFlyTime) / mAhDrawn);
         osdFormatTime(element->buff, OSD_TIMER_PREC_SECOND, remaining_time);
@@ -1083,7 +1129,7 @@ static void osdElementRssi(osdElementParms_t *element)
         osdRssi = 99;
     }
 
-    tfp_sprintf(element->buff, "%c%2d", SYM_RSSI, osdRssi);
+    formatUnsigned(formatChar(element->buff, SYM_RSSI), osdRssi, 2, ' ');
 }
 
 #ifdef USE_RTC_TIME
@@ -1096,7 +1142,7 @@ static void osdElementRtcTime(osdElementParms_t *element)
 #ifdef USE_RX_RSSI_DBM
 static void osdElementRssiDbm(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%c%3d", SYM_RSSI, getRssiDbm() * -1);
+    formatInt(formatChar(element->buff, SYM_RSSI), getRssiDbm() * -1, 3, ' ');
 }
 #endif // USE_RX_RSSI_DBM
 
@@ -1151,7 +1197,7 @@ static void osdElementStickOverlay(osdElementParms_t *element)
 
 static void osdElementThrottlePosition(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%c%3d", SYM_THR, calculateThrottlePercent());
+    formatInt(formatChar(element->buff, SYM_THR), calculateThrottlePercent(), 3, ' ');
 }
 
 static void osdElementTimer(osdElementParms_t *element)
@@ -1184,11 +1230,17 @@ static void osdElementVtxChannel(osdElementParms_t *element)
     }
 
     if (vtxStatus & VTX_STATUS_LOCKED) {
-        tfp_sprintf(element->buff, "-:-:-:L");
-    } else if (vtxStatusIndicator) {
-        tfp_sprintf(element->buff, "%c:%s:%s:%c", vtxBandLetter, vtxChannelName, vtxPowerLabel, vtxStatusIndicator);
+        strcpy(element->buff, "-:-:-:L");
     } else {
-        tfp_sprintf(element->buff, "%c:%s:%s", vtxBandLetter, vtxChannelName, vtxPowerLabel);
+        char *p = formatChar(element->buff, vtxBandLetter);
+        p = formatChar(p, ':');
+        p = formatString(p, vtxChannelName);
+        p = formatChar(p, ':');
+        p = formatString(p, vtxPowerLabel);
+        if (vtxStatusIndicator) {
+            p = formatChar(p, ':');
+            formatChar(p, vtxStatusIndicator);
+        }
     }
 }
 #endif // USE_VTX_COMMON
@@ -1234,7 +1286,7 @@ static void osdElementWarnings(osdElementParms_t *element)
                 } while (!(flags & (1 << armingDisabledDisplayIndex)));
             }
 
-            tfp_sprintf(element->buff, "%s", armingDisableFlagNames[armingDisabledDisplayIndex]);
+            strcpy(element->buff, armingDisableFlagNames[armingDisabledDisplayIndex]);
             return;
         } else {
             armingDisabledUpdateTimeUs = 0;
@@ -1248,22 +1300,22 @@ static void osdElementWarnings(osdElementParms_t *element)
             armingDelayTime = 0;
         }
         if (armingDelayTime >= (DSHOT_BEACON_GUARD_DELAY_US / 1e5 - 5)) {
-            tfp_sprintf(element->buff, " BEACON ON"); // Display this message for the first 0.5 seconds
+            strcpy(element->buff, " BEACON ON"); // Display this message for the first 0.5 seconds
         } else {
-            tfp_sprintf(element->buff, "ARM IN %d.%d", armingDelayTime / 10, armingDelayTime % 10);
+            formatFixed(formatString(element->buff, "ARM IN "), armingDelayTime, 1, 0);
         }
         return;
     }
 #endif // USE_DSHOT
     if (osdWarnGetState(OSD_WARNING_FAIL_SAFE) && failsafeIsActive()) {
-        tfp_sprintf(element->buff, "FAIL SAFE");
+        strcpy(element->buff, "FAIL SAFE");
         SET_BLINK(OSD_WARNINGS);
         return;
     }
 
     // Warn when in flip over after crash mode
     if (osdWarnGetState(OSD_WARNING_CRASH_FLIP) && isFlipOverAfterCrashActive()) {
-        tfp_sprintf(element->buff, "CRASH FLIP");
+        strcpy(element->buff, "CRASH FLIP");
         return;
     }
 
@@ -1273,11 +1325,11 @@ static void osdElementWarnings(osdElementParms_t *element)
 #ifdef USE_ACC
         if (sensors(SENSOR_ACC)) {
             const int pitchAngle = constrain((attitude.raw[FD_PITCH] - accelerometerConfig()->accelerometerTrims.raw[FD_PITCH]) / 10, -90, 90);
-            tfp_sprintf(element->buff, "LAUNCH %d", pitchAngle);
+            formatInt(formatString(element->buff, "LAUNCH "), pitchAngle, 0, ' ');
         } else
 #endif // USE_ACC
         {
-            tfp_sprintf(element->buff, "LAUNCH");
+            strcpy(element->buff, "LAUNCH");
         }
 
         // Blink the message if the throttle is within 10% of the launch setting
@@ -1290,14 +1342,14 @@ static void osdElementWarnings(osdElementParms_t *element)
 
     // RSSI
     if (osdWarnGetState(OSD_WARNING_RSSI) && (getRssiPercent() < osdConfig()->rssi_alarm)) {
-        tfp_sprintf(element->buff, "RSSI LOW");
+        strcpy(element->buff, "RSSI LOW");
         SET_BLINK(OSD_WARNINGS);
         return;
     }
 #ifdef USE_RX_RSSI_DBM
     // rssi dbm
     if (osdWarnGetState(OSD_WARNING_RSSI_DBM) && (getRssiDbm() > osdConfig()->rssi_dbm_alarm)) {
-        tfp_sprintf(element->buff, "RSSI DBM");
+        strcpy(element->buff, "RSSI DBM");
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1306,14 +1358,14 @@ static void osdElementWarnings(osdElementParms_t *element)
 #ifdef USE_RX_LINK_QUALITY_INFO
     // Link Quality
     if (osdWarnGetState(OSD_WARNING_LINK_QUALITY) && (rxGetLinkQualityPercent() < osdConfig()->link_quality_alarm)) {
-        tfp_sprintf(element->buff, "LINK QUALITY");
+        strcpy(element->buff, "LINK QUALITY");
         SET_BLINK(OSD_WARNINGS);
         return;
     }
 #endif // USE_RX_LINK_QUALITY_INFO
 
     if (osdWarnGetState(OSD_WARNING_BATTERY_CRITICAL) && batteryState == BATTERY_CRITICAL) {
-        tfp_sprintf(element->buff, " LAND NOW");
+        strcpy(element->buff, " LAND NOW");
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1324,7 +1376,7 @@ static void osdElementWarnings(osdElementParms_t *element)
        gpsRescueIsConfigured() &&
        !gpsRescueIsDisabled() &&
        !gpsRescueIsAvailable()) {
-        tfp_sprintf(element->buff, "RESCUE N/A");
+        strcpy(element->buff, "RESCUE N/A");
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1336,7 +1388,7 @@ static void osdElementWarnings(osdElementParms_t *element)
 
         statistic_t *stats = osdGetStats();
         if (cmpTimeUs(stats->armed_time, OSD_GPS_RESCUE_DISABLED_WARNING_DURATION_US) < 0) {
-            tfp_sprintf(element->buff, "RESCUE OFF");
+            strcpy(element->buff, "RESCUE OFF");
             SET_BLINK(OSD_WARNINGS);
             return;
         }
@@ -1346,7 +1398,7 @@ static void osdElementWarnings(osdElementParms_t *element)
 
     // Show warning if in HEADFREE flight mode
     if (FLIGHT_MODE(HEADFREE_MODE)) {
-        tfp_sprintf(element->buff, "HEADFREE");
+        strcpy(element->buff, "HEADFREE");
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1354,7 +1406,11 @@ static void osdElementWarnings(osdElementParms_t *element)
 #ifdef USE_ADC_INTERNAL
     const int16_t coreTemperature = getCoreTemperatureCelsius();
     if (osdWarnGetState(OSD_WARNING_CORE_TEMPERATURE) && coreTemperature >= osdConfig()->core_temp_alarm) {
-        tfp_sprintf(element->buff, "CORE %c: %3d%c", SYM_TEMPERATURE, osdConvertTemperatureToSelectedUnit(coreTemperature), osdGetTemperatureSymbolForSelectedUnit());
+        char *p = formatString(element->buff, "CORE ");
+        p = formatChar(p, SYM_TEMPERATURE);
+        p = formatString(p, ": ");
+        p = formatInt(p, osdConvertTemperatureToSelectedUnit(coreTemperature), 3, ' ');
+        formatChar(p, osdGetTemperatureSymbolForSelectedUnit());
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1405,7 +1461,7 @@ static void osdElementWarnings(osdElementParms_t *element)
         escWarningMsg[pos] = '\0';
 
         if (escWarningCount > 0) {
-            tfp_sprintf(element->buff, "%s", escWarningMsg);
+            strcpy(element->buff, escWarningMsg);
             SET_BLINK(OSD_WARNINGS);
             return;
         }
@@ -1413,7 +1469,7 @@ static void osdElementWarnings(osdElementParms_t *element)
 #endif // USE_ESC_SENSOR
 
     if (osdWarnGetState(OSD_WARNING_BATTERY_WARNING) && batteryState == BATTERY_WARNING) {
-        tfp_sprintf(element->buff, "LOW BATTERY");
+        strcpy(element->buff, "LOW BATTERY");
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1421,7 +1477,7 @@ static void osdElementWarnings(osdElementParms_t *element)
 #ifdef USE_RC_SMOOTHING_FILTER
     // Show warning if rc smoothing hasn't initialized the filters
     if (osdWarnGetState(OSD_WARNING_RC_SMOOTHING) && ARMING_FLAG(ARMED) && !rcSmoothingInitializationComplete()) {
-        tfp_sprintf(element->buff, "RCSMOOTHING");
+        strcpy(element->buff, "RCSMOOTHING");
         SET_BLINK(OSD_WARNINGS);
         return;
     }
@@ -1430,13 +1486,13 @@ static void osdElementWarnings(osdElementParms_t *element)
     // Show warning if battery is not fresh
     if (osdWarnGetState(OSD_WARNING_BATTERY_NOT_FULL) && !ARMING_FLAG(WAS_EVER_ARMED) && (getBatteryState() == BATTERY_OK)
           && getBatteryAverageCellVoltage() < batteryConfig()->vbatfullcellvoltage) {
-        tfp_sprintf(element->buff, "BATT < FULL");
+        strcpy(element->buff, "BATT < FULL");
         return;
     }
 
     // Visual beeper
     if (osdWarnGetState(OSD_WARNING_VISUAL_BEEPER) && osdGetVisualBeeperState()) {
-        tfp_sprintf(element->buff, "  * * * *");
+        strcpy(element->buff, "  * * * *");
         return;
     }
 
@@ -1638,19 +1694,220 @@ const osdElementDrawFn osdElementBackgroundFunction[OSD_ITEM_COUNT] = {
     [OSD_DISPLAY_NAME]            = osdBackgroundDisplayName,
 };
 
+#ifdef USE_OSD_ELEMENT_REFRESH
+// Define how often each element needs to be re-rendered
+// Only necessary to define the entries that can be refreshed slower than every OSD refresh
+
+static const uint8_t osdElementRefreshClass[OSD_ITEM_COUNT] = {
+    [OSD_RSSI_VALUE]              = OSD_REFRESH_NORMAL,
+    [OSD_MAIN_BATT_VOLTAGE]       = OSD_REFRESH_NORMAL,
+    [OSD_ITEM_TIMER_1]            = OSD_REFRESH_NORMAL,
+    [OSD_ITEM_TIMER_2]            = OSD_REFRESH_NORMAL,
+#ifdef USE_VTX_COMMON
+    [OSD_VTX_CHANNEL]             = OSD_REFRESH_SLOW,
+#endif
+    [OSD_CURRENT_DRAW]            = OSD_REFRESH_NORMAL,
+    [OSD_MAH_DRAWN]               = OSD_REFRESH_NORMAL,
+#ifdef USE_GPS
+    [OSD_GPS_SATS]                = OSD_REFRESH_NORMAL,
+#endif
+    [OSD_ROLL_PIDS]               = OSD_REFRESH_SLOW,
+    [OSD_PITCH_PIDS]              = OSD_REFRESH_SLOW,
+    [OSD_YAW_PIDS]                = OSD_REFRESH_SLOW,
+    [OSD_POWER]                   = OSD_REFRESH_NORMAL,
+    [OSD_PIDRATE_PROFILE]         = OSD_REFRESH_SLOW,
+    [OSD_AVG_CELL_VOLTAGE]        = OSD_REFRESH_NORMAL,
+#ifdef USE_GPS
+    [OSD_GPS_LON]                 = OSD_REFRESH_NORMAL,
+    [OSD_GPS_LAT]                 = OSD_REFRESH_NORMAL,
+    [OSD_HOME_DIST]               = OSD_REFRESH_NORMAL,
+    [OSD_FLIGHT_DIST]             = OSD_REFRESH_NORMAL,
+#endif
+    [OSD_MAIN_BATT_USAGE]         = OSD_REFRESH_NORMAL,
+#ifdef USE_ESC_SENSOR
+    [OSD_ESC_TMP]                 = OSD_REFRESH_SLOW,
+#endif
+    [OSD_REMAINING_TIME_ESTIMATE] = OSD_REFRESH_SLOW,
+#ifdef USE_RTC_TIME
+    [OSD_RTC_DATETIME]            = OSD_REFRESH_NORMAL,
+#endif
+#ifdef USE_ADC_INTERNAL
+    [OSD_CORE_TEMPERATURE]        = OSD_REFRESH_SLOW,
+#endif
+#ifdef USE_BLACKBOX
+    [OSD_LOG_STATUS]              = OSD_REFRESH_SLOW,
+#endif
+#ifdef USE_RX_LINK_QUALITY_INFO
+    [OSD_LINK_QUALITY]            = OSD_REFRESH_NORMAL,
+#endif
+#ifdef USE_PROFILE_NAMES
+    [OSD_RATE_PROFILE_NAME]       = OSD_REFRESH_SLOW,
+    [OSD_PID_PROFILE_NAME]        = OSD_REFRESH_SLOW,
+#endif
+#ifdef USE_OSD_PROFILES
+    [OSD_PROFILE_NAME]            = OSD_REFRESH_SLOW,
+#endif
+#ifdef USE_RX_RSSI_DBM
+    [OSD_RSSI_DBM_VALUE]          = OSD_REFRESH_NORMAL,
+#endif
+};
+
+static const timeUs_t osdElementRefreshIntervalUs[OSD_REFRESH_CLASS_COUNT] = {
+    [OSD_REFRESH_CRITICAL]        = 0,
+    [OSD_REFRESH_NORMAL]          = 100000,
+    [OSD_REFRESH_SLOW]            = 1000000,
+};
+
+// Limit the number of non critical elements rendered per OSD refresh so
+// that elements which become due together are spread over several refreshes
+#define OSD_ELEMENT_RENDER_BUDGET 6
+
+typedef int32_t (*osdElementValueFn)(void);
+
+static int32_t osdValueMainBatteryVoltage(void)
+{
+    // the battery symbol follows the average cell voltage
+    return getBatteryVoltage() | ((int32_t)getBatteryAverageCellVoltage() << 16);
+}
+
+static int32_t osdValueRssi(void)
+{
+    return getRssi();
+}
+
+static int32_t osdValueAverageCellVoltage(void)
+{
+    return getBatteryAverageCellVoltage();
+}
+
+static int32_t osdValuePower(void)
+{
+    return getAmperage() * getBatteryVoltage() / 10000;
+}
+
+static int32_t osdValueMahDrawn(void)
+{
+    return getMAhDrawn();
+}
+
+static int32_t osdValueThrottlePosition(void)
+{
+    return calculateThrottlePercent();
+}
+
+// Define the runtime value each element's text is rendered from
+// Only necessary for elements that don't need to be re-rendered while the value is unchanged
+
+static const osdElementValueFn osdElementValueFunction[OSD_ITEM_COUNT] = {
+    [OSD_RSSI_VALUE]              = osdValueRssi,
+    [OSD_MAIN_BATT_VOLTAGE]       = osdValueMainBatteryVoltage,
+    [OSD_THROTTLE_POS]            = osdValueThrottlePosition,
+    [OSD_CURRENT_DRAW]            = getAmperage,
+    [OSD_MAH_DRAWN]               = osdValueMahDrawn,
+    [OSD_POWER]                   = osdValuePower,
+    [OSD_AVG_CELL_VOLTAGE]        = osdValueAverageCellVoltage,
+    [OSD_MAIN_BATT_USAGE]         = osdValueMahDrawn,
+};
+
+typedef struct osdElementCache_s {
+    timeUs_t nextRenderUs;
+    int32_t value;
+    bool valid;
+    bool drawsDirectly;         // element writes to the display itself, so there is no text to cache
+    char text[OSD_ELEMENT_BUFFER_LENGTH];
+} osdElementCache_t;
+
+static osdElementCache_t osdElementCache[OSD_ITEM_COUNT];
+static uint8_t osdElementRenderBudget;
+
+static void osdElementInvalidateCache(void)
+{
+    memset(osdElementCache, 0, sizeof(osdElementCache));
+}
+
+// Decide whether an element has to be rendered again or can be redrawn from its cache
+static bool osdElementNeedsRender(const osdLayoutElement_t *layoutElement, osdElementCache_t *cache, timeUs_t currentTimeUs)
+{
+    if (cache->valid && cache->drawsDirectly) {
+        return true;
+    }
+
+    const uint8_t item = layoutElement->item;
+    const osdElementRefreshClass_e refreshClass = osdElementRefreshClass[item];
+    const bool rateLimited = cache->valid && refreshClass != OSD_REFRESH_CRITICAL;
+    if (rateLimited && (cmpTimeUs(currentTimeUs, cache->nextRenderUs) < 0 || osdElementRenderBudget == 0)) {
+        return false;
+    }
+    const timeUs_t intervalUs = osdElementRefreshIntervalUs[refreshClass];
+    if (rateLimited && cmpTimeUs(currentTimeUs, cache->nextRenderUs) < (timeDelta_t)intervalUs) {
+        // Refreshes come late by up to one OSD draw period, count from the deadline to keep the element's rate
+        cache->nextRenderUs += intervalUs;
+    } else {
+        cache->nextRenderUs = currentTimeUs + intervalUs;
+    }
+
+    if (osdElementValueFunction[item]) {
+        const int32_t value = osdElementValueFunction[item]();
+        if (cache->valid && value == cache->value) {
+            return false;
+        }
+        cache->value = value;
+    }
+
+    if (rateLimited) {
+        osdElementRenderBudget--;
+    }
+    return true;
+}
+#endif // USE_OSD_ELEMENT_REFRESH
+
 static void osdAddActiveElement(osd_items_e element)
 {
-    if (VISIBLE(osdConfig()->item_pos[element])) {
-        activeOsdElementArray[activeOsdElementCount++] = element;
+    const uint16_t itemPos = osdConfig()->item_pos[element];
+
+    for (unsigned profile = 1; profile <= OSD_PROFILE_COUNT; profile++) {
+        if (VISIBLE_IN_OSD_PROFILE(itemPos, profile)) {
+            osdLayout_t *layout = &osdLayouts[profile - 1];
+            osdLayoutElement_t *layoutElement = &layout->elements[layout->count++];
+
+            layoutElement->item = element;
+            layoutElement->posX = OSD_X(itemPos);
+            layoutElement->posY = OSD_Y(itemPos);
+        }
     }
 }
 
-// Examine the elements and build a list of only the active (enabled)
-// ones to speed up rendering.
+static void osdResetLayouts(void)
+{
+    for (unsigned i = 0; i < OSD_PROFILE_COUNT; i++) {
+        osdLayouts[i].count = 0;
+    }
+    activeLayout = &osdLayouts[0];
+}
+
+// Switch to the compiled layout of another OSD profile.
+void osdSelectActiveElementsProfile(uint8_t profileIndex)
+{
+    if (profileIndex > OSD_PROFILE_COUNT) {
+        return;
+    }
+    // profile index 0 shows the elements of the first profile, as setOsdProfile() does
+    activeLayout = &osdLayouts[profileIndex ? profileIndex - 1 : 0];
+#ifdef USE_OSD_ELEMENT_REFRESH
+    osdElementInvalidateCache();
+#endif
+}
+
+// Examine the elements and compile the layout of active (enabled)
+// ones of each OSD profile to speed up rendering.
 
 void osdAddActiveElements(void)
 {
-    activeOsdElementCount = 0;
+    osdResetLayouts();
+#ifdef USE_OSD_ELEMENT_REFRESH
+    // positions or settings may have changed, render everything again
+    osdElementInvalidateCache();
+#endif
 
 #ifdef USE_ACC
     if (sensors(SENSOR_ACC)) {
@@ -1686,10 +1943,15 @@ void osdAddActiveElements(void)
         osdAddActiveElement(OSD_ESC_RPM_FREQ);
     }
 #endif
+
+#ifdef USE_OSD_PROFILES
+    osdSelectActiveElementsProfile(getCurrentOsdProfileIndex());
+#endif
 }
 
-static void osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item)
+static void osdDrawSingleElement(displayPort_t *osdDisplayPort, const osdLayoutElement_t *layoutElement, timeUs_t currentTimeUs)
 {
+    const uint8_t item = layoutElement->item;
     if (!osdElementDrawFunction[item]) {
         // Element has no drawing function
         return;
@@ -1698,8 +1960,19 @@ static void osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item)
         return;
     }
 
-    uint8_t elemPosX = OSD_X(osdConfig()->item_pos[item]);
-    uint8_t elemPosY = OSD_Y(osdConfig()->item_pos[item]);
+    const uint8_t elemPosX = layoutElement->posX;
+    const uint8_t elemPosY = layoutElement->posY;
+
+#ifdef USE_OSD_ELEMENT_REFRESH
+    osdElementCache_t *cache = &osdElementCache[item];
+    if (!osdElementNeedsRender(layoutElement, cache, currentTimeUs)) {
+        displayWrite(osdDisplayPort, elemPosX, elemPosY, cache->text);
+        return;
+    }
+#else
+    UNUSED(currentTimeUs);
+#endif
+
     char buff[OSD_ELEMENT_BUFFER_LENGTH] = "";
 
     osdElementParms_t element;
@@ -1715,17 +1988,26 @@ static void osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item)
     if (element.drawElement) {
         displayWrite(osdDisplayPort, elemPosX, elemPosY, buff);
     }
+
+#ifdef USE_OSD_ELEMENT_REFRESH
+    cache->valid = true;
+    cache->drawsDirectly = !element.drawElement;
+    if (element.drawElement) {
+        memcpy(cache->text, buff, sizeof(cache->text));
+    }
+#endif
 }
 
-static void osdDrawSingleElementBackground(displayPort_t *osdDisplayPort, uint8_t item)
+static void osdDrawSingleElementBackground(displayPort_t *osdDisplayPort, const osdLayoutElement_t *layoutElement)
 {
+    const uint8_t item = layoutElement->item;
     if (!osdElementBackgroundFunction[item]) {
         // Element has no background drawing function
         return;
     }
 
-    uint8_t elemPosX = OSD_X(osdConfig()->item_pos[item]);
-    uint8_t elemPosY = OSD_Y(osdConfig()->item_pos[item]);
+    const uint8_t elemPosX = layoutElement->posX;
+    const uint8_t elemPosY = layoutElement->posY;
     char buff[OSD_ELEMENT_BUFFER_LENGTH] = "";
 
     osdElementParms_t element;
@@ -1757,14 +2039,18 @@ void osdDrawActiveElements(displayPort_t *osdDisplayPort, timeUs_t currentTimeUs
 #endif // USE_GPS
 
     blinkState = (currentTimeUs / 200000) % 2;
+#ifdef USE_OSD_ELEMENT_REFRESH
+    osdElementRenderBudget = OSD_ELEMENT_RENDER_BUDGET;
+#endif
 
-    for (unsigned i = 0; i < activeOsdElementCount; i++) {
+    for (unsigned i = 0; i < activeLayout->count; i++) {
+        const osdLayoutElement_t *layoutElement = &activeLayout->elements[i];
         if (!backgroundLayerSupported) {
             // If the background layer isn't supported then we
             // have to draw the element's static layer as well.
-            osdDrawSingleElementBackground(osdDisplayPort, activeOsdElementArray[i]);
+            osdDrawSingleElementBackground(osdDisplayPort, layoutElement);
         }
-        osdDrawSingleElement(osdDisplayPort, activeOsdElementArray[i]);
+        osdDrawSingleElement(osdDisplayPort, layoutElement, currentTimeUs);
     }
 }
 
@@ -1773,8 +2059,8 @@ void osdDrawActiveElementsBackground(displayPort_t *osdDisplayPort)
     if (backgroundLayerSupported) {
         displayLayerSelect(osdDisplayPort, DISPLAYPORT_LAYER_BACKGROUND);
         displayClearScreen(osdDisplayPort);
-        for (unsigned i = 0; i < activeOsdElementCount; i++) {
-            osdDrawSingleElementBackground(osdDisplayPort, activeOsdElementArray[i]);
+        for (unsigned i = 0; i < activeLayout->count; i++) {
+            osdDrawSingleElementBackground(osdDisplayPort, &activeLayout->elements[i]);
         }
         displayLayerSelect(osdDisplayPort, DISPLAYPORT_LAYER_FOREGROUND);
     }
@@ -1783,7 +2069,7 @@ void osdDrawActiveElementsBackground(displayPort_t *osdDisplayPort)
 void osdElementsInit(bool backgroundLayerFlag)
 {
     backgroundLayerSupported = backgroundLayerFlag;
-    activeOsdElementCount = 0;
+    osdResetLayouts();
 }
 
 void osdResetAlarms(void)
@@ -1885,8 +2171,8 @@ void osdUpdateAlarms(void)
 #ifdef USE_ACC
 static bool osdElementIsActive(osd_items_e element)
 {
-    for (unsigned i = 0; i < activeOsdElementCount; i++) {
-        if (activeOsdElementArray[i] == element) {
+    for (unsigned i = 0; i < activeLayout->count; i++) {
+        if (activeLayout->elements[i].item == element) {
             return true;
         }
     }
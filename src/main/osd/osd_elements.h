@@ -35,6 +35,14 @@ typedef struct osdElementParms_s {
 
 typedef void (*osdElementDrawFn)(osdElementParms_t *element);
 
+// How often an element needs to be re-rendered, see osdElementRefreshClass
+typedef enum {
+    OSD_REFRESH_CRITICAL = 0,   // every OSD refresh
+    OSD_REFRESH_NORMAL,         // ~10Hz
+    OSD_REFRESH_SLOW,           // ~1Hz
+    OSD_REFRESH_CLASS_COUNT
+} osdElementRefreshClass_e;
+
 int osdConvertTemperatureToSelectedUnit(int tempInDegreesCelcius);
 void osdFormatDistanceString(char *result, int distance, char leadingSymbol);
 bool osdFormatRtcDateTime(char *buffer);
@@ -46,6 +54,7 @@ int32_t osdGetSpeedToSelectedUnit(int32_t value);
 char osdGetSpeedToSelectedUnitSymbol(void);
 char osdGetTemperatureSymbolForSelectedUnit(void);
 void osdAddActiveElements(void);
+void osdSelectActiveElementsProfile(uint8_t profileIndex);
 void osdDrawActiveElements(displayPort_t *osdDisplayPort, timeUs_t currentTimeUs);
 void osdDrawActiveElementsBackground(displayPort_t *osdDisplayPort);
 void osdElementsInit(bool backgroundLayerFlag);
@@ -29,6 +29,7 @@ typedef struct displayPortProfile_s {
     uint8_t blackBrightness;
     uint8_t whiteBrightness;
     int8_t displayPortSerial;  // serialPortIdentifier_e
+    bool batchWrites;          // send changed cells in MSP_DP_WRITE_BATCH frames, the receiver must support it
 } displayPortProfile_t;
 
 PG_DECLARE(displayPortProfile_t, displayPortProfileMsp);
@@ -38,5 +38,11 @@ void pgResetFn_max7456Config(max7456Config_t *config)
     config->csTag = IO_TAG(MAX7456_SPI_CS_PIN);
     config->spiDevice = SPI_DEV_TO_CFG(spiDeviceByInstance(MAX7456_SPI_INSTANCE));
     config->preInitOPU = false;
+#ifdef MAX7456_VSYNC_PIN
+    config->vsyncTag = IO_TAG(MAX7456_VSYNC_PIN);
+#else
+    config->vsyncTag = IO_TAG_NONE;
+#endif
+    config->frameSync = false;
 }
 #endif // USE_MAX7456
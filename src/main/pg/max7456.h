@@ -28,6 +28,8 @@ typedef struct max7456Config_s {
     ioTag_t csTag;
     uint8_t spiDevice;
     bool preInitOPU;
+    ioTag_t vsyncTag;   // VSYNC output of the chip, frame sync is off without it
+    bool frameSync;     // commit display memory writes in the vertical blanking interval only
 } max7456Config_t;
 
 // clockConfig values
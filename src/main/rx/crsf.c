@@ -64,6 +64,8 @@ STATIC_UNIT_TESTED uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
 
 static serialPort_t *serialPort;
 static uint32_t crsfFrameStartAtUs = 0;
+static timeUs_t crsfFrameDoneAtUs = 0;
+static timeUs_t crsfRcFrameTimeUs = 0;
 static uint8_t telemetryBuf[CRSF_FRAME_SIZE_MAX];
 static uint8_t telemetryBufLen = 0;
 
@@ -217,21 +219,15 @@ static void crsfCheckRssi(uint32_t currentTimeUs) {
 STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
 {
     // CRC includes type and payload
-    uint8_t crc = crc8_dvb_s2(0, crsfFrame.frame.type);
-    for (int ii = 0; ii < crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_TYPE_CRC; ++ii) {
-        crc = crc8_dvb_s2(crc, crsfFrame.frame.payload[ii]);
-    }
-    return crc;
+    const uint8_t crc = crc8_dvb_s2(0, crsfFrame.frame.type);
+    const int payloadLength = crsfFrame.frame.frameLength - CRSF_FRAME_LENGTH_TYPE_CRC;
+    return payloadLength > 0 ? crc8_dvb_s2_update(crc, crsfFrame.frame.payload, payloadLength) : crc;
 }
 
-// Receive ISR callback, called back from serial port
-STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
-{
-    UNUSED(data);
-
-    static uint8_t crsfFramePosition = 0;
-    const uint32_t currentTimeUs = micros();
+static uint8_t crsfFramePosition = 0;
 
+static void crsfProcessByte(uint8_t c, timeUs_t currentTimeUs)
+{
 #ifdef DEBUG_CRSF_PACKETS
     debug[2] = currentTimeUs - crsfFrameStartAtUs;
 #endif
@@ -254,6 +250,7 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
         crsfFrameDone = crsfFramePosition < fullFrameLength ? false : true;
         if (crsfFrameDone) {
             crsfFramePosition = 0;
+            crsfFrameDoneAtUs = currentTimeUs;
             if (crsfFrame.frame.type != CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
                 const uint8_t crc = crsfFrameCRC();
                 if (crc == crsfFrame.bytes[fullFrameLength - 1]) {
@@ -301,6 +298,29 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
     }
 }
 
+// Receive ISR callback, called back from serial port
+STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
+{
+    UNUSED(data);
+
+    crsfProcessByte(c, micros());
+}
+
+#ifdef USE_SERIAL_RX_FRAMES
+// Idle line callback with everything received since the previous idle line, a gap between frames
+STATIC_UNIT_TESTED void crsfFrameReceive(const serialRxFrame_t *frame, void *data)
+{
+    UNUSED(data);
+
+    crsfFramePosition = 0;
+    for (int segment = 0; segment < 2; segment++) {
+        for (int i = 0; i < frame->length[segment]; i++) {
+            crsfProcessByte(frame->data[segment][i], frame->timeUs);
+        }
+    }
+}
+#endif
+
 STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeState_t *rxRuntimeState)
 {
     UNUSED(rxRuntimeState);
@@ -334,6 +354,7 @@ STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeState_t *rxRuntimeState)
             crsfChannelData[13] = rcChannels->chan13;
             crsfChannelData[14] = rcChannels->chan14;
             crsfChannelData[15] = rcChannels->chan15;
+            crsfRcFrameTimeUs = crsfFrameDoneAtUs;
             return RX_FRAME_COMPLETE;
         }
     }
@@ -354,6 +375,13 @@ STATIC_UNIT_TESTED uint16_t crsfReadRawRC(const rxRuntimeState_t *rxRuntimeState
     return (0.62477120195241f * crsfChannelData[chan]) + 881;
 }
 
+STATIC_UNIT_TESTED timeUs_t crsfFrameTimeUs(const rxRuntimeState_t *rxRuntimeState)
+{
+    UNUSED(rxRuntimeState);
+
+    return crsfRcFrameTimeUs;
+}
+
 void crsfRxWriteTelemetryData(const void *data, int len)
 {
     len = MIN(len, (int)sizeof(telemetryBuf));
@@ -381,6 +409,7 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 
     rxRuntimeState->rcReadRawFn = crsfReadRawRC;
     rxRuntimeState->rcFrameStatusFn = crsfFrameStatus;
+    rxRuntimeState->rcFrameTimeUsFn = crsfFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
@@ -396,6 +425,12 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
         CRSF_PORT_OPTIONS | (rxConfig->serialrx_inverted ? SERIAL_INVERTED : 0)
         );
 
+#ifdef USE_SERIAL_RX_FRAMES
+    if (serialPort) {
+        serialSetRxFrameCallback(serialPort, crsfFrameReceive);
+    }
+#endif
+
         if (rssiSource == RSSI_SOURCE_NONE) {
             rssiSource = RSSI_SOURCE_RX_PROTOCOL_CRSF;
         }
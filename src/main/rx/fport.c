@@ -130,6 +130,7 @@ static const smartPortPayload_t emptySmartPortFrame = { .frameId = 0, .valueId =
 typedef struct fportBuffer_s {
     uint8_t data[BUFFER_SIZE];
     uint8_t length;
+    timeUs_t doneAtUs;
 } fportBuffer_t;
 
 static fportBuffer_t rxBuffer[NUM_RX_BUFFERS];
@@ -144,6 +145,7 @@ static volatile uint8_t framePosition = 0;
 
 static smartPortPayload_t *mspPayload = NULL;
 static timeUs_t lastRcFrameReceivedMs = 0;
+static timeUs_t lastRcFrameTimeUs = 0;
 
 static serialPort_t *fportPort;
 #ifdef USE_TELEMETRY_SMARTPORT
@@ -159,18 +161,13 @@ static void reportFrameError(uint8_t errorReason) {
     DEBUG_SET(DEBUG_FPORT, DEBUG_FPORT_FRAME_LAST_ERROR, errorReason);
 }
 
-// Receive ISR callback
-static void fportDataReceive(uint16_t c, void *data)
+static void fportProcessByte(uint8_t c, timeUs_t currentTimeUs)
 {
-    UNUSED(data);
-
     static timeUs_t frameStartAt = 0;
     static bool escapedCharacter = false;
     static timeUs_t lastFrameReceivedUs = 0;
     static bool telemetryFrame = false;
 
-    const timeUs_t currentTimeUs = micros();
-
     clearToSend = false;
 
     if (framePosition > 1 && cmpTimeUs(currentTimeUs, frameStartAt) > FPORT_TIME_NEEDED_PER_FRAME_US + 500) {
@@ -186,6 +183,7 @@ static void fportDataReceive(uint16_t c, void *data)
             const uint8_t nextWriteIndex = (rxBufferWriteIndex + 1) % NUM_RX_BUFFERS;
             if (nextWriteIndex != rxBufferReadIndex) {
                 rxBuffer[rxBufferWriteIndex].length = framePosition - 1;
+                rxBuffer[rxBufferWriteIndex].doneAtUs = currentTimeUs;
                 rxBufferWriteIndex = nextWriteIndex;
             }
 
@@ -228,6 +226,28 @@ static void fportDataReceive(uint16_t c, void *data)
     }
 }
 
+// Receive ISR callback
+static void fportDataReceive(uint16_t c, void *data)
+{
+    UNUSED(data);
+
+    fportProcessByte(c, micros());
+}
+
+#ifdef USE_SERIAL_RX_FRAMES
+// Idle line callback with everything received since the previous idle line. Frames are delimited by their markers.
+static void fportFrameReceive(const serialRxFrame_t *frame, void *data)
+{
+    UNUSED(data);
+
+    for (int segment = 0; segment < 2; segment++) {
+        for (int i = 0; i < frame->length[segment]; i++) {
+            fportProcessByte(frame->data[segment][i], frame->timeUs);
+        }
+    }
+}
+#endif
+
 #if defined(USE_TELEMETRY_SMARTPORT)
 static void smartPortWriteFrameFport(const smartPortPayload_t *payload)
 {
@@ -286,6 +306,7 @@ static uint8_t fportFrameStatus(rxRuntimeState_t *rxRuntimeState)
                         setRssi(scaleRange(frame->data.controlData.rssi, 0, 100, 0, RSSI_MAX_VALUE), RSSI_SOURCE_RX_PROTOCOL);
 
                         lastRcFrameReceivedMs = millis();
+                        lastRcFrameTimeUs = rxBuffer[rxBufferReadIndex].doneAtUs;
                     }
 
                     break;
@@ -390,6 +411,13 @@ static bool fportProcessFrame(const rxRuntimeState_t *rxRuntimeState)
     return true;
 }
 
+static timeUs_t fportFrameTimeUs(const rxRuntimeState_t *rxRuntimeState)
+{
+    UNUSED(rxRuntimeState);
+
+    return lastRcFrameTimeUs;
+}
+
 bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 {
     static uint16_t sbusChannelData[SBUS_MAX_CHANNEL];
@@ -401,6 +429,7 @@ bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 
     rxRuntimeState->rcFrameStatusFn = fportFrameStatus;
     rxRuntimeState->rcProcessFrameFn = fportProcessFrame;
+    rxRuntimeState->rcFrameTimeUsFn = fportFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
@@ -417,6 +446,10 @@ bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
     );
 
     if (fportPort) {
+#ifdef USE_SERIAL_RX_FRAMES
+        serialSetRxFrameCallback(fportPort, fportFrameReceive);
+#endif
+
 #if defined(USE_TELEMETRY_SMARTPORT)
         telemetryEnabled = initSmartPortTelemetryExternal(smartPortWriteFrameFport);
 #endif
@@ -72,6 +72,8 @@ static uint8_t rxBytesToIgnore;
 static uint16_t ibusChecksum;
 
 static bool ibusFrameDone = false;
+static timeUs_t ibusFrameDoneAtUs;
+static timeUs_t ibusRcFrameTimeUs;
 static uint32_t ibusChannelData[IBUS_MAX_CHANNEL];
 
 static uint8_t ibus[IBUS_BUFFSIZE] = { 0, };
@@ -83,16 +85,11 @@ static bool isValidIa6bIbusPacketLength(uint8_t length)
 }
 
 
-// Receive ISR callback
-static void ibusDataReceive(uint16_t c, void *data)
-{
-    UNUSED(data);
+static uint8_t ibusFramePosition;
 
-    uint32_t ibusTime;
+static void ibusProcessByte(uint8_t c, timeUs_t ibusTime)
+{
     static uint32_t ibusTimeLast;
-    static uint8_t ibusFramePosition;
-
-    ibusTime = micros();
 
     if ((ibusTime - ibusTimeLast) > IBUS_FRAME_GAP) {
         ibusFramePosition = 0;
@@ -126,11 +123,35 @@ static void ibusDataReceive(uint16_t c, void *data)
 
     if (ibusFramePosition == ibusFrameSize - 1) {
         ibusFrameDone = true;
+        ibusFrameDoneAtUs = ibusTime;
     } else {
         ibusFramePosition++;
     }
 }
 
+// Receive ISR callback
+static void ibusDataReceive(uint16_t c, void *data)
+{
+    UNUSED(data);
+
+    ibusProcessByte(c, micros());
+}
+
+#ifdef USE_SERIAL_RX_FRAMES
+// Idle line callback with everything received since the previous idle line, a gap between frames
+static void ibusFrameReceive(const serialRxFrame_t *frame, void *data)
+{
+    UNUSED(data);
+
+    ibusFramePosition = 0;
+    for (int segment = 0; segment < 2; segment++) {
+        for (int i = 0; i < frame->length[segment]; i++) {
+            ibusProcessByte(frame->data[segment][i], frame->timeUs);
+        }
+    }
+}
+#endif
+
 
 static bool isChecksumOkIa6(void)
 {
@@ -182,6 +203,7 @@ static uint8_t ibusFrameStatus(rxRuntimeState_t *rxRuntimeState)
     if (checksumIsOk()) {
         if (ibusModel == IBUS_MODEL_IA6 || ibusSyncByte == IBUS_SERIAL_RX_PACKET_LENGTH) {
             updateChannelData();
+            ibusRcFrameTimeUs = ibusFrameDoneAtUs;
             frameStatus = RX_FRAME_COMPLETE;
         }
         else
@@ -202,6 +224,12 @@ static uint16_t ibusReadRawRC(const rxRuntimeState_t *rxRuntimeState, uint8_t ch
     return ibusChannelData[chan];
 }
 
+static timeUs_t ibusFrameTimeUs(const rxRuntimeState_t *rxRuntimeState)
+{
+    UNUSED(rxRuntimeState);
+    return ibusRcFrameTimeUs;
+}
+
 
 bool ibusInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 {
@@ -213,6 +241,7 @@ bool ibusInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 
     rxRuntimeState->rcReadRawFn = ibusReadRawRC;
     rxRuntimeState->rcFrameStatusFn = ibusFrameStatus;
+    rxRuntimeState->rcFrameTimeUsFn = ibusFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
@@ -236,6 +265,13 @@ bool ibusInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
         (rxConfig->serialrx_inverted ? SERIAL_INVERTED : 0) | (rxConfig->halfDuplex || portShared ? SERIAL_BIDIR : 0)
         );
 
+#ifdef USE_SERIAL_RX_FRAMES
+    // With shared telemetry the echo of each reply is skipped by counting bytes, which needs the byte callback
+    if (ibusPort && !portShared) {
+        serialSetRxFrameCallback(ibusPort, ibusFrameReceive);
+    }
+#endif
+
 #if defined(USE_TELEMETRY) && defined(USE_TELEMETRY_IBUS)
     if (portShared) {
         initSharedIbusTelemetry(ibusPort);
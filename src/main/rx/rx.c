@@ -269,6 +269,7 @@ void rxInit(void)
     rxRuntimeState.rcReadRawFn = nullReadRawRC;
     rxRuntimeState.rcFrameStatusFn = nullFrameStatus;
     rxRuntimeState.rcProcessFrameFn = nullProcessFrame;
+    rxRuntimeState.rcFrameTimeUsFn = NULL;
     rcSampleIndex = 0;
     needRxSignalMaxDelayUs = DELAY_10_HZ;
 
@@ -497,6 +498,7 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
 
     if (signalReceived) {
         rxSignalReceived = true;
+        rxRuntimeState.lastRcFrameTimeUs = rxRuntimeState.rcFrameTimeUsFn ? rxRuntimeState.rcFrameTimeUsFn(&rxRuntimeState) : currentTimeUs;
     } else if (currentTimeUs >= needRxSignalBefore) {
         rxSignalReceived = false;
     }
@@ -677,6 +679,11 @@ bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs)
     return true;
 }
 
+timeUs_t rxFrameTimeUs(void)
+{
+    return rxRuntimeState.lastRcFrameTimeUs;
+}
+
 void parseRcChannels(const char *input, rxConfig_t *rxConfig)
 {
     for (const char *c = input; *c; c++) {
@@ -125,6 +125,7 @@ struct rxRuntimeState_s;
 typedef uint16_t (*rcReadRawDataFnPtr)(const struct rxRuntimeState_s *rxRuntimeState, uint8_t chan); // used by receiver driver to return channel data
 typedef uint8_t (*rcFrameStatusFnPtr)(struct rxRuntimeState_s *rxRuntimeState);
 typedef bool (*rcProcessFrameFnPtr)(const struct rxRuntimeState_s *rxRuntimeState);
+typedef timeUs_t (*rcGetFrameTimeUsFnPtr)(const struct rxRuntimeState_s *rxRuntimeState); // used by receiver driver to return when the last byte of the latest channel data frame arrived
 
 typedef enum {
     RX_PROVIDER_NONE = 0,
@@ -143,8 +144,10 @@ typedef struct rxRuntimeState_s {
     rcReadRawDataFnPtr  rcReadRawFn;
     rcFrameStatusFnPtr  rcFrameStatusFn;
     rcProcessFrameFnPtr rcProcessFrameFn;
+    rcGetFrameTimeUsFnPtr rcFrameTimeUsFn;  // optional, the RX task's time is used for receivers without it
     uint16_t            *channelData;
     void                *frameData;
+    timeUs_t            lastRcFrameTimeUs;  // when the latest channel data frame was received
 } rxRuntimeState_t;
 
 typedef enum {
@@ -173,6 +176,7 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 bool rxIsReceivingSignal(void);
 bool rxAreFlightChannelsValid(void);
 bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs);
+timeUs_t rxFrameTimeUs(void);
 
 struct rxConfig_s;
 
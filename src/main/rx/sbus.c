@@ -104,18 +104,14 @@ typedef union sbusFrame_u {
 typedef struct sbusFrameData_s {
     sbusFrame_t frame;
     uint32_t startAtUs;
+    timeUs_t doneAtUs;
     uint8_t position;
     bool done;
 } sbusFrameData_t;
 
 
-// Receive ISR callback
-static void sbusDataReceive(uint16_t c, void *data)
+static void sbusProcessByte(sbusFrameData_t *sbusFrameData, uint8_t c, timeUs_t nowUs)
 {
-    sbusFrameData_t *sbusFrameData = data;
-
-    const uint32_t nowUs = micros();
-
     const int32_t sbusFrameTime = nowUs - sbusFrameData->startAtUs;
 
     if (sbusFrameTime > (long)(SBUS_TIME_NEEDED_PER_FRAME + 500)) {
@@ -135,11 +131,33 @@ static void sbusDataReceive(uint16_t c, void *data)
             sbusFrameData->done = false;
         } else {
             sbusFrameData->done = true;
+            sbusFrameData->doneAtUs = nowUs;
             DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_TIME, sbusFrameTime);
         }
     }
 }
 
+// Receive ISR callback
+static void sbusDataReceive(uint16_t c, void *data)
+{
+    sbusProcessByte(data, c, micros());
+}
+
+#ifdef USE_SERIAL_RX_FRAMES
+// Idle line callback with everything received since the previous idle line, a gap between frames
+static void sbusFrameReceive(const serialRxFrame_t *frame, void *data)
+{
+    sbusFrameData_t *sbusFrameData = data;
+
+    sbusFrameData->position = 0;
+    for (int segment = 0; segment < 2; segment++) {
+        for (int i = 0; i < frame->length[segment]; i++) {
+            sbusProcessByte(sbusFrameData, frame->data[segment][i], frame->timeUs);
+        }
+    }
+}
+#endif
+
 static uint8_t sbusFrameStatus(rxRuntimeState_t *rxRuntimeState)
 {
     sbusFrameData_t *sbusFrameData = rxRuntimeState->frameData;
@@ -153,6 +171,13 @@ static uint8_t sbusFrameStatus(rxRuntimeState_t *rxRuntimeState)
     return sbusChannelsDecode(rxRuntimeState, &sbusFrameData->frame.frame.channels);
 }
 
+static timeUs_t sbusFrameTimeUs(const rxRuntimeState_t *rxRuntimeState)
+{
+    const sbusFrameData_t *sbusFrameData = rxRuntimeState->frameData;
+
+    return sbusFrameData->doneAtUs;
+}
+
 bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 {
     static uint16_t sbusChannelData[SBUS_MAX_CHANNEL];
@@ -174,6 +199,7 @@ bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
     }
 
     rxRuntimeState->rcFrameStatusFn = sbusFrameStatus;
+    rxRuntimeState->rcFrameTimeUsFn = sbusFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
@@ -195,6 +221,12 @@ bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
         SBUS_PORT_OPTIONS | (rxConfig->serialrx_inverted ? 0 : SERIAL_INVERTED) | (rxConfig->halfDuplex ? SERIAL_BIDIR : 0)
         );
 
+#ifdef USE_SERIAL_RX_FRAMES
+    if (sBusPort) {
+        serialSetRxFrameCallback(sBusPort, sbusFrameReceive);
+    }
+#endif
+
     if (rxConfig->rssi_src_frame_errors) {
         rssiSource = RSSI_SOURCE_FRAME_ERRORS;
     }
@@ -64,6 +64,7 @@ uint8_t rssi_channel;
 static uint8_t spek_chan_shift;
 static uint8_t spek_chan_mask;
 static bool rcFrameComplete = false;
+static timeUs_t rcFrameCompleteAtUs;
 static bool spekHiRes = false;
 
 static volatile uint8_t spekFrame[SPEK_FRAME_SIZE];
@@ -99,6 +100,7 @@ static void spektrumDataReceive(uint16_t c, void *data)
             rcFrameComplete = false;
         } else {
             rcFrameComplete = true;
+            rcFrameCompleteAtUs = spekTime;
         }
     }
 }
@@ -172,6 +174,13 @@ static uint8_t spektrumFrameStatus(rxRuntimeState_t *rxRuntimeState)
     return result;
 }
 
+static timeUs_t spektrumFrameTimeUs(const rxRuntimeState_t *rxRuntimeState)
+{
+    UNUSED(rxRuntimeState);
+
+    return rcFrameCompleteAtUs;
+}
+
 static uint16_t spektrumReadRawRC(const rxRuntimeState_t *rxRuntimeState, uint8_t chan)
 {
     uint16_t data;
@@ -388,6 +397,7 @@ bool spektrumInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 
     rxRuntimeState->rcReadRawFn = spektrumReadRawRC;
     rxRuntimeState->rcFrameStatusFn = spektrumFrameStatus;
+    rxRuntimeState->rcFrameTimeUsFn = spektrumFrameTimeUs;
 #if defined(USE_TELEMETRY_SRXL)
     rxRuntimeState->rcProcessFrameFn = spektrumProcessFrame;
 #endif
@@ -84,6 +84,7 @@ typedef union {
 
 struct rxBuf {
     volatile unsigned len;
+    uint32_t lastByteTimestamp;
     Srxl2Frame packet;
 };
 
@@ -96,6 +97,7 @@ static uint32_t fullTimeoutTimestamp = 0;
 static uint32_t lastValidPacketTimestamp = 0;
 static volatile uint32_t lastReceiveTimestamp = 0;
 static volatile uint32_t lastIdleTimestamp = 0;
+static uint32_t lastChannelDataTimestamp = 0;
 
 struct rxBuf readBuffer[2];
 struct rxBuf* readBufferPtr = &readBuffer[0];
@@ -191,6 +193,8 @@ void srxl2ProcessChannelData(const Srxl2ChannelDataHeader* channelData, rxRuntim
         channelMask &= ~mask;
     }
 
+    lastChannelDataTimestamp = processBufferPtr->lastByteTimestamp;
+
      DEBUG_PRINTF("channel data: %d %d %x\r\n", channelData_header->rssi, channelData_header->frameLosses, channelData_header->channelMask.u32);
 }
 
@@ -285,12 +289,8 @@ void srxl2Process(rxRuntimeState_t *rxRuntimeState)
 }
 
 
-static void srxl2DataReceive(uint16_t character, void *data)
+static void srxl2ReceiveByte(uint8_t character)
 {
-    UNUSED(data);
-
-    lastReceiveTimestamp = microsISR();
-
     //If the buffer len is not reset for whatever reason, disable reception
     if (readBufferPtr->len > 0 || readBufferIdx >= SRXL2_MAX_PACKET_LENGTH) {
         readBufferIdx = 0;
@@ -302,6 +302,31 @@ static void srxl2DataReceive(uint16_t character, void *data)
     }
 }
 
+static void srxl2DataReceive(uint16_t character, void *data)
+{
+    UNUSED(data);
+
+    lastReceiveTimestamp = microsISR();
+
+    srxl2ReceiveByte(character);
+}
+
+#ifdef USE_SERIAL_RX_FRAMES
+// Called just before srxl2Idle() with the bytes received since the previous idle line
+static void srxl2FrameReceive(const serialRxFrame_t *frame, void *data)
+{
+    UNUSED(data);
+
+    lastReceiveTimestamp = frame->timeUs;
+
+    for (int segment = 0; segment < 2; segment++) {
+        for (int i = 0; i < frame->length[segment]; i++) {
+            srxl2ReceiveByte(frame->data[segment][i]);
+        }
+    }
+}
+#endif
+
 static void srxl2Idle()
 {
     if(transmittingTelemetry) { // Transmitting telemetry triggers idle interrupt as well. We dont want to change buffers then
@@ -320,6 +345,7 @@ static void srxl2Idle()
             processBufferPtr = &readBuffer[0];
             readBufferPtr = &readBuffer[1];
         }
+        processBufferPtr->lastByteTimestamp = lastReceiveTimestamp;
         processBufferPtr->len = readBufferIdx;
     }
 
@@ -453,6 +479,13 @@ static bool srxl2ProcessFrame(const rxRuntimeState_t *rxRuntimeState)
     return true;
 }
 
+static timeUs_t srxl2FrameTimeUs(const rxRuntimeState_t *rxRuntimeState)
+{
+    UNUSED(rxRuntimeState);
+
+    return lastChannelDataTimestamp;
+}
+
 static uint16_t srxl2ReadRawRC(const rxRuntimeState_t *rxRuntimeState, uint8_t channelIdx)
 {
     if (channelIdx >= rxRuntimeState->channelCount) {
@@ -490,6 +523,7 @@ bool srxl2RxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
     rxRuntimeState->rcReadRawFn = srxl2ReadRawRC;
     rxRuntimeState->rcFrameStatusFn = srxl2FrameStatus;
     rxRuntimeState->rcProcessFrameFn = srxl2ProcessFrame;
+    rxRuntimeState->rcFrameTimeUsFn = srxl2FrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
@@ -512,6 +546,9 @@ bool srxl2RxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
     }
 
     serialPort->idleCallback = srxl2Idle;
+#ifdef USE_SERIAL_RX_FRAMES
+    serialSetRxFrameCallback(serialPort, srxl2FrameReceive);
+#endif
 
     state = ListenForActivity;
     timeoutTimestamp = micros() + SRXL2_LISTEN_FOR_ACTIVITY_TIMEOUT_US;
@@ -56,6 +56,7 @@
 #define SUMD_BAUDRATE 115200
 
 static bool sumdFrameDone = false;
+static timeUs_t sumdFrameDoneAtUs;
 static uint16_t sumdChannels[MAX_SUPPORTED_RC_CHANNEL_COUNT];
 static uint16_t crc;
 
@@ -96,6 +97,7 @@ static void sumdDataReceive(uint16_t c, void *data)
         if (sumdIndex == sumdChannelCount * 2 + 5) {
             sumdIndex = 0;
             sumdFrameDone = true;
+            sumdFrameDoneAtUs = sumdTime;
         }
 }
 
@@ -148,6 +150,12 @@ static uint8_t sumdFrameStatus(rxRuntimeState_t *rxRuntimeState)
     return frameStatus;
 }
 
+static timeUs_t sumdFrameTimeUs(const rxRuntimeState_t *rxRuntimeState)
+{
+    UNUSED(rxRuntimeState);
+    return sumdFrameDoneAtUs;
+}
+
 static uint16_t sumdReadRawRC(const rxRuntimeState_t *rxRuntimeState, uint8_t chan)
 {
     UNUSED(rxRuntimeState);
@@ -163,6 +171,7 @@ bool sumdInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 
     rxRuntimeState->rcReadRawFn = sumdReadRawRC;
     rxRuntimeState->rcFrameStatusFn = sumdFrameStatus;
+    rxRuntimeState->rcFrameTimeUsFn = sumdFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
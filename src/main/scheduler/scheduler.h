@@ -136,6 +136,18 @@ typedef enum {
     TASK_PINIOBOX,
 #endif
 
+#ifdef USE_FLASHFS_BACKGROUND_ERASE
+    TASK_FLASHFS,
+#endif
+
+#ifdef USE_MSP_STREAM
+    TASK_MSP_STREAM,
+#endif
+
+#ifdef USE_OSD_FONT_QUEUE
+    TASK_OSD_FONT,
+#endif
+
     /* Count of real tasks */
     TASK_COUNT,
 
@@ -35,6 +35,7 @@
 #include "pg/pg_ids.h"
 #include "pg/motor.h"
 
+#include "common/crc.h"
 #include "common/maths.h"
 #include "common/utils.h"
 
@@ -226,26 +227,9 @@ bool escSensorInit(void)
     return escSensorPort != NULL;
 }
 
-static uint8_t updateCrc8(uint8_t crc, uint8_t crc_seed)
-{
-    uint8_t crc_u = crc;
-    crc_u ^= crc_seed;
-
-    for (int i=0; i<8; i++) {
-        crc_u = ( crc_u & 0x80 ) ? 0x7 ^ ( crc_u << 1 ) : ( crc_u << 1 );
-    }
-
-    return (crc_u);
-}
-
 uint8_t calculateCrc8(const uint8_t *Buf, const uint8_t BufLen)
 {
-    uint8_t crc = 0;
-    for (int i = 0; i < BufLen; i++) {
-        crc = updateCrc8(Buf[i], crc);
-    }
-
-    return crc;
+    return crc8_poly_0x07_update(0, Buf, BufLen);
 }
 
 static uint8_t decodeEscFrame(void)
@@ -559,8 +559,10 @@ void FLASH_Lock(void) {
 }
 
 FLASH_Status FLASH_ErasePage(uintptr_t Page_Address) {
-    UNUSED(Page_Address);
-//    printf("[FLASH_ErasePage]%x\n", Page_Address);
+    if ((Page_Address >= (uintptr_t)eepromData) && (Page_Address + FLASH_PAGE_SIZE <= (uintptr_t)ARRAYEND(eepromData))) {
+        memset((void *)Page_Address, 0xFF, FLASH_PAGE_SIZE);
+//        printf("[FLASH_ErasePage]%p\n", (void*)Page_Address);
+    }
     return FLASH_COMPLETE;
 }
 
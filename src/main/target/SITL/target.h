@@ -44,6 +44,7 @@
 #define EEPROM_FILENAME "eeprom.bin"
 #define CONFIG_IN_FILE
 #define EEPROM_SIZE     32768
+#define FLASH_PAGE_SIZE (0x400)
 
 #define U_ID_0 0
 #define U_ID_1 1
@@ -198,6 +198,19 @@
 #define USE_FLASH_CHIP
 #endif
 
+#ifndef USE_FLASHFS
+#undef USE_FLASHFS_LOG_INDEX
+#endif
+
+#if !defined(USE_FLASHFS) || !defined(USE_MSP_STREAM)
+#undef USE_MSP_DATAFLASH_STREAM
+#endif
+
+#ifndef USE_FLASHFS_LOG_INDEX
+// The background erase keeps its progress in the log index
+#undef USE_FLASHFS_BACKGROUND_ERASE
+#endif
+
 #if defined(USE_MAX7456)
 #define USE_OSD
 #endif
@@ -208,6 +221,21 @@
 #undef USE_OSD_STICK_OVERLAY
 #endif
 
+#if !defined(USE_MAX7456)
+#undef USE_OSD_FRAME_SYNC
+#undef USE_OSD_FONT_QUEUE
+#endif
+
+#if !defined(USE_EXTI)
+// the frame clock comes from the VSYNC interrupt
+#undef USE_OSD_FRAME_SYNC
+#endif
+
+#if defined(STM32F1) || defined(STM32F3)
+// Frames are taken from the receive DMA on the idle line interrupt, which is only wired up for F4, F7 and H7
+#undef USE_SERIAL_RX_FRAMES
+#endif
+
 #if defined(USE_GPS_RESCUE)
 #define USE_GPS
 #endif
@@ -359,6 +387,10 @@ extern uint8_t __config_start;   // configured via linker script when building b
 extern uint8_t __config_end;
 #endif
 
+#if !defined(CONFIG_IN_FLASH) && !defined(CONFIG_IN_FILE)
+#undef USE_CONFIG_JOURNAL
+#endif
+
 #if defined(USE_EXST) && !defined(RAMBASED)
 #define USE_FLASH_BOOT_LOADER
 #endif
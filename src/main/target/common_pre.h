@@ -70,6 +70,7 @@
 #define USE_TIMER_MGMT
 #define USE_PERSISTENT_OBJECTS
 #define USE_CUSTOM_DEFAULTS_ADDRESS
+#define USE_CRC_HARDWARE
 // Re-enable this after 4.0 has been released, and remove the define from STM32F4DISCOVERY
 //#define USE_SPI_TRANSACTION
 
@@ -121,6 +122,7 @@
 #define USE_TIMER_MGMT
 #define USE_PERSISTENT_OBJECTS
 #define USE_DMA_RAM
+#define USE_CRC_HARDWARE
 #endif
 
 #if defined(STM32F4) || defined(STM32F7) || defined(STM32H7)
@@ -354,4 +356,20 @@
 #define USE_PROFILE_NAMES
 #define USE_SERIALRX_SRXL2     // Spektrum SRXL2 protocol
 #define USE_INTERPOLATED_SP
+#define USE_FLASHFS_LOG_INDEX
+#define USE_FLASHFS_BACKGROUND_ERASE
+#define USE_MSP_STREAM
+#define USE_MSP_PIPELINE
+#define USE_MSP_PG_TRANSFER
+#define USE_MSP_DATAFLASH_STREAM
+#define USE_CLI_VALUE_INDEX
+#define USE_CONFIG_JOURNAL
+#define USE_CRC_SLICE_BY_4
+#define USE_OSD_ELEMENT_REFRESH
+#define USE_MSP_DISPLAYPORT_BATCH
+#define USE_CMS_VALUE_CACHE
+#define USE_OSD_FRAME_SYNC
+#define USE_OSD_FONT_QUEUE
+#define USE_SERIAL_RX_FRAMES
+#define USE_RX_LATENCY
 #endif
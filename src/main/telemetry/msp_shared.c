@@ -28,6 +28,7 @@
 
 #include "build/build_config.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "msp/msp.h"
@@ -209,6 +210,8 @@ bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
 
         uint8_t size = sbufBytesRemaining(txBuf);
         sbufWriteU8(payloadBuf, size);
+
+        checksum = size ^ mspPackage.responsePacket->cmd;
     } else {
         // header
         sbufWriteU8(payloadBuf, (seq++ & TELEMETRY_MSP_SEQ_MASK));
@@ -216,29 +219,23 @@ bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
 
     const uint8_t bufferBytesRemaining = sbufBytesRemaining(txBuf);
     const uint8_t payloadBytesRemaining = sbufBytesRemaining(payloadBuf);
-    uint8_t frame[payloadBytesRemaining];
+    // Copy straight from the reply into the frame, checksumming what goes out as we go
+    const uint8_t chunkSize = MIN(bufferBytesRemaining, payloadBytesRemaining);
 
-    if (bufferBytesRemaining >= payloadBytesRemaining) {
+    for (int i = 0; i < chunkSize; i++) {
+        checksum ^= sbufPtr(txBuf)[i];
+    }
+    sbufWriteData(payloadBuf, sbufPtr(txBuf), chunkSize);
+    sbufAdvance(txBuf, chunkSize);
 
-        sbufReadData(txBuf, frame, payloadBytesRemaining);
-        sbufAdvance(txBuf, payloadBytesRemaining);
-        sbufWriteData(payloadBuf, frame, payloadBytesRemaining);
+    if (bufferBytesRemaining >= payloadBytesRemaining) {
         responseFn(payloadOut);
 
         return true;
 
     } else {
-
-        sbufReadData(txBuf, frame, bufferBytesRemaining);
-        sbufAdvance(txBuf, bufferBytesRemaining);
-        sbufWriteData(payloadBuf, frame, bufferBytesRemaining);
         sbufSwitchToReader(txBuf, mspPackage.responseBuffer);
 
-        checksum = sbufBytesRemaining(txBuf) ^ mspPackage.responsePacket->cmd;
-
-        while (sbufBytesRemaining(txBuf)) {
-            checksum ^= sbufReadU8(txBuf);
-        }
         sbufWriteU8(payloadBuf, checksum);
 
         while (sbufBytesRemaining(payloadBuf)>1) {
@@ -36,10 +36,13 @@
 #include "usb_pwr.h"
 
 #include <stdbool.h>
+#include <string.h>
+
 #include "drivers/system.h"
 #include "drivers/usb_io.h"
 #include "drivers/nvic.h"
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 
@@ -53,6 +56,7 @@ __IO uint32_t packetSent;                                     // HJI
 extern __IO uint32_t receiveLength;                          // HJI
 
 uint8_t receiveBuffer[64];                                   // HJI
+static uint8_t receiveOffset = 0;
 uint32_t sendLength;                                          // HJI
 static void IntToUnicode(uint32_t value, uint8_t *pbuf, uint8_t len);
 static void (*ctrlLineStateCb)(void *context, uint16_t ctrlLineState);
@@ -331,33 +335,38 @@ uint32_t CDC_Send_FreeBytes(void)
  *******************************************************************************/
 uint32_t CDC_Receive_DATA(uint8_t* recvBuf, uint32_t len)
 {
-    static uint8_t offset = 0;
-    uint8_t i;
+    const uint8_t *data;
 
-    if (len > receiveLength) {
-        len = receiveLength;
-    }
+    len = MIN(len, CDC_Receive_Peek(&data));
+    memcpy(recvBuf, data, len);
+    CDC_Receive_Skip(len);
 
-    for (i = 0; i < len; i++) {
-        recvBuf[i] = (uint8_t)(receiveBuffer[i + offset]);
-    }
+    return len;
+}
+
+uint32_t CDC_Receive_BytesAvailable(void)
+{
+    return receiveLength;
+}
+
+/* The received packet is contiguous, the endpoint is re-enabled once it has all been consumed */
+uint32_t CDC_Receive_Peek(const uint8_t **data)
+{
+    *data = &receiveBuffer[receiveOffset];
+    return receiveLength;
+}
 
+void CDC_Receive_Skip(uint32_t len)
+{
     receiveLength -= len;
-    offset += len;
+    receiveOffset += len;
 
     /* re-enable the rx endpoint which we had set to receive 0 bytes */
     if (receiveLength == 0) {
         SetEPRxCount(ENDP3, 64);
         SetEPRxStatus(ENDP3, EP_RX_VALID);
-        offset = 0;
+        receiveOffset = 0;
     }
-
-    return len;
-}
-
-uint32_t CDC_Receive_BytesAvailable(void)
-{
-    return receiveLength;
 }
 
 /*******************************************************************************
@@ -57,6 +57,7 @@
 #include "usbd_cdc.h"
 #include "usbd_cdc_interface.h"
 #include "stdbool.h"
+#include <string.h>
 
 #include "drivers/nvic.h"
 #include "drivers/serial_usb_vcp.h"
@@ -351,19 +352,13 @@ static void Error_Handler(void)
 
 uint32_t CDC_Receive_DATA(uint8_t* recvBuf, uint32_t len)
 {
-    uint32_t count = 0;
-    if ( (rxBuffPtr != NULL))
-    {
-        while ((rxAvailable > 0) && count < len)
-        {
-            recvBuf[count] = rxBuffPtr[0];
-            rxBuffPtr++;
-            rxAvailable--;
-            count++;
-            if (rxAvailable < 1)
-                USBD_CDC_ReceivePacket(&USBD_Device);
-        }
-    }
+    const uint8_t *data;
+    const uint32_t available = CDC_Receive_Peek(&data);
+    const uint32_t count = available < len ? available : len;
+
+    memcpy(recvBuf, data, count);
+    CDC_Receive_Skip(count);
+
     return count;
 }
 
@@ -372,6 +367,24 @@ uint32_t CDC_Receive_BytesAvailable(void)
     return rxAvailable;
 }
 
+/* The received packet is contiguous, the next one is requested once it has all been consumed */
+uint32_t CDC_Receive_Peek(const uint8_t **data)
+{
+    *data = rxBuffPtr;
+    return rxBuffPtr ? rxAvailable : 0;
+}
+
+void CDC_Receive_Skip(uint32_t len)
+{
+    if (rxBuffPtr && len > 0) {
+        rxBuffPtr += len;
+        rxAvailable -= len;
+        if (rxAvailable < 1) {
+            USBD_CDC_ReceivePacket(&USBD_Device);
+        }
+    }
+}
+
 uint32_t CDC_Send_FreeBytes(void)
 {
     /*
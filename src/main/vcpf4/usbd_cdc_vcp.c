@@ -26,6 +26,7 @@
 #include "usbd_cdc_vcp.h"
 #include "stm32f4xx_conf.h"
 #include "stdbool.h"
+#include <string.h>
 #include "drivers/time.h"
 
 #ifdef USB_OTG_HS_INTERNAL_DMA_ENABLED
@@ -236,10 +237,15 @@ uint32_t CDC_Receive_DATA(uint8_t* recvBuf, uint32_t len)
 {
     uint32_t count = 0;
 
-    while (APP_Tx_ptr_out != APP_Tx_ptr_in && count < len) {
-        recvBuf[count] = APP_Tx_Buffer[APP_Tx_ptr_out];
-        APP_Tx_ptr_out = (APP_Tx_ptr_out + 1) % APP_TX_DATA_SIZE;
-        count++;
+    /* up to the end of the circular buffer, then from its start */
+    for (int segment = 0; segment < 2 && count < len; segment++) {
+        const uint8_t *data;
+        const uint32_t available = CDC_Receive_Peek(&data);
+        const uint32_t chunk = available < len - count ? available : len - count;
+
+        memcpy(recvBuf + count, data, chunk);
+        CDC_Receive_Skip(chunk);
+        count += chunk;
     }
     return count;
 }
@@ -250,6 +256,20 @@ uint32_t CDC_Receive_BytesAvailable(void)
     return APP_Tx_ptr_out > APP_Tx_ptr_in ? APP_TX_DATA_SIZE - APP_Tx_ptr_out + APP_Tx_ptr_in : APP_Tx_ptr_in - APP_Tx_ptr_out;
 }
 
+/* Received bytes which follow *data in the circular buffer before it wraps, consumed with CDC_Receive_Skip() */
+uint32_t CDC_Receive_Peek(const uint8_t **data)
+{
+    const uint32_t ptrIn = APP_Tx_ptr_in;
+
+    *data = &APP_Tx_Buffer[APP_Tx_ptr_out];
+    return (ptrIn >= APP_Tx_ptr_out ? ptrIn : APP_TX_DATA_SIZE) - APP_Tx_ptr_out;
+}
+
+void CDC_Receive_Skip(uint32_t len)
+{
+    APP_Tx_ptr_out = (APP_Tx_ptr_out + len) % APP_TX_DATA_SIZE;
+}
+
 /**
  * @brief  VCP_DataRx
  *         Data received over USB OUT endpoint are sent over CDC interface
@@ -0,0 +1,535 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "drivers/sdcard.h"
+
+    #include "io/asyncfatfs/asyncfatfs.h"
+    #include "io/asyncfatfs/fat_standard.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+/*
+ * Simulated SD card holding a freshly formatted FAT16 or FAT32 volume with one sector per cluster, so a supercluster is
+ * 256 (FAT16) or 128 (FAT32) sectors.
+ *
+ * Every write keeps the card busy for SIM_WRITE_BUSY_POLLS polls, and starting a new multi-block write keeps it busy
+ * for SIM_MULTI_WRITE_START_POLLS polls to model the command overhead and the pre-erase.
+ */
+
+#define SIM_SECTOR_SIZE             512
+#define SIM_PARTITION_START         1
+#define SIM_RESERVED_SECTORS        1
+
+#define SIM_FAT16_CLUSTERS          8192
+#define SIM_FAT16_ROOT_ENTRIES      512
+#define SIM_FAT32_CLUSTERS          66000
+
+#define SIM_FAT_SECTORS_FOR(clusters, entrySize) (((clusters) + 2) * (entrySize) / SIM_SECTOR_SIZE + 1)
+#define SIM_MAX_SECTORS             (SIM_PARTITION_START + SIM_RESERVED_SECTORS + 2 * SIM_FAT_SECTORS_FOR(SIM_FAT32_CLUSTERS, 4) + SIM_FAT32_CLUSTERS)
+
+#define SIM_WRITE_BUSY_POLLS        2
+#define SIM_MULTI_WRITE_START_POLLS 4
+
+static uint8_t simDisk[SIM_MAX_SECTORS * SIM_SECTOR_SIZE];
+
+static bool simFat32;
+static uint32_t simClusters;
+static uint32_t simFatSectors;
+static uint32_t simSectors;
+
+static int simBusyPolls;
+static sdcardBlockOperation_e simPendingOperation;
+static uint32_t simPendingBlock;
+static uint8_t *simPendingBuffer;
+static sdcard_operationCompleteCallback_c simPendingCallback;
+
+static bool simMultiWriteActive;
+static uint32_t simMultiWriteNextBlock;
+static uint32_t simMultiWriteRemain;
+
+static int simBlocksWritten;
+static int simMultiWriteStarts;
+static int simFatReads;
+
+static afatfsFilePtr_t openedFile;
+static bool fileClosed;
+static bool fileUnlinked;
+
+static void simSetFATEntry(uint32_t cluster, uint32_t value)
+{
+    for (int fat = 0; fat < 2; fat++) {
+        uint8_t *fatStart = simDisk + (SIM_PARTITION_START + SIM_RESERVED_SECTORS + fat * simFatSectors) * SIM_SECTOR_SIZE;
+
+        if (simFat32) {
+            ((uint32_t *)fatStart)[cluster] = value;
+        } else {
+            ((uint16_t *)fatStart)[cluster] = value;
+        }
+    }
+}
+
+static void simFormat(bool fat32)
+{
+    const uint32_t rootEntries = fat32 ? 0 : SIM_FAT16_ROOT_ENTRIES;
+
+    simFat32 = fat32;
+    simClusters = fat32 ? SIM_FAT32_CLUSTERS : SIM_FAT16_CLUSTERS;
+    simFatSectors = SIM_FAT_SECTORS_FOR(simClusters, fat32 ? sizeof(uint32_t) : sizeof(uint16_t));
+
+    const uint32_t volumeSectors = SIM_RESERVED_SECTORS + 2 * simFatSectors + rootEntries * 32 / SIM_SECTOR_SIZE + simClusters;
+    simSectors = SIM_PARTITION_START + volumeSectors;
+
+    memset(simDisk, 0, sizeof(simDisk));
+
+    // MBR
+    mbrPartitionEntry_t *partition = (mbrPartitionEntry_t *)(simDisk + 446);
+    partition->type = fat32 ? MBR_PARTITION_TYPE_FAT32 : MBR_PARTITION_TYPE_FAT16;
+    partition->lbaBegin = SIM_PARTITION_START;
+    partition->numSectors = volumeSectors;
+    simDisk[510] = 0x55;
+    simDisk[511] = 0xAA;
+
+    // Volume ID
+    uint8_t *volumeSector = simDisk + SIM_PARTITION_START * SIM_SECTOR_SIZE;
+    fatVolumeID_t *volume = (fatVolumeID_t *)volumeSector;
+    volume->bytesPerSector = SIM_SECTOR_SIZE;
+    volume->sectorsPerCluster = 1;
+    volume->reservedSectorCount = SIM_RESERVED_SECTORS;
+    volume->numFATs = 2;
+    volume->rootEntryCount = rootEntries;
+    volume->totalSectors32 = volumeSectors;
+    if (fat32) {
+        volume->fatDescriptor.fat32.FATSize32 = simFatSectors;
+        volume->fatDescriptor.fat32.rootCluster = 2;
+    } else {
+        volume->FATSize16 = simFatSectors;
+    }
+    volumeSector[510] = FAT_VOLUME_ID_SIGNATURE_1;
+    volumeSector[511] = FAT_VOLUME_ID_SIGNATURE_2;
+
+    // The first two FAT entries are reserved, and the FAT32 root directory takes the first cluster
+    if (fat32) {
+        simSetFATEntry(0, 0x0FFFFFF8);
+        simSetFATEntry(1, 0x0FFFFFFF);
+        simSetFATEntry(2, 0x0FFFFFFF);
+    } else {
+        simSetFATEntry(0, 0xFFF8);
+        simSetFATEntry(1, 0xFFFF);
+    }
+}
+
+// Mark the clusters [firstCluster...endCluster) as in use by some files we don't know about
+static void simOccupyClusters(uint32_t firstCluster, uint32_t endCluster)
+{
+    for (uint32_t cluster = firstCluster; cluster < endCluster; cluster++) {
+        simSetFATEntry(cluster, simFat32 ? 0x0FFFFFFF : 0xFFFF);
+    }
+}
+
+static void simReset(void)
+{
+    simBusyPolls = 0;
+    simPendingCallback = NULL;
+    simMultiWriteActive = false;
+    simBlocksWritten = 0;
+    simMultiWriteStarts = 0;
+    simFatReads = 0;
+}
+
+static void poll(void)
+{
+    afatfs_poll();
+}
+
+static void fileOpened(afatfsFilePtr_t file)
+{
+    openedFile = file;
+}
+
+static void fileClosedCallback(void)
+{
+    fileClosed = true;
+}
+
+static void fileUnlinkedCallback(void)
+{
+    fileUnlinked = true;
+}
+
+static uint8_t patternByte(uint32_t offset)
+{
+    return (offset * 7 + (offset >> 9)) & 0xFF;
+}
+
+class AsyncFatfsTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        simFormat(false);
+        mount();
+    }
+
+    virtual void TearDown() {
+        unmount();
+    }
+
+    void mount(void) {
+        simReset();
+
+        afatfs_init();
+        for (int i = 0; i < 2000000 && afatfs_getFilesystemState() == AFATFS_FILESYSTEM_STATE_INITIALIZATION; i++) {
+            poll();
+        }
+        ASSERT_EQ(AFATFS_FILESYSTEM_STATE_READY, afatfs_getFilesystemState());
+
+        simReset();
+    }
+
+    void unmount(void) {
+        while (!afatfs_destroy(false)) {
+            poll();
+        }
+    }
+
+    afatfsFilePtr_t openFile(const char *name, const char *mode) {
+        openedFile = NULL;
+        EXPECT_TRUE(afatfs_fopen(name, mode, fileOpened));
+        for (int i = 0; i < 10000 && !openedFile; i++) {
+            poll();
+        }
+        return openedFile;
+    }
+
+    void closeFile(afatfsFilePtr_t file) {
+        fileClosed = false;
+        for (int i = 0; i < 10000 && !afatfs_fclose(file, fileClosedCallback); i++) {
+            poll();
+        }
+        for (int i = 0; i < 10000 && !fileClosed; i++) {
+            poll();
+        }
+        EXPECT_TRUE(fileClosed);
+        while (!afatfs_flush()) {
+            poll();
+        }
+    }
+
+    void unlinkFile(afatfsFilePtr_t file) {
+        fileUnlinked = false;
+        for (int i = 0; i < 10000 && !afatfs_funlink(file, fileUnlinkedCallback); i++) {
+            poll();
+        }
+        for (int i = 0; i < 10000 && !fileUnlinked; i++) {
+            poll();
+        }
+        EXPECT_TRUE(fileUnlinked);
+        while (!afatfs_flush()) {
+            poll();
+        }
+    }
+
+    // Write size bytes of the test pattern to the file, returns how many bytes the filesystem accepted
+    uint32_t writePattern(afatfsFilePtr_t file, uint32_t size) {
+        uint32_t written = 0;
+        int stall = 0;
+        while (written < size && stall < 10000) {
+            uint8_t chunk[256];
+            const uint32_t chunkSize = MIN(sizeof(chunk), size - written);
+            for (uint32_t i = 0; i < chunkSize; i++) {
+                chunk[i] = patternByte(written + i);
+            }
+
+            const uint32_t accepted = afatfs_fwrite(file, chunk, chunkSize);
+            written += accepted;
+            stall = accepted ? 0 : stall + 1;
+
+            poll();
+        }
+        return written;
+    }
+
+    void expectPattern(afatfsFilePtr_t file, uint32_t size) {
+        uint32_t readBack = 0;
+        for (int i = 0; i < 100000 && readBack < size; i++) {
+            uint8_t buffer[128];
+            const uint32_t bytesRead = afatfs_fread(file, buffer, sizeof(buffer));
+            for (uint32_t j = 0; j < bytesRead; j++) {
+                ASSERT_EQ(patternByte(readBack + j), buffer[j]);
+            }
+            readBack += bytesRead;
+            poll();
+        }
+        EXPECT_EQ(size, readBack);
+        EXPECT_TRUE(afatfs_feof(file));
+    }
+
+    void checkSearchSkipsFullFatSectors(bool fat32);
+};
+
+TEST_F(AsyncFatfsTest, ContiguousAppendStreamsSectors)
+{
+    const uint32_t fileSize = 1024 * SIM_SECTOR_SIZE; // 4 superclusters
+
+    afatfsFilePtr_t file = openFile("LOG00001.BFL", "as");
+    ASSERT_TRUE(file != NULL);
+
+    // Write like the blackbox does, small chunks with a poll of the filesystem in between
+    uint32_t written = 0;
+    int longestStall = 0;
+    int stall = 0;
+    while (written < fileSize) {
+        uint8_t chunk[256];
+        const uint32_t chunkSize = MIN(sizeof(chunk), fileSize - written);
+        for (uint32_t i = 0; i < chunkSize; i++) {
+            chunk[i] = patternByte(written + i);
+        }
+
+        const uint32_t accepted = afatfs_fwrite(file, chunk, chunkSize);
+        written += accepted;
+
+        stall = accepted ? 0 : stall + 1;
+        longestStall = MAX(longestStall, stall);
+        ASSERT_LT(stall, 1000);
+
+        poll();
+    }
+    closeFile(file);
+
+    EXPECT_GE(simBlocksWritten, (int)(fileSize / SIM_SECTOR_SIZE));
+
+    // The data sectors stream out in one multi-block write per supercluster, the card never holds the writer up for long
+    EXPECT_LE(simMultiWriteStarts, 4);
+    EXPECT_LT(longestStall, 20);
+
+    // Read it back
+    file = openFile("LOG00001.BFL", "r");
+    ASSERT_TRUE(file != NULL);
+
+    uint32_t readBack = 0;
+    for (int i = 0; i < 100000 && readBack < fileSize; i++) {
+        uint8_t buffer[128];
+        const uint32_t bytesRead = afatfs_fread(file, buffer, sizeof(buffer));
+        for (uint32_t j = 0; j < bytesRead; j++) {
+            ASSERT_EQ(patternByte(readBack + j), buffer[j]);
+        }
+        readBack += bytesRead;
+        poll();
+    }
+    EXPECT_EQ(fileSize, readBack);
+    EXPECT_TRUE(afatfs_feof(file));
+
+    closeFile(file);
+}
+
+void AsyncFatfsTest::checkSearchSkipsFullFatSectors(bool fat32)
+{
+    unmount();
+
+    // Fill all but the last few superclusters of the volume so that the free space is a long way into the FAT
+    simFormat(fat32);
+    const uint32_t entriesPerFatSector = SIM_SECTOR_SIZE / (fat32 ? sizeof(uint32_t) : sizeof(uint16_t));
+    const uint32_t firstFreeCluster = (simFatSectors - 4) * entriesPerFatSector;
+    simOccupyClusters(fat32 ? 3 : 2, firstFreeCluster);
+
+    // Mounting reads the whole FAT once while it looks for space for the freefile
+    mount();
+
+    // So finding free clusters for a regular file doesn't need to read those full FAT sectors again
+    const uint32_t fileSize = 8 * SIM_SECTOR_SIZE;
+
+    afatfsFilePtr_t file = openFile("DATA.TXT", "w");
+    ASSERT_TRUE(file != NULL);
+    EXPECT_EQ(fileSize, writePattern(file, fileSize));
+    closeFile(file);
+
+    EXPECT_LE(simFatReads, 4);
+
+    file = openFile("DATA.TXT", "r");
+    ASSERT_TRUE(file != NULL);
+    expectPattern(file, fileSize);
+    closeFile(file);
+}
+
+TEST_F(AsyncFatfsTest, SearchSkipsFullFatSectorsFAT16)
+{
+    checkSearchSkipsFullFatSectors(false);
+}
+
+TEST_F(AsyncFatfsTest, SearchSkipsFullFatSectorsFAT32)
+{
+    checkSearchSkipsFullFatSectors(true);
+}
+
+TEST_F(AsyncFatfsTest, FreedClustersAreFoundAgain)
+{
+    unmount();
+
+    // Leave just one small hole of free clusters in the middle of the volume, too small to build a freefile from
+    const uint32_t holeStart = 4096;
+    const uint32_t holeClusters = 16;
+
+    simFormat(false);
+    simOccupyClusters(2, holeStart);
+    simOccupyClusters(holeStart + holeClusters, SIM_FAT16_CLUSTERS + 2);
+
+    mount();
+
+    // Fill the hole
+    afatfsFilePtr_t file = openFile("FIRST.TXT", "w");
+    ASSERT_TRUE(file != NULL);
+    EXPECT_EQ(holeClusters * SIM_SECTOR_SIZE, writePattern(file, holeClusters * SIM_SECTOR_SIZE));
+
+    // Now the volume is full
+    EXPECT_LT(writePattern(file, SIM_SECTOR_SIZE), (uint32_t)SIM_SECTOR_SIZE);
+    EXPECT_TRUE(afatfs_isFull());
+
+    // Deleting the file must make its clusters available again, even though we once saw their FAT sector full
+    unlinkFile(file);
+
+    file = openFile("SECOND.TXT", "w");
+    ASSERT_TRUE(file != NULL);
+    EXPECT_EQ(holeClusters * SIM_SECTOR_SIZE, writePattern(file, holeClusters * SIM_SECTOR_SIZE));
+    closeFile(file);
+
+    file = openFile("SECOND.TXT", "r");
+    ASSERT_TRUE(file != NULL);
+    expectPattern(file, holeClusters * SIM_SECTOR_SIZE);
+    closeFile(file);
+}
+
+// STUBS
+
+extern "C" {
+
+static void simEndMultiWrite(void)
+{
+    simMultiWriteActive = false;
+}
+
+bool sdcard_poll(void)
+{
+    if (simBusyPolls > 0) {
+        simBusyPolls--;
+        return false;
+    }
+
+    if (simPendingCallback) {
+        sdcard_operationCompleteCallback_c callback = simPendingCallback;
+        simPendingCallback = NULL;
+        callback(simPendingOperation, simPendingBlock, simPendingBuffer, 0);
+    }
+
+    return true;
+}
+
+bool sdcard_readBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData)
+{
+    UNUSED(callbackData);
+
+    if (simBusyPolls > 0 || simPendingCallback) {
+        return false;
+    }
+
+    simEndMultiWrite();
+
+    EXPECT_LT(blockIndex, simSectors);
+    memcpy(buffer, simDisk + blockIndex * SIM_SECTOR_SIZE, SIM_SECTOR_SIZE);
+
+    if (blockIndex >= SIM_PARTITION_START + SIM_RESERVED_SECTORS && blockIndex < SIM_PARTITION_START + SIM_RESERVED_SECTORS + simFatSectors) {
+        simFatReads++;
+    }
+
+    simPendingOperation = SDCARD_BLOCK_OPERATION_READ;
+    simPendingBlock = blockIndex;
+    simPendingBuffer = buffer;
+    simPendingCallback = callback;
+    simBusyPolls = 1;
+
+    return true;
+}
+
+sdcardOperationStatus_e sdcard_beginWriteBlocks(uint32_t blockIndex, uint32_t blockCount)
+{
+    if (simBusyPolls > 0 || simPendingCallback) {
+        return SDCARD_OPERATION_BUSY;
+    }
+
+    if (simMultiWriteActive && blockIndex == simMultiWriteNextBlock) {
+        return SDCARD_OPERATION_SUCCESS;
+    }
+
+    simMultiWriteActive = true;
+    simMultiWriteNextBlock = blockIndex;
+    simMultiWriteRemain = blockCount;
+    simMultiWriteStarts++;
+    simBusyPolls = SIM_MULTI_WRITE_START_POLLS;
+
+    return SDCARD_OPERATION_SUCCESS;
+}
+
+sdcardOperationStatus_e sdcard_writeBlock(uint32_t blockIndex, uint8_t *buffer, sdcard_operationCompleteCallback_c callback, uint32_t callbackData)
+{
+    UNUSED(callbackData);
+
+    if (simBusyPolls > 0 || simPendingCallback) {
+        return SDCARD_OPERATION_BUSY;
+    }
+
+    if (simMultiWriteActive) {
+        if (blockIndex == simMultiWriteNextBlock) {
+            simMultiWriteNextBlock++;
+            if (--simMultiWriteRemain == 0) {
+                simEndMultiWrite();
+            }
+        } else {
+            simEndMultiWrite();
+        }
+    }
+
+    EXPECT_NE(0u, blockIndex);
+    EXPECT_LT(blockIndex, simSectors);
+    memcpy(simDisk + blockIndex * SIM_SECTOR_SIZE, buffer, SIM_SECTOR_SIZE);
+    simBlocksWritten++;
+
+    simPendingOperation = SDCARD_BLOCK_OPERATION_WRITE;
+    simPendingBlock = blockIndex;
+    simPendingBuffer = buffer;
+    simPendingCallback = callback;
+    simBusyPolls = SIM_WRITE_BUSY_POLLS;
+
+    return SDCARD_OPERATION_IN_PROGRESS;
+}
+
+bool sdcard_isInserted(void) { return true; }
+bool sdcard_isInitialized(void) { return true; }
+bool sdcard_isFunctional(void) { return true; }
+void sdcard_setProfilerCallback(sdcard_profilerCallback_c callback) { UNUSED(callback); }
+
+}
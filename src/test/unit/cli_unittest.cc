@@ -33,6 +33,7 @@ extern "C" {
     #include "drivers/buf_writer.h"
     #include "drivers/vtx_common.h"
     #include "config/config.h"
+    #include "fc/init.h"
     #include "fc/rc_adjustments.h"
     #include "fc/runtime_config.h"
     #include "flight/mixer.h"
@@ -59,11 +60,15 @@ extern "C" {
     void *cliGetValuePointer(const clivalue_t *value);
     
     const clivalue_t valueTable[] = {
-        { "array_unit_test",   VAR_INT8  | MODE_ARRAY  | MASTER_VALUE, .config.array.length = 3,      PG_RESERVED_FOR_TESTING_1, 0 },
-        { "str_unit_test",     VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config.string = { 0, 16, 0 }, PG_RESERVED_FOR_TESTING_1, 0 },
-        { "wos_unit_test",     VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config.string = { 0, 16, STRING_FLAGS_WRITEONCE }, PG_RESERVED_FOR_TESTING_1, 0 },
+        { "array_unit_test",   VAR_INT8  | MODE_ARRAY  | MASTER_VALUE, .config = { .array = { .length = 3 } }, PG_RESERVED_FOR_TESTING_1, 0 },
+        { "str_unit_test",     VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config = { .string = { 0, 16, 0 } }, PG_RESERVED_FOR_TESTING_1, 0 },
+        { "wos_unit_test",     VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config = { .string = { 0, 16, STRING_FLAGS_WRITEONCE } }, PG_RESERVED_FOR_TESTING_1, 0 },
+        { "str_unit",          VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config = { .string = { 0, 16, 0 } }, PG_RESERVED_FOR_TESTING_1, 0 },
+        { "abc_unit_test",     VAR_INT8  | MODE_ARRAY  | MASTER_VALUE, .config = { .array = { .length = 3 } }, PG_RESERVED_FOR_TESTING_1, 0 },
+        { "name",              VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config = { .string = { 1, MAX_NAME_LENGTH, STRING_FLAGS_NONE } }, PG_PILOT_CONFIG, offsetof(pilotConfig_t, name) },
     };
     const uint16_t valueTableEntryCount = ARRAYLEN(valueTable);
+    uint16_t valueTableNameOrder[ARRAYLEN(valueTable)];
     const lookupTableEntry_t lookupTables[] = {};
 
 
@@ -87,6 +92,17 @@ extern "C" {
     PG_REGISTER(pidConfig_t, pidConfig, PG_PID_CONFIG, 0);
 
     PG_REGISTER_WITH_RESET_FN(int8_t, unitTestData, PG_RESERVED_FOR_TESTING_1, 0);
+
+    // Configuration as saved in the EEPROM, read back by readEEPROM()
+    pilotConfig_t savedPilotConfig;
+    int readEEPROMCount;
+    int parseLedStripConfigEntryCount;
+    int reevaluateLedConfigCount;
+
+    // CLI input and output
+    const char *cliInput;
+    char cliOutput[4096];
+    size_t cliOutputLength;
 }
 
 #include "unittest_macros.h"
@@ -119,6 +135,24 @@ TEST(CLIUnittest, TestCliSetArray)
     //EXPECT_EQ(false, false);
 }
 
+TEST(CLIUnittest, TestCliGetSettingIndex)
+{
+    EXPECT_EQ(1, cliGetSettingIndex((char *)"str_unit_test", 13));
+    EXPECT_EQ(1, cliGetSettingIndex((char *)"STR_Unit_Test = 1", 13));
+    EXPECT_EQ(2, cliGetSettingIndex((char *)"wos_unit_test", 13));
+
+    // Entries out of name order are found too
+    EXPECT_EQ(0, cliGetSettingIndex((char *)"array_unit_test", 15));
+    EXPECT_EQ(4, cliGetSettingIndex((char *)"abc_unit_test", 13));
+
+    // Only whole names match
+    EXPECT_EQ(3, cliGetSettingIndex((char *)"str_unit", 8));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"str_uni", 7));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"abc", 3));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"str_unit_test_x", 15));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"no_such_setting", 15));
+}
+
 TEST(CLIUnittest, TestCliSetStringNoFlags)
 {
     char *str = (char *)"str_unit_test    =   SAMPLE"; 
@@ -195,6 +229,97 @@ TEST(CLIUnittest, TestCliSetStringWriteOnce)
     printf("\n");
 }
 
+static void cliTestEnter(void)
+{
+    static serialPort_t cliTestPort;
+
+    memset(pilotConfigMutable(), 0, sizeof(pilotConfig_t));
+    strcpy(pilotConfigMutable()->name, "SAVED");
+    savedPilotConfig = *pilotConfig();
+
+    readEEPROMCount = 0;
+    parseLedStripConfigEntryCount = 0;
+    reevaluateLedConfigCount = 0;
+
+    cliEnter(&cliTestPort);
+}
+
+static void cliTestRun(const char *input)
+{
+    cliInput = input;
+    cliOutputLength = 0;
+    memset(cliOutput, 0, sizeof(cliOutput));
+
+    cliProcess();
+}
+
+TEST(CLIUnittest, TestCliBatchWithErrorRollsBack)
+{
+    cliTestEnter();
+
+    cliTestRun("batch start\r"
+        "set name = CHANGED\r"
+        "led 0 0,0::C:1\r"
+        "no_such_command\r"
+        "set name = CHANGED_AGAIN\r");
+
+    // Commands after the failing one still run while the batch is open
+    EXPECT_STREQ("CHANGED_AGAIN", pilotConfig()->name);
+    EXPECT_EQ(1, parseLedStripConfigEntryCount);
+    EXPECT_EQ(0, reevaluateLedConfigCount);
+    EXPECT_EQ(0, readEEPROMCount);
+
+    cliTestRun("batch end\r");
+
+    // The saved settings are loaded back and the LED layout is worked out again for them
+    EXPECT_EQ(1, readEEPROMCount);
+    EXPECT_STREQ("SAVED", pilotConfig()->name);
+    EXPECT_EQ(1, reevaluateLedConfigCount);
+
+    // The failing command was the third line of the batch
+    EXPECT_NE(nullptr, strstr(cliOutput, "###ERROR: 1 COMMAND(S) FAILED, IN BATCH LINE(S): 3###"));
+    EXPECT_NE(nullptr, strstr(cliOutput, "CONFIGURATION ROLLED BACK TO THE SAVED SETTINGS"));
+
+    // The batch is closed, so a failing command now leaves the settings alone
+    cliTestRun("set name = AFTER\rno_such_command\r");
+    EXPECT_STREQ("AFTER", pilotConfig()->name);
+    EXPECT_EQ(1, readEEPROMCount);
+}
+
+TEST(CLIUnittest, TestCliBatchReportsEveryFailingLine)
+{
+    cliTestEnter();
+
+    cliTestRun("batch start\r"
+        "no_such_command\r"
+        "set name = CHANGED\r"
+        "set no_such_setting = 1\r"
+        "batch end\r");
+
+    EXPECT_NE(nullptr, strstr(cliOutput, "###ERROR: 2 COMMAND(S) FAILED, IN BATCH LINE(S): 1 3###"));
+    EXPECT_EQ(1, readEEPROMCount);
+    EXPECT_STREQ("SAVED", pilotConfig()->name);
+
+    // No LED change in the batch, nothing to re-apply
+    EXPECT_EQ(0, reevaluateLedConfigCount);
+}
+
+TEST(CLIUnittest, TestCliBatchWithoutErrorKeepsSettings)
+{
+    cliTestEnter();
+
+    cliTestRun("batch start\r"
+        "set name = CHANGED\r"
+        "led 0 0,0::C:1\r"
+        "batch end\r");
+
+    EXPECT_NE(nullptr, strstr(cliOutput, "Command batch ended"));
+    EXPECT_EQ(nullptr, strstr(cliOutput, "###ERROR"));
+    EXPECT_EQ(0, readEEPROMCount);
+    EXPECT_STREQ("CHANGED", pilotConfig()->name);
+    EXPECT_EQ(1, reevaluateLedConfigCount);
+}
+
 // STUBS
 extern "C" {
 
@@ -270,6 +395,8 @@ void bufWriterFlush(bufWriter_t *) {}
 void mixerResetDisarmedMotors(void) {}
 void gpsEnablePassthrough(struct serialPort_s *) {}
 bool parseLedStripConfig(int, const char *){return false; }
+bool parseLedStripConfigEntry(int, const char *) { parseLedStripConfigEntryCount++; return true; }
+void reevaluateLedConfig(void) { reevaluateLedConfigCount++; }
 const char rcChannelLetters[] = "AERT12345678abcdefgh";
 
 void parseRcChannels(const char *, rxConfig_t *){}
@@ -282,6 +409,12 @@ uint8_t getCurrentControlRateProfileIndex(void){ return 1; }
 void changeControlRateProfile(uint8_t) {}
 void resetAllRxChannelRangeConfigurations(rxChannelRangeConfig_t *) {}
 void writeEEPROM() {}
+bool readEEPROM(void)
+{
+    readEEPROMCount++;
+    *pilotConfigMutable() = savedPilotConfig;
+    return true;
+}
 serialPortConfig_t *serialFindPortConfiguration(serialPortIdentifier_e) {return NULL; }
 baudRate_e lookupBaudRateIndex(uint32_t){return BAUD_9600; }
 serialPortUsage_t *findSerialPortUsageByIdentifier(serialPortIdentifier_e){ return NULL; }
@@ -297,6 +430,7 @@ const char * getBatteryStateString(void){ return "_getBatteryStateString_"; }
 uint32_t stackTotalSize(void) { return 0x4000; }
 uint32_t stackHighMem(void) { return 0x80000000; }
 uint16_t getEEPROMConfigSize(void) { return 1024; }
+bootTiming_t bootTiming;
 
 uint8_t __config_start = 0x00;
 uint8_t __config_end = 0x10;
@@ -321,10 +455,25 @@ const char * const shortGitRevision = "MASTER";
 
 uint32_t serialRxBytesWaiting(const serialPort_t *) {return 0;}
 uint8_t serialRead(serialPort_t *){return 0;}
+uint32_t serialPeekContiguous(serialPort_t *, const uint8_t **data)
+{
+    if (!cliInput) {
+        return 0;
+    }
+    *data = (const uint8_t *)cliInput;
+    return strlen(cliInput);
+}
+void serialSkip(serialPort_t *, uint32_t count) { cliInput += count; }
 
-void bufWriterAppend(bufWriter_t *, uint8_t ch){ printf("%c", ch); }
+void bufWriterAppend(bufWriter_t *, uint8_t ch)
+{
+    printf("%c", ch);
+    if (cliOutputLength < sizeof(cliOutput) - 1) {
+        cliOutput[cliOutputLength++] = ch;
+    }
+}
 void serialWriteBufShim(void *, const uint8_t *, int) {}
-bufWriter_t *bufWriterInit(uint8_t *, int, bufWrite_t, void *) {return NULL;}
+bufWriter_t *bufWriterInit(uint8_t *b, int, bufWrite_t, void *) { return (bufWriter_t *)b; }
 void schedulerSetCalulateTaskStatistics(bool) {}
 void setArmingDisabled(armingDisableFlags_e) {}
 
@@ -336,7 +485,7 @@ void writeUnmodifiedConfigToEEPROM(void) {}
 
 void changePidProfile(uint8_t) {}
 bool serialIsPortAvailable(serialPortIdentifier_e) { return false; }
-void generateLedConfig(ledConfig_t *, char *, size_t) {}
+void generateLedConfig(ledConfig_t *, char *ledConfigBuffer, size_t) { ledConfigBuffer[0] = '\0'; }
 bool isSerialTransmitBufferEmpty(const serialPort_t *) {return true; }
 void serialWrite(serialPort_t *, uint8_t ch) { printf("%c", ch);}
 
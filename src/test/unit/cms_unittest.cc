@@ -36,6 +36,7 @@ extern "C" {
     long cmsMenuBack(displayPort_t *pDisplay);
     uint16_t cmsHandleKey(displayPort_t *pDisplay, uint8_t key);
     extern CMS_Menu *currentMenu;    // Points to top entry of the current page
+    extern int16_t rcData[18];
 }
 
 #include "unittest_macros.h"
@@ -115,6 +116,80 @@ TEST(CMSUnittest, TestCmsMenuKey)
     uint16_t result = cmsHandleKey(displayPort, KEY_ESC);
     EXPECT_EQ(BUTTON_PAUSE, result);
 }
+
+static uint8_t dynamicValue;
+static char dynamicLabel[16];
+static OSD_UINT8_t entryDynamicValue = { &dynamicValue, 0, 255, 1 };
+
+static OSD_Entry menuDynamicEntries[] =
+{
+    {"-- DYNAMIC --", OME_Label, NULL, NULL, 0},
+    {"VALUE", OME_UINT8, NULL, &entryDynamicValue, DYNAMIC},
+    {"LABEL", OME_Label, NULL, dynamicLabel, DYNAMIC},
+    {"BACK", OME_Back, NULL, NULL, 0},
+    {NULL, OME_END, NULL, NULL, 0}
+};
+
+static CMS_Menu menuDynamic = {
+#ifdef CMS_MENU_DEBUG
+    .GUARD_text = "MENUDYN",
+    .GUARD_type = OME_MENU,
+#endif
+    .onEnter = NULL,
+    .onExit = NULL,
+    .checkRedirect = NULL,
+    .entries = menuDynamicEntries,
+};
+
+TEST(CMSUnittest, TestCmsDynamicValuesOnlyWriteChanges)
+{
+    cmsInit();
+    displayPort_t *displayPort = displayPortTestInit();
+    cmsDisplayPortRegister(displayPort);
+    testDisplayPortTxBytesFree = 1000;
+    for (int i = 0; i < 4; i++) {
+        rcData[i] = 1500;
+    }
+
+    dynamicValue = 123;
+    strcpy(dynamicLabel, "RSSI 99");
+    cmsMenuOpen();
+    cmsMenuChange(displayPort, &menuDynamic);
+
+    timeUs_t currentTimeUs = 1000000;
+    testDisplayPortCharsWritten = 0;
+    cmsHandler(currentTimeUs);
+    EXPECT_GT(testDisplayPortCharsWritten, 0);
+    EXPECT_NE(nullptr, strstr(testDisplayPortBuffer, "  123"));
+    EXPECT_NE(nullptr, strstr(testDisplayPortBuffer, "LABEL RSSI 99"));
+
+    // polling unchanged dynamic values writes nothing
+    currentTimeUs += 200000;
+    testDisplayPortCharsWritten = 0;
+    cmsHandler(currentTimeUs);
+    EXPECT_EQ(0, testDisplayPortCharsWritten);
+
+    // only the characters that changed are written
+    dynamicValue = 124;
+    strcpy(dynamicLabel, "RSSI 98");
+    currentTimeUs += 200000;
+    testDisplayPortCharsWritten = 0;
+    cmsHandler(currentTimeUs);
+    EXPECT_EQ(2, testDisplayPortCharsWritten);
+    EXPECT_NE(nullptr, strstr(testDisplayPortBuffer, "  124"));
+    EXPECT_NE(nullptr, strstr(testDisplayPortBuffer, "LABEL RSSI 98"));
+
+    // a longer value is written in full
+    strcpy(dynamicLabel, "RSSI 100");
+    currentTimeUs += 200000;
+    testDisplayPortCharsWritten = 0;
+    cmsHandler(currentTimeUs);
+    EXPECT_EQ(8, testDisplayPortCharsWritten);
+    EXPECT_NE(nullptr, strstr(testDisplayPortBuffer, "LABEL RSSI 100"));
+
+    cmsMenuExit(displayPort, (void*)0);
+    testDisplayPortTxBytesFree = 0;
+}
 // STUBS
 
 extern "C" {
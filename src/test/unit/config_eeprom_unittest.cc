@@ -0,0 +1,323 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+
+    #include "config/config_eeprom.h"
+
+    #include "drivers/system.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    typedef struct testConfigA_s {
+        uint16_t value;
+    } testConfigA_t;
+
+    typedef struct testConfigB_s {
+        uint32_t value;
+    } testConfigB_t;
+
+    PG_DECLARE(testConfigA_t, testConfigA);
+    PG_DECLARE(testConfigB_t, testConfigB);
+
+    PG_REGISTER_WITH_RESET_TEMPLATE(testConfigA_t, testConfigA, PG_RESERVED_FOR_TESTING_1, 0);
+    PG_REGISTER_WITH_RESET_TEMPLATE(testConfigB_t, testConfigB, PG_RESERVED_FOR_TESTING_2, 0);
+
+    PG_RESET_TEMPLATE(testConfigA_t, testConfigA,
+        .value = 100,
+    );
+
+    PG_RESET_TEMPLATE(testConfigB_t, testConfigB,
+        .value = 200,
+    );
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+/*
+ * Simulated internal flash: programming can only clear bits, erasing sets a whole page back to 0xFF.
+ * A program budget simulates a power loss after a number of words.
+ */
+
+#define SIM_FLASH_PAGE_SIZE     0x400   // FLASH_PAGE_SIZE of config_streamer.c for UNIT_TEST
+
+static int simEraseCount;
+static int simProgramCount;
+static int simOverwriteCount;
+static int simProgramBudget;            // words left until the power fails, -1 for no limit
+static int failureModeCount;
+
+static void powerCycle(void)
+{
+    simProgramBudget = -1;
+    memset(testConfigAMutable(), 0, sizeof(testConfigA_t));
+    memset(testConfigBMutable(), 0, sizeof(testConfigB_t));
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_TRUE(loadEEPROM());
+}
+
+static void saveValues(uint16_t a, uint32_t b)
+{
+    testConfigAMutable()->value = a;
+    testConfigBMutable()->value = b;
+    writeConfigToEEPROM();
+}
+
+class ConfigEepromTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        memset(eepromData, 0, sizeof(eepromData));
+        simEraseCount = 0;
+        simProgramCount = 0;
+        simOverwriteCount = 0;
+        simProgramBudget = -1;
+        failureModeCount = 0;
+
+        pgResetAll();
+        writeConfigToEEPROM();
+        ASSERT_TRUE(isEEPROMStructureValid());
+        simEraseCount = 0;
+        simProgramCount = 0;
+    }
+
+    virtual void TearDown() {
+        EXPECT_EQ(0, simOverwriteCount);
+    }
+};
+
+TEST_F(ConfigEepromTest, FullCopyIsLoaded)
+{
+    powerCycle();
+    EXPECT_EQ(100, testConfigA()->value);
+    EXPECT_EQ(200, testConfigB()->value);
+}
+
+TEST_F(ConfigEepromTest, SaveAppendsOnlyChangedGroups)
+{
+    uint8_t fullCopy[EEPROM_SIZE];
+    const uint16_t fullCopySize = getEEPROMConfigSize();
+    memcpy(fullCopy, eepromData, fullCopySize);
+
+    saveValues(100, 201);
+
+    EXPECT_EQ(0, simEraseCount);
+    // one record of header, testConfigB_t and CRC, padded to whole words
+    EXPECT_EQ(4, simProgramCount);
+    EXPECT_EQ(0, memcmp(fullCopy, eepromData, fullCopySize));
+
+    powerCycle();
+    EXPECT_EQ(100, testConfigA()->value);
+    EXPECT_EQ(201, testConfigB()->value);
+}
+
+TEST_F(ConfigEepromTest, UnchangedSaveWritesNothing)
+{
+    saveValues(100, 201);
+    simProgramCount = 0;
+
+    saveValues(100, 201);
+
+    EXPECT_EQ(0, simEraseCount);
+    EXPECT_EQ(0, simProgramCount);
+}
+
+TEST_F(ConfigEepromTest, NewestRecordWins)
+{
+    saveValues(101, 201);
+    saveValues(102, 201);
+    saveValues(102, 202);
+
+    EXPECT_EQ(0, simEraseCount);
+
+    powerCycle();
+    EXPECT_EQ(102, testConfigA()->value);
+    EXPECT_EQ(202, testConfigB()->value);
+}
+
+TEST_F(ConfigEepromTest, FullJournalIsCompacted)
+{
+    int saves = 0;
+    while (simEraseCount == 0 && saves < 1000) {
+        saves++;
+        saveValues(100 + saves, 200 + saves);
+    }
+
+    EXPECT_GT(saves, 10);
+    EXPECT_EQ(1, simEraseCount);
+    EXPECT_EQ(0, failureModeCount);
+
+    powerCycle();
+    EXPECT_EQ(100 + saves, testConfigA()->value);
+    EXPECT_EQ(200 + saves, testConfigB()->value);
+
+    // the compacted copy has room for the journal again
+    simEraseCount = 0;
+    saveValues(1, 2);
+    EXPECT_EQ(0, simEraseCount);
+
+    powerCycle();
+    EXPECT_EQ(1, testConfigA()->value);
+    EXPECT_EQ(2, testConfigB()->value);
+}
+
+TEST_F(ConfigEepromTest, InterruptedSaveKeepsPreviousSettings)
+{
+    saveValues(101, 201);
+    const int wordsPerSave = simProgramCount;
+
+    uint8_t before[EEPROM_SIZE];
+    memcpy(before, eepromData, sizeof(before));
+
+    for (int budget = 0; budget <= wordsPerSave; budget++) {
+        memcpy(eepromData, before, sizeof(eepromData));
+        ASSERT_TRUE(isEEPROMStructureValid());
+
+        simProgramBudget = budget;
+        saveValues(102, 202);
+
+        powerCycle();
+        if (budget < wordsPerSave) {
+            EXPECT_EQ(101, testConfigA()->value);
+            EXPECT_EQ(201, testConfigB()->value);
+        } else {
+            EXPECT_EQ(102, testConfigA()->value);
+            EXPECT_EQ(202, testConfigB()->value);
+        }
+
+        // the next save must not program over the torn record
+        simEraseCount = 0;
+        saveValues(103, 203);
+        EXPECT_EQ(budget > 0 && budget < wordsPerSave ? 1 : 0, simEraseCount);
+
+        powerCycle();
+        EXPECT_EQ(103, testConfigA()->value);
+        EXPECT_EQ(203, testConfigB()->value);
+    }
+}
+
+static uint8_t *appendRecord(uint8_t *p, pgn_t pgn, const void *pg, uint16_t size)
+{
+    const uint16_t recordSize = 6 + size;
+    memcpy(p, &recordSize, sizeof(recordSize));
+    memcpy(p + 2, &pgn, sizeof(pgn));
+    p[4] = 0; // version
+    p[5] = 0; // flags
+    memcpy(p + 6, pg, size);
+    return p + recordSize;
+}
+
+TEST_F(ConfigEepromTest, RecordsAreFoundInAnyOrder)
+{
+    // a full copy written by firmware with a different registry order, and a PG this one doesn't know
+    const testConfigA_t a = { .value = 150 };
+    const testConfigB_t b = { .value = 250 };
+    const uint32_t unknown = 0x12345678;
+
+    memset(eepromData, 0xFF, sizeof(eepromData));
+    uint8_t *p = eepromData;
+    *p++ = EEPROM_CONF_VERSION;
+    *p++ = 0xBE;
+    p = appendRecord(p, PG_RESERVED_FOR_TESTING_3, &unknown, sizeof(unknown));
+    p = appendRecord(p, PG_RESERVED_FOR_TESTING_2, &b, sizeof(b));
+    p = appendRecord(p, PG_RESERVED_FOR_TESTING_1, &a, sizeof(a));
+    *p++ = 0;
+    *p++ = 0;
+    const uint16_t crc = crc16_ccitt_update(0xFFFF, eepromData, p - eepromData);
+    *p++ = ~(crc >> 8);
+    *p++ = ~(crc & 0xFF);
+
+    powerCycle();
+    EXPECT_EQ(150, testConfigA()->value);
+    EXPECT_EQ(250, testConfigB()->value);
+}
+
+TEST_F(ConfigEepromTest, MissingGroupIsReset)
+{
+    const testConfigB_t b = { .value = 250 };
+
+    memset(eepromData, 0xFF, sizeof(eepromData));
+    uint8_t *p = eepromData;
+    *p++ = EEPROM_CONF_VERSION;
+    *p++ = 0xBE;
+    p = appendRecord(p, PG_RESERVED_FOR_TESTING_2, &b, sizeof(b));
+    *p++ = 0;
+    *p++ = 0;
+    const uint16_t crc = crc16_ccitt_update(0xFFFF, eepromData, p - eepromData);
+    *p++ = ~(crc >> 8);
+    *p++ = ~(crc & 0xFF);
+
+    memset(testConfigAMutable(), 0, sizeof(testConfigA_t));
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_FALSE(loadEEPROM());
+    EXPECT_EQ(100, testConfigA()->value);
+    EXPECT_EQ(250, testConfigB()->value);
+}
+
+// STUBS
+
+extern "C" {
+
+void FLASH_Unlock(void) {}
+void FLASH_Lock(void) {}
+
+FLASH_Status FLASH_ErasePage(uintptr_t Page_Address)
+{
+    if (simProgramBudget == 0) {
+        return FLASH_ERROR_PG;
+    }
+    memset((void *)Page_Address, 0xFF, SIM_FLASH_PAGE_SIZE);
+    simEraseCount++;
+    return FLASH_COMPLETE;
+}
+
+FLASH_Status FLASH_ProgramWord(uintptr_t addr, uint32_t Data)
+{
+    if (simProgramBudget == 0) {
+        return FLASH_ERROR_PG;
+    }
+    if (simProgramBudget > 0) {
+        simProgramBudget--;
+    }
+
+    uint32_t *word = (uint32_t *)addr;
+    if (*word != 0xFFFFFFFF) {
+        simOverwriteCount++;
+    }
+    *word &= Data;
+    simProgramCount++;
+    return FLASH_COMPLETE;
+}
+
+void failureMode(failureMode_e mode)
+{
+    UNUSED(mode);
+    failureModeCount++;
+}
+
+}
@@ -0,0 +1,154 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/streambuf.h"
+    #include "common/utils.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Bit by bit reference implementations, as the lookup tables were generated from.
+
+static uint16_t referenceCrc16Ccitt(uint16_t crc, uint8_t a)
+{
+    crc ^= (uint16_t)a << 8;
+    for (int ii = 0; ii < 8; ++ii) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+static uint8_t referenceCrc8(uint8_t crc, uint8_t a, uint8_t poly)
+{
+    crc ^= a;
+    for (int ii = 0; ii < 8; ++ii) {
+        crc = (crc & 0x80) ? (crc << 1) ^ poly : crc << 1;
+    }
+    return crc;
+}
+
+static uint16_t referenceCrc16CcittUpdate(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        crc = referenceCrc16Ccitt(crc, data[i]);
+    }
+    return crc;
+}
+
+static uint8_t referenceCrc8Update(uint8_t crc, const uint8_t *data, uint32_t length, uint8_t poly)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        crc = referenceCrc8(crc, data[i], poly);
+    }
+    return crc;
+}
+
+static const uint8_t checkData[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+TEST(CrcUnittest, CheckValues)
+{
+    // published check values of the CRC catalogue for "123456789"
+    EXPECT_EQ(0x31C3, crc16_ccitt_update(0, checkData, sizeof(checkData)));         // CRC-16/XMODEM
+    EXPECT_EQ(0x29B1, crc16_ccitt_update(0xFFFF, checkData, sizeof(checkData)));    // CRC-16/IBM-3740
+    EXPECT_EQ(0xBC, crc8_dvb_s2_update(0, checkData, sizeof(checkData)));           // CRC-8/DVB-S2
+    EXPECT_EQ(0xF4, crc8_poly_0x07_update(0, checkData, sizeof(checkData)));        // CRC-8/SMBUS
+}
+
+TEST(CrcUnittest, SingleByteMatchesReferenceForAllInputs)
+{
+    for (uint32_t crc = 0; crc <= 0xFFFF; crc++) {
+        for (uint32_t a = 0; a <= 0xFF; a++) {
+            if (crc16_ccitt(crc, a) != referenceCrc16Ccitt(crc, a)) {
+                FAIL() << "crc16_ccitt crc=" << crc << " a=" << a;
+            }
+        }
+    }
+
+    for (uint32_t crc = 0; crc <= 0xFF; crc++) {
+        for (uint32_t a = 0; a <= 0xFF; a++) {
+            EXPECT_EQ(referenceCrc8(crc, a, 0xD5), crc8_dvb_s2(crc, a));
+            EXPECT_EQ(referenceCrc8(crc, a, 0x07), crc8_poly_0x07(crc, a));
+        }
+    }
+}
+
+TEST(CrcUnittest, BlocksMatchReferenceForAllLengthsAndAlignments)
+{
+    uint8_t data[300 + 4];
+    srand(42);
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = rand();
+    }
+
+    for (int offset = 0; offset < 4; offset++) {
+        for (uint32_t length = 0; length <= 300; length++) {
+            const uint8_t *block = data + offset;
+            const uint16_t seed = rand();
+
+            EXPECT_EQ(referenceCrc16CcittUpdate(seed, block, length), crc16_ccitt_update(seed, block, length));
+            EXPECT_EQ(referenceCrc8Update(seed & 0xFF, block, length, 0xD5), crc8_dvb_s2_update(seed & 0xFF, block, length));
+            EXPECT_EQ(referenceCrc8Update(seed & 0xFF, block, length, 0x07), crc8_poly_0x07_update(seed & 0xFF, block, length));
+        }
+    }
+}
+
+TEST(CrcUnittest, BlocksCanBeSplitAnywhere)
+{
+    uint8_t data[64];
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = i * 37;
+    }
+
+    const uint16_t whole = crc16_ccitt_update(0, data, sizeof(data));
+    for (unsigned split = 0; split <= sizeof(data); split++) {
+        const uint16_t head = crc16_ccitt_update(0, data, split);
+        EXPECT_EQ(whole, crc16_ccitt_update(head, data + split, sizeof(data) - split));
+    }
+}
+
+TEST(CrcUnittest, SbufAppend)
+{
+    uint8_t buffer[32];
+    sbuf_t sbuf;
+    sbuf.ptr = buffer;
+    sbuf.end = ARRAYEND(buffer);
+
+    sbufWriteData(&sbuf, checkData, sizeof(checkData));
+    crc16_ccitt_sbuf_append(&sbuf, buffer);
+    EXPECT_EQ(sizeof(checkData) + 2, (unsigned)(sbuf.ptr - buffer));
+    EXPECT_EQ(0x31C3, buffer[sizeof(checkData)] | (buffer[sizeof(checkData) + 1] << 8));
+
+    sbuf.ptr = buffer;
+    sbufWriteData(&sbuf, checkData, sizeof(checkData));
+    crc8_dvb_s2_sbuf_append(&sbuf, buffer);
+    EXPECT_EQ(sizeof(checkData) + 1, (unsigned)(sbuf.ptr - buffer));
+    EXPECT_EQ(0xBC, buffer[sizeof(checkData)]);
+}
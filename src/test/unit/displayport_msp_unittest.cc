@@ -0,0 +1,374 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/display.h"
+
+    #include "io/displayport_msp.h"
+
+    #include "msp/msp.h"
+    #include "msp/msp_protocol.h"
+    #include "msp/msp_serial.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    PG_REGISTER(displayPortProfile_t, displayPortProfileMsp, PG_DISPLAY_PORT_MSP_CONFIG, 0);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+/*
+ * Host model of an MSP DisplayPort receiver. Writes go to a pending screen which is shown when
+ * the flight controller asks for a draw, either with MSP_DP_DRAW_SCREEN or a committing batch.
+ */
+
+#define MODEL_ROWS 13
+#define MODEL_COLS 30
+#define MSP_V1_OVERHEAD 6
+
+static struct {
+    char pending[MODEL_ROWS][MODEL_COLS];
+    char shown[MODEL_ROWS][MODEL_COLS];
+    int frames;
+    int bytes;
+    int draws;
+} model;
+
+// The TX buffer is drained by the UART between draws
+static uint32_t txBufferSize;
+static uint32_t txPending;
+
+static void drain(void)
+{
+    txPending = 0;
+}
+
+static void modelReset(void)
+{
+    memset(&model, 0, sizeof(model));
+    memset(model.pending, ' ', sizeof(model.pending));
+    memset(model.shown, ' ', sizeof(model.shown));
+}
+
+static void modelWrite(int row, int col, const uint8_t *chars, int length)
+{
+    ASSERT_LT(row, MODEL_ROWS);
+    ASSERT_LE(col + length, MODEL_COLS);
+    memcpy(&model.pending[row][col], chars, length);
+}
+
+static void modelReceive(const uint8_t *data, int length)
+{
+    ASSERT_GE(length, 1);
+    switch (data[0]) {
+    case MSP_DP_CLEAR_SCREEN:
+        memset(model.pending, ' ', sizeof(model.pending));
+        break;
+    case MSP_DP_WRITE_STRING:
+        modelWrite(data[1], data[2], &data[4], length - 4);
+        break;
+    case MSP_DP_DRAW_SCREEN:
+        memcpy(model.shown, model.pending, sizeof(model.shown));
+        model.draws++;
+        break;
+    case MSP_DP_WRITE_BATCH:
+        ASSERT_GE(length, 2);
+        for (int i = 2; i < length; ) {
+            ASSERT_LE(i + 4, length);
+            EXPECT_EQ(0, data[i + 2]);
+            const int runLength = data[i + 3];
+            ASSERT_LE(i + 4 + runLength, length);
+            modelWrite(data[i], data[i + 1], &data[i + 4], runLength);
+            i += 4 + runLength;
+        }
+        if (data[1] & MSP_DP_BATCH_FLAG_COMMIT) {
+            memcpy(model.shown, model.pending, sizeof(model.shown));
+            model.draws++;
+        }
+        break;
+    }
+}
+
+static void expectShown(displayPort_t *displayPort, const char (*expected)[MODEL_COLS])
+{
+    for (int row = 0; row < displayPort->rows; row++) {
+        for (int col = 0; col < displayPort->cols; col++) {
+            EXPECT_EQ(expected[row][col], model.shown[row][col]) << "row " << row << " col " << col;
+        }
+    }
+}
+
+// A typical OSD screen, redrawn from scratch each refresh as the OSD does without a background layer.
+static void drawOsdFrame(displayPort_t *displayPort, int frame)
+{
+    char buf[16];
+
+    drain();
+    displayClearScreen(displayPort);
+    snprintf(buf, sizeof(buf), "%c%02d:%02d", 0x9c, frame / 60 % 60, frame % 60);
+    displayWrite(displayPort, 23, 1, buf);
+    snprintf(buf, sizeof(buf), "%c%d.%02dV", 0x97, 16 - frame / 100 % 2, frame % 100);
+    displayWrite(displayPort, 1, 11, buf);
+    snprintf(buf, sizeof(buf), "%c%3d", 0x01, 99 - frame % 7);
+    displayWrite(displayPort, 1, 1, buf);
+    displayWrite(displayPort, 12, 11, "12.3A");
+    displayWrite(displayPort, 20, 11, "1234MAH");
+    displayWrite(displayPort, 12, 1, "ACRO");
+    displayWrite(displayPort, 1, 2, "CRAFT NAME");
+    displayWriteChar(displayPort, 14, 6, 0x72);
+    displayWrite(displayPort, 11, 7, "---");
+    displayWrite(displayPort, 1, 10, "0.0M");
+    displayWrite(displayPort, 24, 10, "2SATS");
+    displayDrawScreen(displayPort);
+}
+
+class DisplayPortMspTest : public ::testing::Test {
+protected:
+    displayPort_t *displayPort;
+    char expected[MODEL_ROWS][MODEL_COLS];
+
+    void init(bool batchWrites) {
+        modelReset();
+        txBufferSize = 1024;
+        drain();
+        displayPortProfileMspMutable()->batchWrites = batchWrites;
+        displayPort = displayPortMspInit();
+        memset(expected, ' ', sizeof(expected));
+    }
+
+    void write(uint8_t col, uint8_t row, const char *text) {
+        displayWrite(displayPort, col, row, text);
+        memcpy(&expected[row][col], text, strlen(text));
+    }
+
+    void draw(void) {
+        drain();
+        displayDrawScreen(displayPort);
+    }
+
+    int drawAndCountBytes(void) {
+        const int before = model.bytes;
+        draw();
+        return model.bytes - before;
+    }
+};
+
+TEST_F(DisplayPortMspTest, LegacyWritesAreSentImmediately)
+{
+    init(false);
+    model.bytes = 0;
+
+    write(3, 4, "HELLO");
+    EXPECT_EQ(MSP_V1_OVERHEAD + 4 + 5, model.bytes);
+    EXPECT_EQ(0, memcmp("HELLO", &model.pending[4][3], 5));
+
+    EXPECT_EQ(MSP_V1_OVERHEAD + 1, drawAndCountBytes());
+    expectShown(displayPort, expected);
+}
+
+TEST_F(DisplayPortMspTest, BatchWritesWaitForDraw)
+{
+    init(true);
+    draw();
+    EXPECT_TRUE(displayIsSynced(displayPort));
+    expectShown(displayPort, expected);
+    model.frames = 0;
+    model.draws = 0;
+
+    write(3, 4, "HELLO");
+    write(10, 12, "WORLD");
+    EXPECT_EQ(0, model.frames);
+    EXPECT_FALSE(displayIsSynced(displayPort));
+
+    // one frame with both runs, committed
+    EXPECT_EQ(MSP_V1_OVERHEAD + 2 + 2 * (4 + 5), drawAndCountBytes());
+    EXPECT_EQ(1, model.frames);
+    EXPECT_EQ(1, model.draws);
+    EXPECT_TRUE(displayIsSynced(displayPort));
+    expectShown(displayPort, expected);
+}
+
+TEST_F(DisplayPortMspTest, UnchangedScreenSendsNothing)
+{
+    init(true);
+    write(0, 0, "STATIC");
+    draw();
+
+    // the OSD clears and redraws the same content
+    displayClearScreen(displayPort);
+    write(0, 0, "STATIC");
+    EXPECT_EQ(0, drawAndCountBytes());
+}
+
+TEST_F(DisplayPortMspTest, OnlyChangedCellsAreSent)
+{
+    init(true);
+    write(5, 5, "12:34");
+    draw();
+
+    write(5, 5, "12:35");
+    EXPECT_EQ(MSP_V1_OVERHEAD + 2 + 4 + 1, drawAndCountBytes());
+    expectShown(displayPort, expected);
+
+    // nearby changes share a run rather than paying for another header
+    write(5, 5, "22:36");
+    EXPECT_EQ(MSP_V1_OVERHEAD + 2 + 4 + 5, drawAndCountBytes());
+    expectShown(displayPort, expected);
+}
+
+TEST_F(DisplayPortMspTest, WritesAreClippedToTheScreen)
+{
+    displayPortProfileMspMutable()->colAdjust = -2;
+    init(true);
+    draw();
+
+    write(25, 0, "ABC");
+    displayWrite(displayPort, 26, 1, "CLIPPED");
+    displayWriteChar(displayPort, 0, 13, 'X');
+    memcpy(&expected[1][26], "CL", 2);
+    draw();
+
+    expectShown(displayPort, expected);
+    EXPECT_EQ(' ', model.shown[1][28]);
+    displayPortProfileMspMutable()->colAdjust = 0;
+}
+
+TEST_F(DisplayPortMspTest, UpdateIsSplitToFitTheTxBuffer)
+{
+    init(true);
+    draw();
+    model.draws = 0;
+
+    for (int row = 0; row < MODEL_ROWS; row++) {
+        char line[MODEL_COLS + 1];
+        for (int col = 0; col < MODEL_COLS; col++) {
+            line[col] = 'A' + (row + col) % 26;
+        }
+        line[MODEL_COLS] = 0;
+        write(0, row, line);
+    }
+
+    txBufferSize = 100;
+    int calls = 0;
+    while (!displayIsSynced(displayPort) && calls < 100) {
+        const int frames = model.frames;
+        draw();
+        EXPECT_EQ(frames + 1, model.frames);
+        EXPECT_EQ(displayIsSynced(displayPort) ? 1 : 0, model.draws);
+        calls++;
+    }
+
+    EXPECT_EQ(MODEL_ROWS / 2 + 1, calls);
+    expectShown(displayPort, expected);
+}
+
+TEST_F(DisplayPortMspTest, NoTxRoomKeepsCellsDirty)
+{
+    init(true);
+    draw();
+
+    write(1, 1, "WAIT");
+    txBufferSize = 0;
+    EXPECT_EQ(0, drawAndCountBytes());
+    EXPECT_FALSE(displayIsSynced(displayPort));
+
+    txBufferSize = 1024;
+    draw();
+    EXPECT_TRUE(displayIsSynced(displayPort));
+    expectShown(displayPort, expected);
+}
+
+TEST_F(DisplayPortMspTest, GrabStartsFromAClearedReceiver)
+{
+    init(true);
+    write(2, 2, "KEEP");
+    draw();
+
+    // the receiver has shown something else meanwhile
+    memset(model.pending, 'Z', sizeof(model.pending));
+    memset(model.shown, 'Z', sizeof(model.shown));
+
+    displayGrab(displayPort);
+    memset(expected, ' ', sizeof(expected));
+    write(4, 4, "MENU");
+    draw();
+    expectShown(displayPort, expected);
+    displayRelease(displayPort);
+}
+
+TEST_F(DisplayPortMspTest, BytesPerOsdFrame)
+{
+    const int frameCount = 600;
+    int bytes[2];
+
+    for (int batch = 0; batch < 2; batch++) {
+        init(batch);
+        drawOsdFrame(displayPort, 0);
+        model.bytes = 0;
+        model.frames = 0;
+        for (int frame = 1; frame <= frameCount; frame++) {
+            drawOsdFrame(displayPort, frame);
+        }
+        bytes[batch] = model.bytes;
+        printf("%s: %.1f bytes in %.1f MSP frames per OSD frame\n", batch ? "batched" : "legacy",
+            (float)model.bytes / frameCount, (float)model.frames / frameCount);
+    }
+
+    EXPECT_LT(bytes[1] * 5, bytes[0]);
+}
+
+// STUBS
+
+extern "C" {
+
+int mspSerialPush(serialPortIdentifier_e port, uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction)
+{
+    UNUSED(port);
+    EXPECT_EQ(MSP_DISPLAYPORT, cmd);
+    EXPECT_EQ(MSP_DIRECTION_REPLY, direction);
+
+    const int frameLength = datalen + MSP_V1_OVERHEAD;
+    if ((uint32_t)frameLength > mspSerialTxBytesFree()) {
+        return 0;
+    }
+    EXPECT_LE(datalen, 255);
+    txPending += frameLength;
+
+    modelReceive(data, datalen);
+    model.frames++;
+    model.bytes += frameLength;
+    return frameLength;
+}
+
+uint32_t mspSerialTxBytesFree(void)
+{
+    return txBufferSize - txPending;
+}
+
+}
@@ -0,0 +1,601 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/flash.h"
+
+    #include "io/flashfs.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+/*
+ * Simulated NOR flash: programming can only clear bits, erasing sets a whole sector back to 0xFF.
+ *
+ * In NAND mode the flash works like the W25N01G: data is loaded into a page buffer which is only programmed when the
+ * load reaches the end of the page, a load starts at another address or the flash is flushed. A page can only be
+ * programmed once between erases because of its ECC.
+ */
+
+#define SIM_FLASH_PAGE_SIZE         256
+#define SIM_FLASH_PAGES_PER_SECTOR  16
+#define SIM_FLASH_SECTOR_SIZE       (SIM_FLASH_PAGE_SIZE * SIM_FLASH_PAGES_PER_SECTOR)
+#define SIM_FLASH_SECTORS           16
+#define SIM_FLASH_SIZE              (SIM_FLASH_SECTOR_SIZE * SIM_FLASH_SECTORS)
+
+#define SIM_FLASH_ERASE_BUSY_POLLS  3
+
+static uint8_t simFlash[SIM_FLASH_SIZE];
+static uint32_t simProgramAddress;
+static int simReadCount;
+static int simEraseCount;
+static int simBusyPolls;
+
+static bool simPageProgrammed[SIM_FLASH_SECTORS * SIM_FLASH_PAGES_PER_SECTOR];
+static int simPageProgrammedTwiceCount;
+static uint8_t simPageBuffer[SIM_FLASH_PAGE_SIZE];
+static bool simPageBufferDirty;
+static uint32_t simPageBufferStartAddress;
+
+static flashGeometry_t simGeometry = {
+    .sectors = SIM_FLASH_SECTORS,
+    .pageSize = SIM_FLASH_PAGE_SIZE,
+    .sectorSize = SIM_FLASH_SECTOR_SIZE,
+    .totalSize = SIM_FLASH_SIZE,
+    .pagesPerSector = SIM_FLASH_PAGES_PER_SECTOR,
+    .flashType = FLASH_TYPE_NOR,
+};
+
+static flashPartition_t simPartitions[] = {
+    { FLASH_PARTITION_TYPE_FLASHFS, 0, SIM_FLASH_SECTORS - 2 },
+    { FLASH_PARTITION_TYPE_FLASHFS_INDEX, SIM_FLASH_SECTORS - 1, SIM_FLASH_SECTORS - 1 },
+};
+
+static const uint32_t simFlashfsSize = (SIM_FLASH_SECTORS - 1) * SIM_FLASH_SECTOR_SIZE;
+
+static void simFlashErase(void)
+{
+    memset(simFlash, 0xFF, sizeof(simFlash));
+    memset(simPageProgrammed, 0, sizeof(simPageProgrammed));
+}
+
+static void simFlashInit(flashType_e flashType)
+{
+    simGeometry.flashType = flashType;
+    simFlashErase();
+    simBusyPolls = 0;
+    simPageProgrammedTwiceCount = 0;
+    simPageBufferDirty = false;
+}
+
+static void writeLog(uint32_t length, uint8_t fill, uint32_t timestamp)
+{
+    uint8_t data[100];
+    memset(data, fill, sizeof(data));
+
+    flashfsLogBegin(timestamp);
+    while (length > 0) {
+        const uint32_t chunk = length < sizeof(data) ? length : sizeof(data);
+        flashfsWrite(data, chunk, true);
+        length -= chunk;
+    }
+    flashfsFlushSync();
+    flashfsClose();
+}
+
+static void finishErase(void)
+{
+    for (int i = 0; i < 1000 && flashfsIsErasing(); i++) {
+        flashfsEraseUpdate();
+    }
+}
+
+static bool simSectorIs(int sector, uint8_t value)
+{
+    for (int i = 0; i < SIM_FLASH_SECTOR_SIZE; i++) {
+        if (simFlash[sector * SIM_FLASH_SECTOR_SIZE + i] != value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint8_t simIndexSlotMagic(int slot)
+{
+    return simFlash[(SIM_FLASH_SECTORS - 1) * SIM_FLASH_SECTOR_SIZE + slot * 16];
+}
+
+class FlashfsLogIndexTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        simFlashInit(FLASH_TYPE_NOR);
+        flashfsInit();
+    }
+};
+
+TEST_F(FlashfsLogIndexTest, EmptyFlash)
+{
+    EXPECT_EQ(simFlashfsSize, flashfsGetSize());
+    EXPECT_EQ(0, flashfsGetOffset());
+    EXPECT_EQ(0, flashfsLogGetCount());
+    EXPECT_EQ(-1, flashfsLogGetCurrentNumber());
+}
+
+TEST_F(FlashfsLogIndexTest, LogsAreIndexed)
+{
+    writeLog(1000, 0x11, 1000000);
+    writeLog(3000, 0x22, 2000000);
+
+    EXPECT_EQ(2, flashfsLogGetCount());
+    EXPECT_EQ(2, flashfsLogGetCurrentNumber());
+
+    flashfsLogEntry_t entry;
+    EXPECT_TRUE(flashfsLogGetEntry(0, &entry));
+    EXPECT_EQ(1, entry.logNumber);
+    EXPECT_EQ(0, entry.startAddress);
+    EXPECT_EQ(1000, entry.length);
+    EXPECT_EQ(1000000, entry.timestamp);
+
+    EXPECT_TRUE(flashfsLogFindByNumber(2, &entry));
+    EXPECT_EQ(1000, entry.startAddress);
+    EXPECT_EQ(3000, entry.length);
+    EXPECT_EQ(2000000, entry.timestamp);
+    EXPECT_EQ(0x22, simFlash[entry.startAddress]);
+
+    EXPECT_FALSE(flashfsLogFindByNumber(3, &entry));
+    EXPECT_FALSE(flashfsLogGetEntry(2, &entry));
+}
+
+TEST_F(FlashfsLogIndexTest, IndexIsUsedAtBoot)
+{
+    writeLog(1000, 0x11, 0);
+    writeLog(3000, 0x22, 0);
+
+    // reboot
+    simReadCount = 0;
+    flashfsInit();
+
+    EXPECT_EQ(2, flashfsLogGetCount());
+    EXPECT_EQ(2, flashfsLogGetCurrentNumber());
+    // The free space follows the last log exactly, no search of the volume was needed
+    EXPECT_EQ(4000, flashfsGetOffset());
+    EXPECT_LT(simReadCount, 16);
+
+    writeLog(500, 0x33, 0);
+
+    flashfsLogEntry_t entry;
+    EXPECT_TRUE(flashfsLogFindByNumber(3, &entry));
+    EXPECT_EQ(4000, entry.startAddress);
+    EXPECT_EQ(500, entry.length);
+}
+
+TEST_F(FlashfsLogIndexTest, UnindexedLogAfterPowerLoss)
+{
+    writeLog(1000, 0x11, 0);
+
+    // power is lost while the second log is written, it never gets an index entry
+    uint8_t data[100];
+    memset(data, 0x22, sizeof(data));
+    flashfsLogBegin(0);
+    for (int i = 0; i < 50; i++) {
+        flashfsWrite(data, sizeof(data), true);
+    }
+    flashfsFlushSync();
+
+    flashfsInit();
+
+    EXPECT_EQ(1, flashfsLogGetCount());
+    EXPECT_EQ(1, flashfsLogGetCurrentNumber());
+    // Falls back to searching for free space behind the indexed log
+    EXPECT_GE(flashfsGetOffset(), 6000);
+    EXPECT_EQ(0, flashfsGetOffset() % 2048);
+
+    writeLog(100, 0x33, 0);
+    EXPECT_EQ(2, flashfsLogGetCurrentNumber());
+}
+
+TEST_F(FlashfsLogIndexTest, DamagedEntryIsSkipped)
+{
+    writeLog(1000, 0x11, 0);
+    writeLog(1000, 0x22, 0);
+
+    // Corrupt the length of the second entry
+    simFlash[(SIM_FLASH_SECTORS - 1) * SIM_FLASH_SECTOR_SIZE + 16 + 8] &= 0x0F;
+
+    flashfsInit();
+
+    flashfsLogEntry_t entry;
+    EXPECT_EQ(2, flashfsLogGetCount());
+    EXPECT_TRUE(flashfsLogGetEntry(0, &entry));
+    EXPECT_FALSE(flashfsLogGetEntry(1, &entry));
+    EXPECT_FALSE(flashfsLogFindByNumber(2, &entry));
+    EXPECT_EQ(1, flashfsLogGetCurrentNumber());
+
+    // The damaged slot is not reused
+    writeLog(100, 0x33, 0);
+    EXPECT_EQ(3, flashfsLogGetCount());
+    EXPECT_TRUE(flashfsLogGetEntry(2, &entry));
+    EXPECT_EQ(2, entry.logNumber);
+}
+
+TEST_F(FlashfsLogIndexTest, EraseClearsIndex)
+{
+    writeLog(1000, 0x11, 0);
+    writeLog(1000, 0x22, 0);
+
+    flashfsEraseCompletely();
+
+    EXPECT_EQ(0, flashfsLogGetCount());
+    EXPECT_EQ(-1, flashfsLogGetCurrentNumber());
+
+    finishErase();
+    flashfsInit();
+    EXPECT_EQ(-1, flashfsLogGetCurrentNumber());
+    EXPECT_EQ(0, flashfsGetOffset());
+
+    writeLog(100, 0x33, 0);
+    EXPECT_EQ(1, flashfsLogGetCurrentNumber());
+}
+
+TEST_F(FlashfsLogIndexTest, EmptyLogIsNotIndexed)
+{
+    flashfsLogBegin(0);
+    flashfsClose();
+
+    EXPECT_EQ(0, flashfsLogGetCount());
+}
+
+TEST_F(FlashfsLogIndexTest, EraseRunsInBackground)
+{
+    writeLog(1000, 0x11, 0);
+    writeLog(10000, 0x22, 0);
+
+    simEraseCount = 0;
+    flashfsEraseCompletely();
+
+    // Nothing is erased until the erase is updated
+    EXPECT_TRUE(flashfsIsErasing());
+    EXPECT_EQ(0, simEraseCount);
+    EXPECT_EQ(0x22, simFlash[5000]);
+    EXPECT_TRUE(flashfsIsReady());
+    EXPECT_EQ(0, flashfsGetOffset());
+
+    // The index goes first
+    flashfsEraseUpdate();
+    EXPECT_EQ(1, simEraseCount);
+    EXPECT_TRUE(simSectorIs(SIM_FLASH_SECTORS - 1, 0xFF));
+    EXPECT_EQ(0x22, simFlash[5000]);
+
+    finishErase();
+
+    EXPECT_FALSE(flashfsIsErasing());
+    EXPECT_EQ(SIM_FLASH_SECTORS, simEraseCount);
+    for (int sector = 0; sector < SIM_FLASH_SECTORS - 1; sector++) {
+        EXPECT_TRUE(simSectorIs(sector, 0xFF));
+    }
+
+    // The index records the erase as started and finished, neither marker is a log
+    EXPECT_EQ(0x5A, simIndexSlotMagic(0));
+    EXPECT_EQ(0x3C, simIndexSlotMagic(1));
+    flashfsLogEntry_t entry;
+    EXPECT_FALSE(flashfsLogGetEntry(0, &entry));
+    EXPECT_FALSE(flashfsLogGetEntry(1, &entry));
+    EXPECT_EQ(-1, flashfsLogGetCurrentNumber());
+
+    flashfsInit();
+    EXPECT_FALSE(flashfsIsErasing());
+    EXPECT_EQ(0, flashfsGetOffset());
+}
+
+TEST_F(FlashfsLogIndexTest, LogDuringErase)
+{
+    memset(simFlash, 0x00, simFlashfsSize);
+
+    flashfsEraseCompletely();
+
+    // Sectors are erased on demand ahead of the synchronous writes
+    writeLog(5000, 0x33, 0);
+
+    EXPECT_TRUE(flashfsIsErasing());
+    EXPECT_EQ(0x00, simFlash[2 * SIM_FLASH_SECTOR_SIZE]);
+
+    flashfsLogEntry_t entry;
+    EXPECT_TRUE(flashfsLogFindByNumber(1, &entry));
+    EXPECT_EQ(0, entry.startAddress);
+    EXPECT_EQ(5000, entry.length);
+
+    finishErase();
+
+    EXPECT_FALSE(flashfsIsErasing());
+    for (int i = 0; i < 5000; i++) {
+        ASSERT_EQ(0x33, simFlash[i]);
+    }
+    EXPECT_EQ(0xFF, simFlash[5000]);
+    EXPECT_TRUE(simSectorIs(2, 0xFF));
+}
+
+TEST_F(FlashfsLogIndexTest, EraseStaysAheadOfLog)
+{
+    memset(simFlash, 0x00, simFlashfsSize);
+
+    flashfsEraseCompletely();
+
+    uint8_t data[32];
+    memset(data, 0x44, sizeof(data));
+
+    flashfsLogBegin(0);
+    for (int i = 0; i < 200; i++) {
+        flashfsWrite(data, sizeof(data), false);
+        flashfsEraseUpdate();
+
+        // Only a couple of sectors ahead of the write head get erased while logging
+        const int headSector = flashfsGetOffset() / SIM_FLASH_SECTOR_SIZE;
+        for (int sector = headSector + 3; sector < SIM_FLASH_SECTORS - 1; sector++) {
+            ASSERT_TRUE(simSectorIs(sector, 0x00));
+        }
+    }
+    flashfsFlushSync();
+    flashfsClose();
+
+    EXPECT_GT(flashfsGetOffset(), 0);
+    EXPECT_TRUE(flashfsIsErasing());
+
+    finishErase();
+
+    EXPECT_FALSE(flashfsIsErasing());
+    EXPECT_TRUE(simSectorIs(SIM_FLASH_SECTORS - 2, 0xFF));
+    EXPECT_EQ(0x44, simFlash[0]);
+}
+
+TEST_F(FlashfsLogIndexTest, EraseResumesAfterPowerLoss)
+{
+    writeLog(10000, 0x11, 0);
+
+    flashfsEraseCompletely();
+    writeLog(500, 0x22, 0);
+
+    // reboot before the erase has finished
+    flashfsInit();
+
+    EXPECT_TRUE(flashfsIsErasing());
+    EXPECT_EQ(500, flashfsGetOffset());
+    EXPECT_EQ(1, flashfsLogGetCurrentNumber());
+    EXPECT_EQ(0x11, simFlash[SIM_FLASH_SECTOR_SIZE]);
+
+    finishErase();
+
+    EXPECT_FALSE(flashfsIsErasing());
+    EXPECT_TRUE(simSectorIs(1, 0xFF));
+    EXPECT_TRUE(simSectorIs(2, 0xFF));
+    EXPECT_EQ(0x22, simFlash[0]);
+
+    writeLog(100, 0x33, 0);
+    flashfsInit();
+
+    EXPECT_FALSE(flashfsIsErasing());
+    EXPECT_EQ(600, flashfsGetOffset());
+    EXPECT_EQ(2, flashfsLogGetCurrentNumber());
+}
+
+class FlashfsNandTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        simFlashInit(FLASH_TYPE_NAND);
+        flashfsInit();
+    }
+};
+
+TEST_F(FlashfsNandTest, EraseMarkersWaitForPageBoundary)
+{
+    flashfsEraseCompletely();
+
+    // Erase the index and record the erase as started
+    while (simFlash[(SIM_FLASH_SECTORS - 1) * SIM_FLASH_SECTOR_SIZE] != 0x5A) {
+        flashfsEraseUpdate();
+    }
+
+    // Leave the write head part way through a page, with the partial page in the page buffer
+    uint8_t data[100];
+    memset(data, 0x55, sizeof(data));
+    flashfsLogBegin(0);
+    flashfsWrite(data, sizeof(data), true);
+    flashfsFlushSync();
+    EXPECT_NE(0, flashfsGetOffset() % SIM_FLASH_PAGE_SIZE);
+
+    // The log is idle, so the erase runs to the end but can't record that yet
+    finishErase();
+    EXPECT_TRUE(flashfsIsErasing());
+
+    for (int i = 0; i < 7; i++) {
+        flashfsWrite(data, sizeof(data), true);
+    }
+    flashfsClose();
+
+    finishErase();
+    EXPECT_FALSE(flashfsIsErasing());
+    EXPECT_EQ(0, simPageProgrammedTwiceCount);
+
+    for (int i = 0; i < 800; i++) {
+        ASSERT_EQ(0x55, simFlash[i]);
+    }
+
+    // The index holds the erase started marker, the log and the erase finished marker, a page each
+    const uint32_t indexAddress = (SIM_FLASH_SECTORS - 1) * SIM_FLASH_SECTOR_SIZE;
+    EXPECT_EQ(0x5A, simFlash[indexAddress]);
+    EXPECT_EQ(0xA5, simFlash[indexAddress + SIM_FLASH_PAGE_SIZE]);
+    EXPECT_EQ(0x3C, simFlash[indexAddress + 2 * SIM_FLASH_PAGE_SIZE]);
+
+    flashfsInit();
+    EXPECT_FALSE(flashfsIsErasing());
+    EXPECT_EQ(1, flashfsLogGetCurrentNumber());
+    EXPECT_EQ(1024, flashfsGetOffset());
+}
+
+TEST_F(FlashfsNandTest, LogsAreIndexed)
+{
+    writeLog(1000, 0x11, 0);
+    writeLog(300, 0x22, 0);
+
+    EXPECT_EQ(0, simPageProgrammedTwiceCount);
+
+    flashfsLogEntry_t entry;
+    EXPECT_TRUE(flashfsLogFindByNumber(2, &entry));
+    EXPECT_EQ(1024, entry.startAddress);
+    EXPECT_EQ(300, entry.length);
+    EXPECT_EQ(0x22, simFlash[1024 + 299]);
+
+    flashfsInit();
+    EXPECT_EQ(2, flashfsLogGetCurrentNumber());
+    EXPECT_EQ(1536, flashfsGetOffset());
+}
+
+// STUBS
+
+extern "C" {
+
+bool flashIsReady(void)
+{
+    if (simBusyPolls > 0) {
+        simBusyPolls--;
+        return false;
+    }
+    return true;
+}
+
+bool flashWaitForReady(void)
+{
+    simBusyPolls = 0;
+    return true;
+}
+
+void flashEraseSector(uint32_t address)
+{
+    const int sector = address / SIM_FLASH_SECTOR_SIZE;
+
+    simEraseCount++;
+    simBusyPolls = SIM_FLASH_ERASE_BUSY_POLLS;
+    memset(&simFlash[sector * SIM_FLASH_SECTOR_SIZE], 0xFF, SIM_FLASH_SECTOR_SIZE);
+    memset(&simPageProgrammed[sector * SIM_FLASH_PAGES_PER_SECTOR], 0, SIM_FLASH_PAGES_PER_SECTOR * sizeof(bool));
+}
+
+void flashEraseCompletely(void)
+{
+    simFlashErase();
+}
+
+static void simNandProgramExecute(void)
+{
+    const int page = simPageBufferStartAddress / SIM_FLASH_PAGE_SIZE;
+
+    if (simPageProgrammed[page]) {
+        simPageProgrammedTwiceCount++;
+    }
+    simPageProgrammed[page] = true;
+
+    for (int i = 0; i < SIM_FLASH_PAGE_SIZE; i++) {
+        simFlash[page * SIM_FLASH_PAGE_SIZE + i] &= simPageBuffer[i];
+    }
+    simPageBufferDirty = false;
+}
+
+void flashPageProgramBegin(uint32_t address)
+{
+    // The driver waits for the previous operation to finish
+    simBusyPolls = 0;
+
+    if (simGeometry.flashType == FLASH_TYPE_NAND && (!simPageBufferDirty || address != simProgramAddress)) {
+        if (simPageBufferDirty) {
+            simNandProgramExecute();
+        }
+        memset(simPageBuffer, 0xFF, sizeof(simPageBuffer));
+        simPageBufferStartAddress = address;
+    }
+
+    simProgramAddress = address;
+}
+
+void flashPageProgramContinue(const uint8_t *data, int length)
+{
+    for (int i = 0; i < length; i++) {
+        if (simGeometry.flashType == FLASH_TYPE_NAND) {
+            simPageBuffer[simProgramAddress++ % SIM_FLASH_PAGE_SIZE] = data[i];
+            simPageBufferDirty = true;
+        } else {
+            simFlash[simProgramAddress++] &= data[i];
+        }
+    }
+}
+
+void flashPageProgramFinish(void)
+{
+    if (simGeometry.flashType == FLASH_TYPE_NAND && simPageBufferDirty && simProgramAddress % SIM_FLASH_PAGE_SIZE == 0) {
+        simNandProgramExecute();
+    }
+}
+
+void flashPageProgram(uint32_t address, const uint8_t *data, int length)
+{
+    flashPageProgramBegin(address);
+    flashPageProgramContinue(data, length);
+    flashPageProgramFinish();
+}
+
+int flashReadBytes(uint32_t address, uint8_t *buffer, int length)
+{
+    simReadCount++;
+    memcpy(buffer, &simFlash[address], length);
+    return length;
+}
+
+void flashFlush(void)
+{
+    if (simPageBufferDirty) {
+        simNandProgramExecute();
+    }
+}
+
+const flashGeometry_t *flashGetGeometry(void)
+{
+    return &simGeometry;
+}
+
+flashPartition_t *flashPartitionFindByType(flashPartitionType_e type)
+{
+    for (unsigned i = 0; i < ARRAYLEN(simPartitions); i++) {
+        if (simPartitions[i].type == type) {
+            return &simPartitions[i];
+        }
+    }
+    return NULL;
+}
+
+int flashPartitionCount(void)
+{
+    return ARRAYLEN(simPartitions);
+}
+
+}
@@ -66,6 +66,9 @@ extern "C" {
 
     uint32_t serialRxBytesWaiting(const serialPort_t *) { return 0; }
     uint8_t serialRead(serialPort_t *) { return 0; }
+    uint32_t serialPeekContiguous(serialPort_t *, const uint8_t **) { return 0; }
+    void serialSkip(serialPort_t *, uint32_t) {}
+    uint32_t serialWriteBufContiguous(serialPort_t *, const uint8_t *, uint32_t count) { return count; }
     void serialWrite(serialPort_t *, uint8_t) {}
 
     serialPort_t *usbVcpOpen(void) { return NULL; }
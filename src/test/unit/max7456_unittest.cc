@@ -0,0 +1,669 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/maths.h"
+    #include "common/utils.h"
+
+    #include "drivers/bus_spi.h"
+    #include "drivers/exti.h"
+    #include "drivers/io.h"
+    #include "drivers/max7456.h"
+    #include "drivers/time.h"
+
+    #include "pg/max7456.h"
+    #include "pg/vcd.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+/*
+ * Host model of the MAX7456 SPI registers used for the display memory.
+ * Every transfer is an address byte followed by a data byte. In auto-increment
+ * mode (DMM bit 0) the display memory address advances after each DMDI write
+ * until 0xFF is written to DMDI. The VSYNC output interrupts at the start of
+ * each PAL field. Characters are programmed from the shadow RAM into the
+ * NVM on a CMM write, which keeps the chip busy for 12ms of bus time.
+ */
+
+#define MODEL_ADD_READ  0x80
+#define MODEL_ADD_VM0   0x00
+#define MODEL_ADD_DMM   0x04
+#define MODEL_ADD_DMAH  0x05
+#define MODEL_ADD_DMAL  0x06
+#define MODEL_ADD_DMDI  0x07
+#define MODEL_ADD_CMM   0x08
+#define MODEL_ADD_CMAH  0x09
+#define MODEL_ADD_CMAL  0x0a
+#define MODEL_ADD_CMDI  0x0b
+#define MODEL_ADD_OSDM  0x0c
+#define MODEL_ADD_STAT  0xa0
+
+#define MODEL_DISPLAY_SIZE 512
+
+#define MODEL_FIELD_PERIOD_US 20000
+#define MODEL_VSYNC_US 190
+
+#define MODEL_FONT_CHARS 256
+#define MODEL_CHAR_SIZE 54
+#define MODEL_NVM_WRITE_US 12000
+
+static struct {
+    uint8_t registers[0x80];
+    uint16_t address;
+    uint8_t display[MODEL_DISPLAY_SIZE];
+    bool haveAddress;
+    uint8_t pendingAddress;
+    int bytes;
+    uint8_t shadowRam[MODEL_CHAR_SIZE];
+    uint8_t nvm[MODEL_FONT_CHARS][MODEL_CHAR_SIZE];
+    timeUs_t nvmBusyUntilUs;
+    int nvmWrites;
+    int writesWhileBusy;
+} model;
+
+static timeUs_t simulationTimeUs;
+static extiCallbackRec_t *vsyncCallback;
+
+static void modelReset(void)
+{
+    memset(&model, 0, sizeof(model));
+    model.registers[MODEL_ADD_OSDM] = 0x1B;
+}
+
+// The bus takes about 1us for each byte, which is how time passes while the driver waits on the chip
+static timeUs_t modelTimeUs(void)
+{
+    return simulationTimeUs + model.bytes;
+}
+
+static bool modelNvmBusy(void)
+{
+    return cmp32(modelTimeUs(), model.nvmBusyUntilUs) < 0;
+}
+
+static uint8_t modelTransfer(uint8_t byte)
+{
+    model.bytes++;
+    if (!model.haveAddress) {
+        model.haveAddress = true;
+        model.pendingAddress = byte;
+        return 0;
+    }
+    model.haveAddress = false;
+
+    const uint8_t address = model.pendingAddress;
+    if (address == MODEL_ADD_STAT) {
+        // PAL detected, VSYNC output low during vertical sync, NVR busy while programming
+        const uint8_t busy = modelNvmBusy() ? 0x20 : 0x00;
+        return ((simulationTimeUs % MODEL_FIELD_PERIOD_US < MODEL_VSYNC_US) ? 0x01 : 0x11) | busy;
+    }
+    if (modelNvmBusy() && address >= MODEL_ADD_CMM && address <= MODEL_ADD_CMDI) {
+        model.writesWhileBusy++;
+    }
+    if (address & MODEL_ADD_READ) {
+        return model.registers[address & ~MODEL_ADD_READ];
+    }
+
+    switch (address) {
+    case MODEL_ADD_DMAH:
+        model.address = (model.address & 0xff) | ((byte & 0x01) << 8);
+        break;
+    case MODEL_ADD_DMAL:
+        model.address = (model.address & 0x100) | byte;
+        break;
+    case MODEL_ADD_DMM:
+        if (byte & 0x04) {
+            // clear display memory
+            memset(model.display, 0, sizeof(model.display));
+            byte &= ~0x04;
+        }
+        break;
+    case MODEL_ADD_DMDI:
+        if (model.registers[MODEL_ADD_DMM] & 0x01) {
+            if (byte == 0xff) {
+                // terminates auto-increment mode
+                model.registers[MODEL_ADD_DMM] &= ~0x01;
+            } else {
+                model.display[model.address++ % MODEL_DISPLAY_SIZE] = byte;
+            }
+        } else {
+            model.display[model.address] = byte;
+        }
+        return 0;
+    case MODEL_ADD_CMDI:
+        model.shadowRam[model.registers[MODEL_ADD_CMAL] % MODEL_CHAR_SIZE] = byte;
+        return 0;
+    case MODEL_ADD_CMM:
+        if (byte == 0xA0) {
+            memcpy(model.nvm[model.registers[MODEL_ADD_CMAH]], model.shadowRam, MODEL_CHAR_SIZE);
+            model.nvmBusyUntilUs = modelTimeUs() + MODEL_NVM_WRITE_US;
+            model.nvmWrites++;
+        }
+        return 0;
+    }
+    model.registers[address] = byte;
+    return 0;
+}
+
+static int drawAndCountBytes(void)
+{
+    const int before = model.bytes;
+    max7456DrawScreen();
+    return model.bytes - before;
+}
+
+static void drawUntilSynced(void)
+{
+    for (int i = 0; i < 100 && !max7456BuffersSynced(); i++) {
+        max7456DrawScreen();
+    }
+    ASSERT_TRUE(max7456BuffersSynced());
+}
+
+// The VSYNC output of the chip going low at the start of a field
+static void vsyncAt(timeUs_t timeUs)
+{
+    simulationTimeUs = timeUs;
+    if (vsyncCallback) {
+        vsyncCallback->fn(vsyncCallback);
+    }
+}
+
+static void expectDisplayMatches(const uint8_t *expected)
+{
+    for (int pos = 0; pos < VIDEO_BUFFER_CHARS_PAL; pos++) {
+        EXPECT_EQ(expected[pos], model.display[pos]) << "pos " << pos;
+    }
+}
+
+class Max7456Test : public ::testing::Test {
+protected:
+    uint8_t expected[VIDEO_BUFFER_CHARS_PAL];
+
+    virtual void configure(max7456Config_t *config) {
+        UNUSED(config);
+    }
+
+    virtual void SetUp() {
+        modelReset();
+        vsyncCallback = NULL;
+        // let the driver's periodic stall check come round again, starting at the beginning of a field
+        simulationTimeUs = (simulationTimeUs / 1000000 + 2) * 1000000;
+
+        max7456Config_t config = { MAX7456_CLOCK_CONFIG_FULL, 1, 1, false, 0, false };
+        configure(&config);
+        vcdProfile_t vcdProfile = { VIDEO_SYSTEM_PAL, 0, 0 };
+        ASSERT_TRUE(max7456Init(&config, &vcdProfile, false));
+
+        // the first draw detects the stalled chip and initialises it
+        max7456DrawScreen();
+        ASSERT_TRUE(model.registers[MODEL_ADD_VM0] & 0x08);
+
+        max7456ClearScreen();
+        drawUntilSynced();
+        memset(expected, ' ', sizeof(expected));
+        expectDisplayMatches(expected);
+    }
+
+    void write(uint8_t x, uint8_t y, const char *text) {
+        max7456Write(x, y, text);
+        memcpy(&expected[y * 30 + x], text, strlen(text));
+    }
+};
+
+TEST_F(Max7456Test, UnchangedScreenSendsNothing)
+{
+    EXPECT_EQ(0, drawAndCountBytes());
+
+    // writing the same text again doesn't dirty anything
+    max7456Write(0, 0, "    ");
+    EXPECT_EQ(0, drawAndCountBytes());
+}
+
+TEST_F(Max7456Test, RunIsWrittenInAutoIncrementMode)
+{
+    write(3, 5, "BETAFLIGHT-OSD");
+
+    // one run: 10 bytes of addressing and mode changes and 2 bytes per character
+    EXPECT_EQ(10 + 2 * 14, drawAndCountBytes());
+    EXPECT_EQ(0, model.registers[MODEL_ADD_DMM] & 0x01);
+    expectDisplayMatches(expected);
+}
+
+TEST_F(Max7456Test, IsolatedCharactersUseAddressedWrites)
+{
+    write(0, 0, "A");
+    write(29, 15, "B");
+    max7456WriteChar(10, 7, 'C');
+    expected[7 * 30 + 10] = 'C';
+
+    EXPECT_EQ(3 * 6, drawAndCountBytes());
+    expectDisplayMatches(expected);
+}
+
+TEST_F(Max7456Test, RunsCrossTheHighAddressByte)
+{
+    // 8 * 30 + 10 = 250, the run continues past display memory address 255
+    write(10, 8, "0123456789ABCDEF");
+
+    drawUntilSynced();
+    expectDisplayMatches(expected);
+}
+
+TEST_F(Max7456Test, EscapeCharacterIsWrittenAddressed)
+{
+    const char text[] = { 'A', 'B', 'C', (char)0xff, 'D', 'E', 'F', 0 };
+    write(2, 2, text);
+
+    // two runs around the 0xFF, which would end auto-increment mode, written on its own
+    EXPECT_EQ(2 * (10 + 2 * 3) + 6, drawAndCountBytes());
+    expectDisplayMatches(expected);
+}
+
+TEST_F(Max7456Test, OnlyChangedCharactersAreSent)
+{
+    write(5, 5, "12:34");
+    drawUntilSynced();
+
+    write(5, 5, "12:35");
+    EXPECT_EQ(6, drawAndCountBytes());
+    expectDisplayMatches(expected);
+
+    // changing back before drawing sends nothing
+    max7456Write(5, 5, "12:36");
+    max7456Write(5, 5, "12:35");
+    EXPECT_EQ(0, drawAndCountBytes());
+}
+
+TEST_F(Max7456Test, LayerCopyOnlyDirtiesDifferences)
+{
+    max7456LayerSelect(DISPLAYPORT_LAYER_BACKGROUND);
+    max7456Write(0, 0, "STATIC");
+    max7456LayerSelect(DISPLAYPORT_LAYER_FOREGROUND);
+
+    max7456LayerCopy(DISPLAYPORT_LAYER_FOREGROUND, DISPLAYPORT_LAYER_BACKGROUND);
+    memcpy(expected, "STATIC", 6);
+    drawUntilSynced();
+    expectDisplayMatches(expected);
+
+    // copying the same background again is free
+    max7456LayerCopy(DISPLAYPORT_LAYER_FOREGROUND, DISPLAYPORT_LAYER_BACKGROUND);
+    EXPECT_EQ(0, drawAndCountBytes());
+}
+
+TEST_F(Max7456Test, FullScreenUpdate)
+{
+    for (int y = 0; y < VIDEO_LINES_PAL; y++) {
+        char line[31];
+        for (int x = 0; x < 30; x++) {
+            line[x] = 'A' + (x + y) % 26;
+        }
+        line[30] = 0;
+        write(0, y, line);
+    }
+
+    int calls = 0;
+    int bytes = 0;
+    while (!max7456BuffersSynced() && calls < 100) {
+        bytes += drawAndCountBytes();
+        calls++;
+    }
+
+    expectDisplayMatches(expected);
+    // addressed writes of every character took 6 bytes each and 5 calls
+    EXPECT_LE(bytes, VIDEO_BUFFER_CHARS_PAL * 2 + 2 * 10);
+    EXPECT_EQ(2, calls);
+    printf("full screen update: %d SPI bytes in %d calls, %d with addressed writes\n", bytes, calls, VIDEO_BUFFER_CHARS_PAL * 6);
+}
+
+class Max7456FrameSyncTest : public Max7456Test {
+protected:
+    virtual void configure(max7456Config_t *config) {
+        config->vsyncTag = 1;
+        config->frameSync = true;
+    }
+
+    virtual void SetUp() {
+        Max7456Test::SetUp();
+        ASSERT_TRUE(vsyncCallback);
+        // SetUp() starts at the beginning of a field
+        vsyncAt(simulationTimeUs);
+    }
+};
+
+TEST_F(Max7456FrameSyncTest, WritesAreHeldUntilVerticalBlanking)
+{
+    simulationTimeUs += 5000;
+    EXPECT_EQ(MODEL_FIELD_PERIOD_US - 5000, max7456CommitDelayUs(micros()));
+
+    write(3, 5, "HELD");
+    EXPECT_EQ(0, drawAndCountBytes());
+    EXPECT_FALSE(max7456BuffersSynced());
+
+    vsyncAt(simulationTimeUs + MODEL_FIELD_PERIOD_US - 5000);
+    simulationTimeUs += 100;
+    EXPECT_EQ(0, max7456CommitDelayUs(micros()));
+
+    // one run
+    EXPECT_EQ(10 + 2 * 4, drawAndCountBytes());
+    EXPECT_TRUE(max7456BuffersSynced());
+    expectDisplayMatches(expected);
+}
+
+TEST_F(Max7456FrameSyncTest, FrameClockFollowsTheVideo)
+{
+    const timeUs_t fieldStartUs = simulationTimeUs;
+
+    // five seconds of fields, more than the frame clock is trusted for without a vertical sync
+    for (int field = 1; field <= 250; field++) {
+        simulationTimeUs = fieldStartUs + field * MODEL_FIELD_PERIOD_US - 8000;
+        char text[8];
+        snprintf(text, sizeof(text), "%03d", field);
+        write(10, 8, text);
+        max7456DrawScreen();
+        ASSERT_NE(0, memcmp(text, &model.display[8 * 30 + 10], 3)) << "field " << field;
+
+        vsyncAt(fieldStartUs + field * MODEL_FIELD_PERIOD_US);
+        simulationTimeUs += 50;
+        ASSERT_EQ(0, max7456CommitDelayUs(micros()));
+        drawUntilSynced();
+    }
+    expectDisplayMatches(expected);
+}
+
+TEST_F(Max7456FrameSyncTest, WritesAreImmediateWithoutFrameClock)
+{
+    // no vertical sync for too long, as when the camera is unplugged
+    simulationTimeUs += 3000000 + 5000;
+    EXPECT_EQ(DISPLAYPORT_NOT_FRAME_SYNCED, max7456CommitDelayUs(micros()));
+
+    write(3, 5, "NOW");
+    // the periodic stall check and one run
+    EXPECT_EQ(2 + 10 + 2 * 3, drawAndCountBytes());
+    expectDisplayMatches(expected);
+
+    // the next vertical sync anchors the frame clock again
+    vsyncAt(simulationTimeUs + 1000);
+    simulationTimeUs += 5000;
+    EXPECT_EQ(MODEL_FIELD_PERIOD_US - 5000, max7456CommitDelayUs(micros()));
+}
+
+// Bytes the SPI bus moves per millisecond at 36MHz / MAX7456_SPI_CLK
+#define MODEL_SPI_BYTES_PER_MS 1125
+#define MODEL_COMMIT_WINDOW_US 1000
+
+class Max7456FrameSyncBusTimeTest : public Max7456FrameSyncTest {
+protected:
+    // Draws until the window closes or nothing is left to send, letting the bus time pass
+    int drawCommitWindow(timeUs_t fieldStartUs) {
+        int bytes = 0;
+        while (max7456CommitDelayUs(micros()) == 0) {
+            const int sent = drawAndCountBytes();
+            if (!sent) {
+                break;
+            }
+            bytes += sent;
+            simulationTimeUs += (sent * 1000 + MODEL_SPI_BYTES_PER_MS - 1) / MODEL_SPI_BYTES_PER_MS;
+            EXPECT_LE(simulationTimeUs - fieldStartUs, (timeUs_t)MODEL_COMMIT_WINDOW_US);
+        }
+        return bytes;
+    }
+};
+
+TEST_F(Max7456FrameSyncBusTimeTest, LateBurstEndsWithTheWindow)
+{
+    vsyncAt(simulationTimeUs + MODEL_FIELD_PERIOD_US);
+    const timeUs_t fieldStartUs = simulationTimeUs;
+
+    for (int y = 0; y < 4; y++) {
+        write(0, y, "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123");
+    }
+    // 100us before the window closes
+    simulationTimeUs += MODEL_COMMIT_WINDOW_US - 100;
+    const int bytes = drawAndCountBytes();
+    EXPECT_GT(bytes, 0);
+    EXPECT_LE(bytes, 100 * MODEL_SPI_BYTES_PER_MS / 1000);
+    EXPECT_FALSE(max7456BuffersSynced());
+
+    // the rest goes in the next field
+    vsyncAt(fieldStartUs + MODEL_FIELD_PERIOD_US);
+    drawCommitWindow(simulationTimeUs);
+    EXPECT_TRUE(max7456BuffersSynced());
+    expectDisplayMatches(expected);
+}
+
+TEST_F(Max7456FrameSyncBusTimeTest, LargeUpdateIsSpreadOverWholeFields)
+{
+    // every other character, which takes more bus time than one window has
+    for (int y = 0; y < VIDEO_LINES_PAL; y++) {
+        char line[31];
+        for (int x = 0; x < 30; x++) {
+            line[x] = (x + y) % 2 ? ' ' : 'A' + (x * 7 + y) % 26;
+        }
+        line[30] = 0;
+        write(0, y, line);
+    }
+
+    const timeUs_t firstFieldUs = simulationTimeUs;
+    int fields = 0;
+    for (int field = 1; field <= 10 && !max7456BuffersSynced(); field++) {
+        vsyncAt(firstFieldUs + field * MODEL_FIELD_PERIOD_US);
+        EXPECT_GT(drawCommitWindow(simulationTimeUs), 0);
+        fields++;
+    }
+
+    EXPECT_TRUE(max7456BuffersSynced());
+    EXPECT_GT(fields, 1);
+    expectDisplayMatches(expected);
+}
+
+class Max7456FrameSyncWithoutVsyncPinTest : public Max7456Test {
+protected:
+    virtual void configure(max7456Config_t *config) {
+        config->frameSync = true;
+    }
+};
+
+TEST_F(Max7456FrameSyncWithoutVsyncPinTest, WritesAreImmediate)
+{
+    EXPECT_FALSE(vsyncCallback);
+    simulationTimeUs += 5000;
+    EXPECT_EQ(DISPLAYPORT_NOT_FRAME_SYNCED, max7456CommitDelayUs(micros()));
+
+    write(3, 5, "NOW");
+    EXPECT_EQ(10 + 2 * 3, drawAndCountBytes());
+    expectDisplayMatches(expected);
+}
+
+/*
+ * Font upload. These come last as the display stays disabled once a font has been loaded.
+ */
+
+class Max7456FontTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        modelReset();
+        simulationTimeUs = (simulationTimeUs / 1000000 + 2) * 1000000;
+
+        max7456Config_t config = { MAX7456_CLOCK_CONFIG_FULL, 1, 1, false, 0, false };
+        vcdProfile_t vcdProfile = { VIDEO_SYSTEM_PAL, 0, 0 };
+        ASSERT_TRUE(max7456Init(&config, &vcdProfile, false));
+    }
+};
+
+static void fillFontChar(uint8_t *data, int address)
+{
+    for (int i = 0; i < MODEL_CHAR_SIZE; i++) {
+        data[i] = address * 7 + i;
+    }
+}
+
+static void expectFontChar(int address)
+{
+    uint8_t data[MODEL_CHAR_SIZE];
+    fillFontChar(data, address);
+    EXPECT_EQ(0, memcmp(data, model.nvm[address], MODEL_CHAR_SIZE)) << "char " << address;
+}
+
+TEST_F(Max7456FontTest, QueuedCharactersAreProgrammedWithoutWaiting)
+{
+    max7456NvmWriteStatus_t status;
+    max7456GetNvmWriteStatus(&status);
+    const int writtenBefore = status.written;
+    const int queueSize = status.free;
+    EXPECT_EQ(0, status.queued);
+    EXPECT_GE(queueSize, 3);
+    EXPECT_FALSE(max7456NvmWritePending());
+
+    uint8_t data[MODEL_CHAR_SIZE];
+    for (int address = 40; address < 40 + queueSize; address++) {
+        fillFontChar(data, address);
+        EXPECT_TRUE(max7456QueueNvmWrite(address, data));
+    }
+    // queued characters are copied, the caller's buffer is free to be reused
+    memset(data, 0, sizeof(data));
+    EXPECT_FALSE(max7456QueueNvmWrite(99, data));
+
+    max7456GetNvmWriteStatus(&status);
+    EXPECT_EQ(queueSize, status.queued);
+    EXPECT_EQ(0, status.free);
+    EXPECT_TRUE(max7456NvmWritePending());
+
+    // driven from a task every 5ms
+    int calls = 0;
+    int maxBytes = 0;
+    bool pending = true;
+    while (pending && calls < 1000) {
+        const int before = model.bytes;
+        pending = max7456UpdateNvmWrite();
+        maxBytes = MAX(maxBytes, model.bytes - before);
+        simulationTimeUs += 5000;
+        calls++;
+    }
+
+    EXPECT_FALSE(pending);
+    EXPECT_EQ(queueSize, model.nvmWrites);
+    EXPECT_EQ(0, model.writesWhileBusy);
+    // a call either loads one character or reads the status, it never waits for the NVM
+    EXPECT_EQ(2 + 2 + 4 * MODEL_CHAR_SIZE + 2, maxBytes);
+    EXPECT_LE(calls, queueSize * (MODEL_NVM_WRITE_US / 5000 + 2));
+    for (int address = 40; address < 40 + queueSize; address++) {
+        expectFontChar(address);
+    }
+
+    max7456GetNvmWriteStatus(&status);
+    EXPECT_EQ(0, status.queued);
+    EXPECT_EQ(queueSize, status.free);
+    EXPECT_EQ(writtenBefore + queueSize, status.written);
+    EXPECT_FALSE(max7456NvmWritePending());
+    EXPECT_FALSE(max7456UpdateNvmWrite());
+}
+
+TEST_F(Max7456FontTest, FullQueueWaitsForTheOldestCharacter)
+{
+    // as MSP_OSD_CHAR_WRITE does for clients that send characters faster than they are programmed
+    model.nvmWrites = 0;
+    uint8_t data[MODEL_CHAR_SIZE];
+    for (int address = 0; address < MODEL_FONT_CHARS; address++) {
+        fillFontChar(data, address);
+        while (!max7456QueueNvmWrite(address, data)) {
+            ASSERT_TRUE(max7456UpdateNvmWrite());
+        }
+    }
+    while (max7456UpdateNvmWrite());
+
+    EXPECT_EQ(MODEL_FONT_CHARS, model.nvmWrites);
+    EXPECT_EQ(0, model.writesWhileBusy);
+    for (int address = 0; address < MODEL_FONT_CHARS; address++) {
+        expectFontChar(address);
+    }
+
+    // the blocking write still works and waits for its own character
+    fillFontChar(data, 7);
+    data[0] ^= 0xff;
+    EXPECT_TRUE(max7456WriteNvm(7, data));
+    EXPECT_FALSE(modelNvmBusy());
+    EXPECT_EQ(0, memcmp(data, model.nvm[7], MODEL_CHAR_SIZE));
+}
+
+// STUBS
+
+extern "C" {
+
+uint8_t debugMode;
+int16_t debug[DEBUG16_VALUE_COUNT];
+
+timeMs_t millis(void) { return simulationTimeUs / 1000; }
+timeUs_t micros(void) { return simulationTimeUs; }
+timeUs_t microsISR(void) { return simulationTimeUs; }
+void delay(timeMs_t ms) { UNUSED(ms); }
+
+static uint8_t ioDummy;
+IO_t IOGetByTag(ioTag_t tag) { UNUSED(tag); return &ioDummy; }
+bool IOIsFreeOrPreinit(IO_t io) { UNUSED(io); return true; }
+void IOInit(IO_t io, resourceOwner_e owner, uint8_t index) { UNUSED(io); UNUSED(owner); UNUSED(index); }
+void IOConfigGPIO(IO_t io, ioConfig_t cfg) { UNUSED(io); UNUSED(cfg); }
+void IOLo(IO_t io) { UNUSED(io); model.haveAddress = false; }
+void IOHi(IO_t io) { UNUSED(io); }
+
+void EXTIHandlerInit(extiCallbackRec_t *cb, extiHandlerCallback *fn) { cb->fn = fn; }
+void EXTIConfig(IO_t io, extiCallbackRec_t *cb, int irqPriority, ioConfig_t config, extiTrigger_t trigger)
+{
+    UNUSED(io); UNUSED(irqPriority); UNUSED(config); UNUSED(trigger);
+    vsyncCallback = cb;
+}
+void EXTIEnable(IO_t io, bool enable) { UNUSED(io); UNUSED(enable); }
+
+SPI_TypeDef *spiInstanceByDevice(SPIDevice device) { UNUSED(device); return NULL; }
+void spiBusSetInstance(busDevice_t *bus, SPI_TypeDef *instance) { UNUSED(bus); UNUSED(instance); }
+void spiBusSetDivisor(busDevice_t *bus, SPIClockDivider_e divider) { UNUSED(bus); UNUSED(divider); }
+void spiSetDivisor(SPI_TypeDef *instance, uint16_t divisor) { UNUSED(instance); UNUSED(divisor); }
+void spiPreinitRegister(ioTag_t iotag, uint8_t iocfg, uint8_t init) { UNUSED(iotag); UNUSED(iocfg); UNUSED(init); }
+
+uint8_t spiTransferByte(SPI_TypeDef *instance, uint8_t data)
+{
+    UNUSED(instance);
+    return modelTransfer(data);
+}
+
+bool spiTransfer(SPI_TypeDef *instance, const uint8_t *txData, uint8_t *rxData, int len)
+{
+    UNUSED(instance);
+    for (int i = 0; i < len; i++) {
+        const uint8_t in = modelTransfer(txData[i]);
+        if (rxData) {
+            rxData[i] = in;
+        }
+    }
+    return true;
+}
+
+}
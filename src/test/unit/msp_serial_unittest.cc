@@ -0,0 +1,701 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/maths.h"
+    #include "common/streambuf.h"
+    #include "common/utils.h"
+
+    #include "drivers/serial.h"
+    #include "drivers/system.h"
+
+    #include "io/serial.h"
+
+    #include "msp/msp.h"
+    #include "msp/msp_protocol_v2_betaflight.h"
+    #include "msp/msp_serial.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    PG_REGISTER(serialConfig_t, serialConfig, PG_SERIAL_CONFIG, 0);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+/*
+ * Simulated serial port with a TX buffer of SIM_TX_BUFFER_SIZE bytes, which the test empties by calling simTransmit().
+ */
+
+#define SIM_TX_BUFFER_SIZE  256
+#define SIM_RX_BUFFER_SIZE  1024
+#define SIM_CAPTURE_SIZE    65536
+
+#define TEST_CMD_SMALL      101     // 4 byte reply
+#define TEST_CMD_MEDIUM     102     // 20 byte reply
+#define TEST_CMD_HUGE       103     // Reply bigger than the TX buffer
+#define TEST_CMD_UNKNOWN    104
+#define TEST_CMD_ECHO       105     // Replies with the request followed by 16 bytes
+#define TEST_CMD_CHUNK      106     // Transfer chunk, the data is the low byte of each address
+
+static serialPort_t simPort;
+static serialPortConfig_t simPortConfig;
+
+static uint8_t simRx[SIM_RX_BUFFER_SIZE];
+static int simRxHead;
+static int simRxTail;
+
+static int simTxQueued;
+static bool simTxOverflow;
+
+static uint8_t simCapture[SIM_CAPTURE_SIZE];
+static int simCaptureLength;
+
+static uint32_t simMillis;
+static uint32_t simMicros;              // on top of simMillis
+static uint32_t simChunkReadUs;         // time taken to read each transfer chunk
+
+static void simReset(void)
+{
+    simRxHead = simRxTail = 0;
+    simTxQueued = 0;
+    simTxOverflow = false;
+    simCaptureLength = 0;
+    simMillis = 1000;
+    simMicros = 0;
+    simChunkReadUs = 0;
+}
+
+static void simTransmit(void)
+{
+    simTxQueued = 0;
+}
+
+// Queue up an MSPv2 native command for the FC
+static void queueCommandV2(uint16_t cmd, const uint8_t *payload, uint16_t size)
+{
+    const uint8_t header[] = { '$', 'X', '<', 0, (uint8_t)(cmd & 0xFF), (uint8_t)(cmd >> 8), (uint8_t)(size & 0xFF), (uint8_t)(size >> 8) };
+    uint8_t crc = crc8_dvb_s2_update(0, header + 3, sizeof(header) - 3);
+    crc = crc8_dvb_s2_update(crc, payload, size);
+
+    for (unsigned i = 0; i < sizeof(header); i++) {
+        simRx[simRxHead++] = header[i];
+    }
+    for (unsigned i = 0; i < size; i++) {
+        simRx[simRxHead++] = payload[i];
+    }
+    simRx[simRxHead++] = crc;
+}
+
+// Queue up an MSPv1 command for the FC
+static void queueCommandV1(uint8_t cmd, const uint8_t *payload, uint8_t size)
+{
+    const uint8_t header[] = { '$', 'M', '<', size, cmd };
+    uint8_t checksum = size ^ cmd;
+
+    for (unsigned i = 0; i < sizeof(header); i++) {
+        simRx[simRxHead++] = header[i];
+    }
+    for (unsigned i = 0; i < size; i++) {
+        simRx[simRxHead++] = payload[i];
+        checksum ^= payload[i];
+    }
+    simRx[simRxHead++] = checksum;
+}
+
+// Check the MSPv1 frame at offset in the capture and return its length, or 0 if it is broken
+static int checkFrameV1(int offset, uint8_t cmd, const uint8_t *payload, uint8_t size)
+{
+    const uint8_t *frame = simCapture + offset;
+    if (simCaptureLength - offset < 6 + size || frame[0] != '$' || frame[1] != 'M' || frame[2] != '>' || frame[3] != size || frame[4] != cmd) {
+        return 0;
+    }
+
+    uint8_t checksum = size ^ cmd;
+    for (int i = 0; i < size; i++) {
+        if (frame[5 + i] != payload[i]) {
+            return 0;
+        }
+        checksum ^= payload[i];
+    }
+
+    return frame[5 + size] == checksum ? 6 + size : 0;
+}
+
+static void process(void)
+{
+    mspSerialProcess(MSP_SKIP_NON_MSP_DATA, mspFcProcessCommand, mspFcProcessReply);
+}
+
+// Send an MSPv2 native command to the FC and let it process it
+static void sendCommandV2(uint16_t cmd, const uint8_t *payload, uint16_t size)
+{
+    queueCommandV2(cmd, payload, size);
+    process();
+}
+
+static void subscribe(const uint16_t *cmdsAndIntervals, int count)
+{
+    uint8_t payload[64];
+    for (int i = 0; i < count * 2; i++) {
+        payload[i * 2] = cmdsAndIntervals[i] & 0xFF;
+        payload[i * 2 + 1] = cmdsAndIntervals[i] >> 8;
+    }
+    sendCommandV2(MSP2_BETAFLIGHT_STREAM_SUBSCRIBE, payload, count * 4);
+}
+
+typedef struct frameCount_s {
+    int echo;
+    int echoOutOfOrder;
+    int small;
+    int medium;
+    int huge;
+    int subscribeReplies;
+    int chunk;
+    int chunkOutOfOrder;
+    int chunkMaxSize;
+    uint32_t chunkBytes;
+    int bad;
+} frameCount_t;
+
+// Parse the MSPv2 replies the FC sent and count them by command
+static frameCount_t countFrames(void)
+{
+    frameCount_t count = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    int i = 0;
+
+    while (i < simCaptureLength) {
+        if (simCaptureLength - i < 9 || simCapture[i] != '$' || simCapture[i + 1] != 'X' || simCapture[i + 2] != '>') {
+            count.bad++;
+            break;
+        }
+
+        const uint16_t cmd = simCapture[i + 4] | (simCapture[i + 5] << 8);
+        const uint16_t size = simCapture[i + 6] | (simCapture[i + 7] << 8);
+
+        if (crc8_dvb_s2_update(0, simCapture + i + 3, 5 + size) != simCapture[i + 8 + size]) {
+            count.bad++;
+        }
+
+        switch (cmd) {
+        case TEST_CMD_ECHO:
+            // The request carried a sequence number
+            if (size < 1 || simCapture[i + 8] != count.echo) {
+                count.echoOutOfOrder++;
+            }
+            count.echo++;
+            break;
+        case TEST_CMD_SMALL:
+            count.small++;
+            break;
+        case TEST_CMD_MEDIUM:
+            count.medium++;
+            break;
+        case TEST_CMD_HUGE:
+            count.huge++;
+            break;
+        case MSP2_BETAFLIGHT_STREAM_SUBSCRIBE:
+            count.subscribeReplies++;
+            break;
+        case TEST_CMD_CHUNK:
+            {
+                // Sequence number, address, length, data and CRC
+                const uint8_t *chunk = simCapture + i + 8;
+                const uint16_t seq = chunk[0] | (chunk[1] << 8);
+                const uint32_t address = chunk[2] | (chunk[3] << 8) | (chunk[4] << 16) | (chunk[5] << 24);
+                const uint16_t length = chunk[6] | (chunk[7] << 8);
+
+                if (seq != count.chunk || address != count.chunkBytes || size != 8 + length + 2) {
+                    count.chunkOutOfOrder++;
+                }
+                for (int j = 0; j < length && j + 8 < size; j++) {
+                    if (chunk[8 + j] != ((address + j) & 0xFF)) {
+                        count.bad++;
+                        break;
+                    }
+                }
+                count.chunk++;
+                count.chunkBytes += length;
+                count.chunkMaxSize = MAX(count.chunkMaxSize, (int)length);
+            }
+            break;
+        default:
+            count.bad++;
+        }
+
+        i += 9 + size;
+    }
+
+    return count;
+}
+
+class MspSerialTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        simReset();
+        mspSerialInit();
+    }
+};
+
+TEST_F(MspSerialTest, QueuedCommandsAreHandledInOnePass)
+{
+    // As many as fit in the TX buffer
+    for (uint8_t i = 0; i < 8; i++) {
+        queueCommandV2(TEST_CMD_ECHO, &i, 1);
+    }
+
+    process();
+
+    const frameCount_t count = countFrames();
+    EXPECT_EQ(0, count.bad);
+    EXPECT_EQ(8, count.echo);
+    EXPECT_EQ(0, count.echoOutOfOrder);
+    EXPECT_EQ(simRxHead, simRxTail);
+}
+
+TEST_F(MspSerialTest, V1RepliesAndPushesAreFramed)
+{
+    const uint8_t request[] = { 0xA5 };
+    queueCommandV1(TEST_CMD_ECHO, request, sizeof(request));
+    process();
+
+    uint8_t expected[17] = { 0xA5 };
+    for (int i = 0; i < 16; i++) {
+        expected[1 + i] = i;
+    }
+    const int replyLength = checkFrameV1(0, TEST_CMD_ECHO, expected, sizeof(expected));
+    EXPECT_EQ(6 + (int)sizeof(expected), replyLength);
+
+    // Pushed data isn't in the reply buffer to start with
+    uint8_t pushed[] = { 1, 2, 3, 4, 5 };
+    simTransmit();
+    EXPECT_EQ(6 + (int)sizeof(pushed), mspSerialPush(SERIAL_PORT_NONE, TEST_CMD_SMALL, pushed, sizeof(pushed), MSP_DIRECTION_REPLY));
+    EXPECT_EQ(6 + (int)sizeof(pushed), checkFrameV1(replyLength, TEST_CMD_SMALL, pushed, sizeof(pushed)));
+    EXPECT_EQ(replyLength + 6 + (int)sizeof(pushed), simCaptureLength);
+}
+
+TEST_F(MspSerialTest, RepliesWaitForTxSpace)
+{
+    const int commandCount = 60;
+
+    for (uint8_t i = 0; i < commandCount; i++) {
+        queueCommandV2(TEST_CMD_ECHO, &i, 1);
+    }
+
+    // The first pass answers as much as the TX buffer and the pending replies can take
+    process();
+    EXPECT_FALSE(simTxOverflow);
+    EXPECT_GT(countFrames().echo, 1);
+    EXPECT_LT(countFrames().echo, commandCount);
+
+    // Then the rest follow as the port transmits, none are lost
+    for (int pass = 0; pass < 100 && simRxTail < simRxHead; pass++) {
+        simTransmit();
+        process();
+        EXPECT_FALSE(simTxOverflow);
+    }
+    for (int pass = 0; pass < 10; pass++) {
+        simTransmit();
+        process();
+    }
+
+    const frameCount_t count = countFrames();
+    EXPECT_EQ(0, count.bad);
+    EXPECT_EQ(commandCount, count.echo);
+    EXPECT_EQ(0, count.echoOutOfOrder);
+}
+
+class MspSerialStreamTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        simReset();
+        mspSerialInit();
+    }
+
+    // Run the streaming task every 10ms for the given time, draining the TX buffer after every pass if asked
+#ifdef USE_MSP_DATAFLASH_STREAM
+    // Transfers are framed like the request that started them
+    void startTransfer(uint32_t length, uint16_t chunkSize) {
+        sendCommandV2(TEST_CMD_ECHO, NULL, 0);
+        EXPECT_TRUE(mspSerialStreamTransferStart(0, TEST_CMD_CHUNK, 0, length, chunkSize));
+    }
+
+#endif
+    void run(uint32_t durationMs, bool transmit) {
+        for (uint32_t t = 0; t < durationMs; t += 10) {
+            mspSerialStreamProcess(mspFcProcessStreamCommand);
+            if (transmit) {
+                simTransmit();
+            }
+            simMillis += 10;
+        }
+    }
+};
+
+TEST_F(MspSerialStreamTest, StreamsMessagesAtTheirIntervals)
+{
+    const uint16_t subscriptions[] = { TEST_CMD_SMALL, 20, TEST_CMD_MEDIUM, 50 };
+    subscribe(subscriptions, 2);
+    simTransmit();
+
+    run(1000, true);
+
+    const frameCount_t count = countFrames();
+    EXPECT_EQ(0, count.bad);
+    EXPECT_EQ(1, count.subscribeReplies);
+    EXPECT_EQ(50, count.small);
+    EXPECT_EQ(20, count.medium);
+}
+
+TEST_F(MspSerialStreamTest, IntervalsAreLimited)
+{
+    const uint16_t subscriptions[] = { TEST_CMD_SMALL, 1 };
+    subscribe(subscriptions, 1);
+    simTransmit();
+
+    run(1000, true);
+
+    EXPECT_EQ(1000 / MSP_STREAM_MIN_INTERVAL_MS, countFrames().small);
+}
+
+TEST_F(MspSerialStreamTest, SlowClientHoldsFramesBack)
+{
+    const uint16_t subscriptions[] = { TEST_CMD_SMALL, 10, TEST_CMD_MEDIUM, 10 };
+    subscribe(subscriptions, 2);
+    simTransmit();
+
+    // Nothing gets transmitted, so the TX buffer fills up but never overflows
+    run(500, false);
+    EXPECT_FALSE(simTxOverflow);
+    EXPECT_LE(simTxQueued, SIM_TX_BUFFER_SIZE);
+
+    // Leaving room for a reply to a request
+    EXPECT_GE(SIM_TX_BUFFER_SIZE - simTxQueued, 32);
+
+    frameCount_t stalled = countFrames();
+    EXPECT_EQ(0, stalled.bad);
+
+    // Both messages still get their turn
+    EXPECT_GT(stalled.small, 0);
+    EXPECT_GT(stalled.medium, 0);
+
+    // Once the client catches up the stream carries on, without a burst of the messages that were missed
+    run(100, true);
+    frameCount_t resumed = countFrames();
+    EXPECT_EQ(0, resumed.bad);
+    EXPECT_LE(resumed.small - stalled.small, 11);
+    EXPECT_GE(resumed.small - stalled.small, 9);
+}
+
+TEST_F(MspSerialStreamTest, UnstreamableMessagesAreDropped)
+{
+    const uint16_t subscriptions[] = { TEST_CMD_UNKNOWN, 10, TEST_CMD_HUGE, 10, TEST_CMD_SMALL, 100 };
+    subscribe(subscriptions, 3);
+    simTransmit();
+
+    run(1000, true);
+
+    const frameCount_t count = countFrames();
+    EXPECT_EQ(0, count.bad);
+    EXPECT_EQ(0, count.huge);
+    EXPECT_EQ(10, count.small);
+}
+
+TEST_F(MspSerialStreamTest, EmptySubscriptionStopsStream)
+{
+    const uint16_t subscriptions[] = { TEST_CMD_SMALL, 10 };
+    subscribe(subscriptions, 1);
+    simTransmit();
+
+    run(100, true);
+    EXPECT_EQ(10, countFrames().small);
+
+    subscribe(NULL, 0);
+    run(100, true);
+
+    const frameCount_t count = countFrames();
+    EXPECT_EQ(10, count.small);
+    EXPECT_EQ(2, count.subscribeReplies);
+}
+
+#ifdef USE_MSP_DATAFLASH_STREAM
+TEST_F(MspSerialStreamTest, TransferSendsEveryChunkInOrder)
+{
+    startTransfer(1000, 64);
+
+    // Chunks fill the TX buffer rather than going one per pass
+    mspSerialStreamProcess(mspFcProcessStreamCommand);
+    EXPECT_GT(countFrames().chunk, 1);
+    EXPECT_FALSE(simTxOverflow);
+
+    for (int pass = 0; pass < 100; pass++) {
+        simTransmit();
+        mspSerialStreamProcess(mspFcProcessStreamCommand);
+        EXPECT_FALSE(simTxOverflow);
+    }
+
+    const frameCount_t count = countFrames();
+    EXPECT_EQ(0, count.bad);
+    EXPECT_EQ(0, count.chunkOutOfOrder);
+    EXPECT_EQ(16, count.chunk);
+    EXPECT_EQ(1000U, count.chunkBytes);
+}
+
+TEST_F(MspSerialStreamTest, TransferChunksShrinkToFitTxBuffer)
+{
+    startTransfer(2000, 1024);
+
+    for (int pass = 0; pass < 100; pass++) {
+        simTransmit();
+        mspSerialStreamProcess(mspFcProcessStreamCommand);
+        EXPECT_FALSE(simTxOverflow);
+    }
+
+    const frameCount_t count = countFrames();
+    EXPECT_EQ(0, count.bad);
+    EXPECT_EQ(0, count.chunkOutOfOrder);
+    EXPECT_EQ(2000U, count.chunkBytes);
+    EXPECT_LT(count.chunkMaxSize, SIM_TX_BUFFER_SIZE);
+}
+
+TEST_F(MspSerialStreamTest, TransferPassesAreTimeLimited)
+{
+    // reading the chunks blocks the task, so a pass stops starting them once it has taken long enough
+    simChunkReadUs = 200;
+    startTransfer(1000, 16);
+    mspSerialStreamProcess(mspFcProcessStreamCommand);
+    EXPECT_EQ(2, countFrames().chunk);
+}
+
+TEST_F(MspSerialStreamTest, TransferCanBeStopped)
+{
+    startTransfer(100000, 64);
+    mspSerialStreamProcess(mspFcProcessStreamCommand);
+    const int chunks = countFrames().chunk;
+
+    startTransfer(0, 64);
+    for (int pass = 0; pass < 10; pass++) {
+        simTransmit();
+        mspSerialStreamProcess(mspFcProcessStreamCommand);
+    }
+
+    EXPECT_EQ(chunks, countFrames().chunk);
+}
+#endif
+
+// STUBS
+
+extern "C" {
+
+uint32_t millis(void) { return simMillis; }
+timeUs_t micros(void) { return simMillis * 1000 + simMicros; }
+
+mspDescriptor_t mspDescriptorAlloc(void) { return 0; }
+
+// Just enough of msp.c to subscribe, and some messages to stream
+mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(mspPostProcessFn);
+
+    reply->cmd = cmd->cmd;
+
+    if (cmd->cmd == TEST_CMD_ECHO) {
+        while (sbufBytesRemaining(&cmd->buf)) {
+            sbufWriteU8(&reply->buf, sbufReadU8(&cmd->buf));
+        }
+        for (int i = 0; i < 16; i++) {
+            sbufWriteU8(&reply->buf, i);
+        }
+        return MSP_RESULT_ACK;
+    }
+
+    if (cmd->cmd != MSP2_BETAFLIGHT_STREAM_SUBSCRIBE) {
+        return MSP_RESULT_ERROR;
+    }
+
+    mspStreamSubscription_t subscriptions[MSP_STREAM_MAX_SUBSCRIPTIONS];
+    int count = 0;
+    while (sbufBytesRemaining(&cmd->buf) >= 4 && count < MSP_STREAM_MAX_SUBSCRIPTIONS) {
+        subscriptions[count].cmd = sbufReadU16(&cmd->buf);
+        subscriptions[count].intervalMs = MAX(sbufReadU16(&cmd->buf), MSP_STREAM_MIN_INTERVAL_MS);
+        count++;
+    }
+
+    EXPECT_TRUE(mspSerialStreamSubscribe(srcDesc, subscriptions, count));
+    sbufWriteU8(&reply->buf, count);
+
+    return MSP_RESULT_ACK;
+}
+
+mspResult_e mspFcProcessStreamCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(srcDesc);
+    UNUSED(mspPostProcessFn);
+
+    if (cmd->cmd == TEST_CMD_CHUNK) {
+        const uint16_t seq = sbufReadU16(&cmd->buf);
+        const uint32_t address = sbufReadU32(&cmd->buf);
+        const uint16_t length = sbufReadU16(&cmd->buf);
+        simMicros += simChunkReadUs;
+
+        reply->cmd = cmd->cmd;
+        sbufWriteU16(&reply->buf, seq);
+        sbufWriteU32(&reply->buf, address);
+        sbufWriteU16(&reply->buf, length);
+        for (int i = 0; i < length; i++) {
+            sbufWriteU8(&reply->buf, address + i);
+        }
+        sbufWriteU16(&reply->buf, 0);
+
+        return MSP_RESULT_ACK;
+    }
+
+    int size;
+    switch (cmd->cmd) {
+    case TEST_CMD_SMALL:
+        size = 4;
+        break;
+    case TEST_CMD_MEDIUM:
+        size = 20;
+        break;
+    case TEST_CMD_HUGE:
+        size = SIM_TX_BUFFER_SIZE + 10;
+        break;
+    default:
+        return MSP_RESULT_CMD_UNKNOWN;
+    }
+
+    reply->cmd = cmd->cmd;
+    for (int i = 0; i < size; i++) {
+        sbufWriteU8(&reply->buf, i);
+    }
+
+    return MSP_RESULT_ACK;
+}
+
+void mspFcProcessReply(mspPacket_t *reply) { UNUSED(reply); }
+
+void cliEnter(serialPort_t *serialPort) { UNUSED(serialPort); }
+void systemResetToBootloader(bootloaderRequestType_e requestType) { UNUSED(requestType); }
+
+const uint32_t baudRates[] = { 0, 9600, 19200, 38400, 57600, 115200 };
+
+serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function)
+{
+    UNUSED(function);
+    simPortConfig.identifier = SERIAL_PORT_USART1;
+    return &simPortConfig;
+}
+
+serialPortConfig_t *findNextSerialPortConfig(serialPortFunction_e function)
+{
+    UNUSED(function);
+    return NULL;
+}
+
+bool isSerialPortShared(const serialPortConfig_t *portConfig, uint16_t functionMask, serialPortFunction_e sharedWithFunction)
+{
+    UNUSED(portConfig);
+    UNUSED(functionMask);
+    UNUSED(sharedWithFunction);
+    return false;
+}
+
+serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e function, serialReceiveCallbackPtr rxCallback, void *rxCallbackData, uint32_t baudrate, portMode_e mode, portOptions_e options)
+{
+    UNUSED(function);
+    UNUSED(rxCallback);
+    UNUSED(rxCallbackData);
+    UNUSED(baudrate);
+    UNUSED(mode);
+    UNUSED(options);
+
+    simPort.identifier = identifier;
+    return &simPort;
+}
+
+void closeSerialPort(serialPort_t *serialPort) { UNUSED(serialPort); }
+void waitForSerialPortToFinishTransmitting(serialPort_t *serialPort) { UNUSED(serialPort); }
+
+uint32_t serialRxBytesWaiting(const serialPort_t *instance)
+{
+    UNUSED(instance);
+    return simRxHead - simRxTail;
+}
+
+uint8_t serialRead(serialPort_t *instance)
+{
+    UNUSED(instance);
+    return simRx[simRxTail++];
+}
+
+// Hands the received bytes over in short segments, as a ring buffer that wraps would
+#define SIM_RX_SEGMENT_SIZE 7
+
+uint32_t serialPeekContiguous(serialPort_t *instance, const uint8_t **data)
+{
+    UNUSED(instance);
+    *data = &simRx[simRxTail];
+    return MIN(simRxHead - simRxTail, SIM_RX_SEGMENT_SIZE);
+}
+
+void serialSkip(serialPort_t *instance, uint32_t count)
+{
+    UNUSED(instance);
+    simRxTail += count;
+}
+
+uint32_t serialTxBytesFree(const serialPort_t *instance)
+{
+    UNUSED(instance);
+    return SIM_TX_BUFFER_SIZE - simTxQueued;
+}
+
+bool isSerialTransmitBufferEmpty(const serialPort_t *instance)
+{
+    UNUSED(instance);
+    return simTxQueued == 0;
+}
+
+void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+{
+    UNUSED(instance);
+
+    if (simTxQueued + count > SIM_TX_BUFFER_SIZE) {
+        simTxOverflow = true;
+    }
+    simTxQueued += count;
+
+    memcpy(simCapture + simCaptureLength, data, count);
+    simCaptureLength += count;
+}
+
+void serialBeginWrite(serialPort_t *instance) { UNUSED(instance); }
+void serialEndWrite(serialPort_t *instance) { UNUSED(instance); }
+
+}
@@ -127,6 +127,16 @@ void setDefaultSimulationState()
     simulationCoreTemperature = 0;
 }
 
+/*
+ * Lets the slowest element refresh interval pass, so that rate limited
+ * elements are rendered again on the next OSD refresh.
+ * (a whole number of blink periods, blinking elements keep their state)
+ */
+void waitElementRefreshInterval()
+{
+    simulationTime += 2e6;
+}
+
 /*
  * Performs a test of the OSD actions on arming.
  * (reused throughout the test suite)
@@ -630,6 +640,7 @@ TEST(OsdTest, TestElementRssi)
 
     // when
     rssi = 1024;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -638,6 +649,7 @@ TEST(OsdTest, TestElementRssi)
 
     // when
     rssi = 0;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -646,6 +658,7 @@ TEST(OsdTest, TestElementRssi)
 
     // when
     rssi = 512;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -665,6 +678,7 @@ TEST(OsdTest, TestElementAmperage)
 
     // when
     simulationBatteryAmperage = 0;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -673,6 +687,7 @@ TEST(OsdTest, TestElementAmperage)
 
     // when
     simulationBatteryAmperage = 2156;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -681,6 +696,7 @@ TEST(OsdTest, TestElementAmperage)
 
     // when
     simulationBatteryAmperage = 12345;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -700,6 +716,7 @@ TEST(OsdTest, TestElementMahDrawn)
 
     // when
     simulationMahDrawn = 0;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -708,6 +725,7 @@ TEST(OsdTest, TestElementMahDrawn)
 
     // when
     simulationMahDrawn = 4;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -716,6 +734,7 @@ TEST(OsdTest, TestElementMahDrawn)
 
     // when
     simulationMahDrawn = 15;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -724,6 +743,7 @@ TEST(OsdTest, TestElementMahDrawn)
 
     // when
     simulationMahDrawn = 246;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -732,6 +752,7 @@ TEST(OsdTest, TestElementMahDrawn)
 
     // when
     simulationMahDrawn = 1042;
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -756,6 +777,7 @@ TEST(OsdTest, TestElementPower)
     simulationBatteryAmperage = 0; // 0A
 
     // when
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -766,6 +788,7 @@ TEST(OsdTest, TestElementPower)
     simulationBatteryAmperage = 10; // 0.1A
 
     // when
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -776,6 +799,7 @@ TEST(OsdTest, TestElementPower)
     simulationBatteryAmperage = 120; // 1.2A
 
     // when
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -786,6 +810,7 @@ TEST(OsdTest, TestElementPower)
     simulationBatteryAmperage = 1230; // 12.3A
 
     // when
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -796,6 +821,7 @@ TEST(OsdTest, TestElementPower)
     simulationBatteryAmperage = 12340; // 123.4A
 
     // when
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -884,6 +910,7 @@ TEST(OsdTest, TestElementCoreTemperature)
     simulationCoreTemperature = 0;
 
     // when
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -894,6 +921,7 @@ TEST(OsdTest, TestElementCoreTemperature)
     simulationCoreTemperature = 33;
 
     // when
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -904,6 +932,7 @@ TEST(OsdTest, TestElementCoreTemperature)
     osdConfigMutable()->units = OSD_UNIT_IMPERIAL;
 
     // when
+    waitElementRefreshInterval();
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -911,6 +940,165 @@ TEST(OsdTest, TestElementCoreTemperature)
     displayPortTestBufferSubstring(1, 8, "C%c 91%c", SYM_TEMPERATURE, SYM_F);
 }
 
+/*
+ * Tests that rate limited elements are only rendered again once they are due.
+ */
+TEST(OsdTest, TestElementRefreshRateLimited)
+{
+    // given
+    osdConfigMutable()->item_pos[OSD_MAH_DRAWN] = OSD_POS(1, 11) | OSD_PROFILE_1_FLAG;
+    osdConfigMutable()->item_pos[OSD_CORE_TEMPERATURE] = OSD_POS(1, 8) | OSD_PROFILE_1_FLAG;
+    osdConfigMutable()->units = OSD_UNIT_METRIC;
+
+    // and
+    simulationMahDrawn = 100;
+    simulationCoreTemperature = 30;
+
+    // when
+    osdAnalyzeActiveElements();
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(1, 11, " 100%c", SYM_MAH);
+    displayPortTestBufferSubstring(1, 8, "C%c 30%c", SYM_TEMPERATURE, SYM_C);
+
+    // given
+    simulationMahDrawn = 150;
+    simulationCoreTemperature = 40;
+
+    // when
+    // the next refresh comes before any element is due
+    simulationTime += 0.05e6;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    // the previous text is redrawn
+    displayPortTestBufferSubstring(1, 11, " 100%c", SYM_MAH);
+    displayPortTestBufferSubstring(1, 8, "C%c 30%c", SYM_TEMPERATURE, SYM_C);
+
+    // when
+    // the normal refresh interval has passed
+    simulationTime += 0.15e6;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(1, 11, " 150%c", SYM_MAH);
+    displayPortTestBufferSubstring(1, 8, "C%c 30%c", SYM_TEMPERATURE, SYM_C);
+
+    // when
+    // the slow refresh interval has passed
+    simulationTime += 0.8e6;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(1, 11, " 150%c", SYM_MAH);
+    displayPortTestBufferSubstring(1, 8, "C%c 40%c", SYM_TEMPERATURE, SYM_C);
+
+    // given
+    osdConfigMutable()->units = OSD_UNIT_IMPERIAL;
+
+    // when
+    // the settings change, everything is rendered again straight away
+    osdAnalyzeActiveElements();
+    simulationTime += 0.2e6;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(1, 8, "C%c104%c", SYM_TEMPERATURE, SYM_F);
+}
+
+/*
+ * Tests that normal elements keep their 10Hz refresh rate when the OSD draws at 12Hz.
+ */
+TEST(OsdTest, TestElementRefreshRateAtDrawRate)
+{
+    // given
+    osdConfigMutable()->item_pos[OSD_MAH_DRAWN] = OSD_POS(1, 11) | OSD_PROFILE_1_FLAG;
+    osdConfigMutable()->units = OSD_UNIT_METRIC;
+    simulationMahDrawn = 100;
+
+    osdAnalyzeActiveElements();
+    waitElementRefreshInterval();
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+    displayPortTestBufferSubstring(1, 11, " 100%c", SYM_MAH);
+
+    // when
+    // two seconds of OSD draws at 60Hz / DRAW_FREQ_DENOM, with a new value for each draw
+    int renders = 0;
+    for (int draw = 1; draw <= 24; draw++) {
+        simulationMahDrawn = 100 + draw;
+        simulationTime += 1000000 / 12;
+        displayClearScreen(&testDisplayPort);
+        osdRefresh(simulationTime);
+
+        char expected[8];
+        snprintf(expected, sizeof(expected), " %d%c", (int)simulationMahDrawn, SYM_MAH);
+        if (memcmp(&testDisplayPortBuffer[11 * UNITTEST_DISPLAYPORT_COLS + 1], expected, strlen(expected)) == 0) {
+            renders++;
+        }
+    }
+
+    // then
+    // 20 renders in two seconds
+    EXPECT_GE(renders, 19);
+    EXPECT_LE(renders, 21);
+}
+
+/*
+ * Tests that switching OSD profile draws the elements of the new profile.
+ */
+TEST(OsdTest, TestElementLayoutPerProfile)
+{
+    // given
+    osdConfigMutable()->item_pos[OSD_MAH_DRAWN] = OSD_POS(1, 11) | OSD_PROFILE_1_FLAG;
+    osdConfigMutable()->item_pos[OSD_CORE_TEMPERATURE] = OSD_POS(1, 8) | OSD_PROFILE_FLAG(2);
+    osdConfigMutable()->item_pos[OSD_CURRENT_DRAW] = OSD_POS(1, 12) | OSD_PROFILE_1_FLAG | OSD_PROFILE_FLAG(2);
+    osdConfigMutable()->units = OSD_UNIT_METRIC;
+
+    // and
+    simulationMahDrawn = 100;
+    simulationCoreTemperature = 30;
+    simulationBatteryAmperage = 0;
+
+    // when
+    osdAnalyzeActiveElements();
+    waitElementRefreshInterval();
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(1, 11, " 100%c", SYM_MAH);
+    displayPortTestBufferSubstring(1, 12, "  0.00%c", SYM_AMP);
+    displayPortTestBufferSubstring(1, 8, "      ");
+
+    // when
+    changeOsdProfileIndex(2);
+    waitElementRefreshInterval();
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(1, 11, "      ");
+    displayPortTestBufferSubstring(1, 12, "  0.00%c", SYM_AMP);
+    displayPortTestBufferSubstring(1, 8, "C%c 30%c", SYM_TEMPERATURE, SYM_C);
+
+    // when
+    changeOsdProfileIndex(1);
+    waitElementRefreshInterval();
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(1, 11, " 100%c", SYM_MAH);
+    displayPortTestBufferSubstring(1, 8, "      ");
+}
+
 /*
  * Tests the battery notifications shown on the warnings OSD element.
  */
@@ -44,8 +44,10 @@ extern "C" {
     rssiSource_e rssiSource;
 
     void crsfDataReceive(uint16_t c);
+    void crsfFrameReceive(const serialRxFrame_t *frame, void *data);
     uint8_t crsfFrameCRC(void);
     uint8_t crsfFrameStatus(void);
+    timeUs_t crsfFrameTimeUs(const rxRuntimeState_t *rxRuntimeState);
     uint16_t crsfReadRawRC(const rxRuntimeState_t *rxRuntimeState, uint8_t chan);
 
     extern bool crsfFrameDone;
@@ -279,6 +281,68 @@ TEST(CrossFireTest, TestCrsfDataReceive)
     EXPECT_EQ(crc, crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]);
 }
 
+TEST(CrossFireTest, TestCrsfFrameReceive)
+{
+    // a frame which wraps around the end of the receive DMA buffer arrives in two segments
+    for (unsigned int split = 0; split <= sizeof(crsfRcChannelsFrame_t); ++split) {
+        crsfFrameDone = false;
+        memset(&crsfFrame, 0, sizeof(crsfFrame));
+
+        serialRxFrame_t frame;
+        frame.data[0] = capturedData;
+        frame.length[0] = split;
+        frame.data[1] = capturedData + split;
+        frame.length[1] = sizeof(crsfRcChannelsFrame_t) - split;
+        frame.timeUs = 0;
+        crsfFrameReceive(&frame, NULL);
+
+        EXPECT_EQ(true, crsfFrameDone);
+        EXPECT_EQ(CRSF_FRAMETYPE_RC_CHANNELS_PACKED, crsfFrame.frame.type);
+        for (int ii = 0; ii < CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE; ++ii) {
+            EXPECT_EQ(capturedData[ii + 3], crsfFrame.frame.payload[ii]);
+        }
+    }
+
+    // a partial frame left behind by noise does not offset the next delivery
+    crsfFrameDone = false;
+    serialRxFrame_t frame;
+    frame.data[0] = capturedData;
+    frame.length[0] = 5;
+    frame.data[1] = NULL;
+    frame.length[1] = 0;
+    frame.timeUs = 0;
+    crsfFrameReceive(&frame, NULL);
+    EXPECT_EQ(false, crsfFrameDone);
+
+    frame.length[0] = sizeof(crsfRcChannelsFrame_t);
+    crsfFrameReceive(&frame, NULL);
+    EXPECT_EQ(true, crsfFrameDone);
+}
+
+TEST(CrossFireTest, TestCrsfFrameTime)
+{
+    // the channels are stamped with the arrival of their frame, not with when the RX task got to them
+    crsfFrameDone = false;
+    serialRxFrame_t frame;
+    frame.data[0] = capturedData;
+    frame.length[0] = sizeof(crsfRcChannelsFrame_t);
+    frame.data[1] = NULL;
+    frame.length[1] = 0;
+    frame.timeUs = 100000;
+    crsfFrameReceive(&frame, NULL);
+
+    dummyTimeUs = 103000;
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus());
+    EXPECT_EQ(100000u, crsfFrameTimeUs(NULL));
+
+    // a frame which fails its CRC doesn't move the timestamp
+    frame.timeUs = 110000;
+    crsfFrameReceive(&frame, NULL);
+    crsfFrame.frame.payload[0] ^= 0xFF;
+    EXPECT_EQ(RX_FRAME_PENDING, crsfFrameStatus());
+    EXPECT_EQ(100000u, crsfFrameTimeUs(NULL));
+}
+
 // STUBS
 
 extern "C" {
@@ -0,0 +1,107 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "fc/rx_latency.h"
+
+    uint8_t debugMode = DEBUG_RX_LATENCY;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+
+    static timeUs_t simulatedTimeUs;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// A frame arriving at frameTimeUs, taken by the PID loop at usedTimeUs and on the motors at motorTimeUs
+static void frameToMotors(timeUs_t frameTimeUs, timeUs_t usedTimeUs, timeUs_t motorTimeUs)
+{
+    rxLatencyFrameUsed(frameTimeUs, usedTimeUs);
+    simulatedTimeUs = motorTimeUs;
+    rxLatencyMotorsUpdated();
+}
+
+TEST(RxLatencyUnittest, FirstMotorOutputOfAFrameIsMeasured)
+{
+    rxLatencyReset();
+
+    frameToMotors(10000, 10400, 10650);
+    EXPECT_EQ(1u, rxLatencyGetStats()->count);
+    EXPECT_EQ(650, rxLatencyGetStats()->lastUs);
+    EXPECT_EQ(400, debug[1]);
+    EXPECT_EQ(650, debug[0]);
+
+    // later PID loops interpolating the same frame are not counted
+    simulatedTimeUs = 10900;
+    rxLatencyMotorsUpdated();
+    EXPECT_EQ(1u, rxLatencyGetStats()->count);
+    EXPECT_EQ(650, rxLatencyGetStats()->lastUs);
+}
+
+TEST(RxLatencyUnittest, Distribution)
+{
+    rxLatencyReset();
+
+    frameToMotors(0xFFFFFF00, 0xFFFFFF80, 0x000000A0); // across the wrap of the microsecond timer
+    frameToMotors(20000, 20100, 21200);
+    frameToMotors(30000, 30100, 30300);
+    frameToMotors(40000, 40100, 45000);
+
+    const rxLatencyStats_t *stats = rxLatencyGetStats();
+    EXPECT_EQ(4u, stats->count);
+    EXPECT_EQ(300, stats->minUs);
+    EXPECT_EQ(5000, stats->maxUs);
+    EXPECT_EQ(2, stats->histogram[0]);
+    EXPECT_EQ(1, stats->histogram[2]);
+    EXPECT_EQ(1, stats->histogram[RX_LATENCY_BUCKET_COUNT - 1]);
+    EXPECT_GT(stats->averageUs, stats->minUs);
+    EXPECT_LT(stats->averageUs, stats->maxUs);
+}
+
+TEST(RxLatencyUnittest, StaleAndMissingTimestampsAreIgnored)
+{
+    rxLatencyReset();
+
+    // no frame has been received yet
+    frameToMotors(0, 100, 200);
+    // a frame from before a failsafe
+    frameToMotors(1000, 5000000, 5000200);
+
+    EXPECT_EQ(0u, rxLatencyGetStats()->count);
+}
+
+// STUBS
+
+extern "C" {
+
+timeUs_t micros(void)
+{
+    return simulatedTimeUs;
+}
+
+}
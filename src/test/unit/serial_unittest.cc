@@ -0,0 +1,215 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+    #include "common/utils.h"
+
+    #include "drivers/serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+/*
+ * A port which keeps its data in the serialPort_t ring buffers, as the UART without DMA, softserial and TCP drivers do.
+ * The test plays the part of the interrupt handlers on the other side of the buffers.
+ */
+
+#define RING_SIZE 16
+
+static uint8_t rxBuffer[RING_SIZE];
+static uint8_t txBuffer[RING_SIZE];
+
+static uint32_t ringRxWaiting(const serialPort_t *instance)
+{
+    return (instance->rxBufferHead + instance->rxBufferSize - instance->rxBufferTail) % instance->rxBufferSize;
+}
+
+static uint32_t ringTxFree(const serialPort_t *instance)
+{
+    return instance->txBufferSize - 1 - (instance->txBufferHead + instance->txBufferSize - instance->txBufferTail) % instance->txBufferSize;
+}
+
+static uint8_t ringRead(serialPort_t *instance)
+{
+    const uint8_t ch = instance->rxBuffer[instance->rxBufferTail];
+    instance->rxBufferTail = (instance->rxBufferTail + 1) % instance->rxBufferSize;
+    return ch;
+}
+
+static void ringWrite(serialPort_t *instance, uint8_t ch)
+{
+    instance->txBuffer[instance->txBufferHead] = ch;
+    instance->txBufferHead = (instance->txBufferHead + 1) % instance->txBufferSize;
+}
+
+static uint32_t bulkWriteBufContiguous(serialPort_t *instance, const uint8_t *data, uint32_t count)
+{
+    count = MIN(count, ringTxFree(instance));
+    serialBufferWrite(instance, data, count);
+    return count;
+}
+
+static const struct serialPortVTable bulkVTable = {
+    .serialWrite = ringWrite,
+    .serialTotalRxWaiting = ringRxWaiting,
+    .serialTotalTxFree = ringTxFree,
+    .serialRead = ringRead,
+    .serialSetBaudRate = NULL,
+    .isSerialTransmitBufferEmpty = NULL,
+    .setMode = NULL,
+    .setCtrlLineStateCb = NULL,
+    .setBaudRateCb = NULL,
+    .writeBuf = NULL,
+    .beginWrite = NULL,
+    .endWrite = NULL,
+    .setRxFrameCallback = NULL,
+    .peekContiguous = serialBufferPeekContiguous,
+    .skip = serialBufferSkip,
+    .writeBufContiguous = bulkWriteBufContiguous,
+};
+
+// Without writeBufContiguous, block writes go out a byte at a time
+static const struct serialPortVTable byteVTable = {
+    .serialWrite = ringWrite,
+    .serialTotalRxWaiting = ringRxWaiting,
+    .serialTotalTxFree = ringTxFree,
+    .serialRead = ringRead,
+    .serialSetBaudRate = NULL,
+    .isSerialTransmitBufferEmpty = NULL,
+    .setMode = NULL,
+    .setCtrlLineStateCb = NULL,
+    .setBaudRateCb = NULL,
+    .writeBuf = NULL,
+    .beginWrite = NULL,
+    .endWrite = NULL,
+    .setRxFrameCallback = NULL,
+    .peekContiguous = serialBufferPeekContiguous,
+    .skip = serialBufferSkip,
+    .writeBufContiguous = NULL,
+};
+
+class SerialBufferTest : public ::testing::Test {
+protected:
+    serialPort_t port;
+    uint8_t next;
+
+    void open(const struct serialPortVTable *portVTable, uint32_t position) {
+        memset(&port, 0, sizeof(port));
+        port.vTable = portVTable;
+        port.rxBuffer = rxBuffer;
+        port.rxBufferSize = sizeof(rxBuffer);
+        port.rxBufferHead = port.rxBufferTail = position;
+        port.txBuffer = txBuffer;
+        port.txBufferSize = sizeof(txBuffer);
+        port.txBufferHead = port.txBufferTail = position;
+        next = 0;
+    }
+
+    void receive(uint32_t count) {
+        for (uint32_t i = 0; i < count; i++) {
+            port.rxBuffer[port.rxBufferHead] = next++;
+            port.rxBufferHead = (port.rxBufferHead + 1) % port.rxBufferSize;
+        }
+    }
+
+    uint8_t transmit(void) {
+        const uint8_t ch = port.txBuffer[port.txBufferTail];
+        port.txBufferTail = (port.txBufferTail + 1) % port.txBufferSize;
+        return ch;
+    }
+};
+
+TEST_F(SerialBufferTest, ReadBufWrapsRoundTheBuffer)
+{
+    for (uint32_t position = 0; position < RING_SIZE; position++) {
+        for (uint32_t count = 0; count < RING_SIZE; count++) {
+            open(&bulkVTable, position);
+            receive(count);
+
+            uint8_t data[RING_SIZE + 1];
+            EXPECT_EQ(count, serialReadBuf(&port, data, sizeof(data)));
+            for (uint32_t i = 0; i < count; i++) {
+                EXPECT_EQ(i, data[i]);
+            }
+            EXPECT_EQ(0, serialRxBytesWaiting(&port));
+        }
+    }
+}
+
+TEST_F(SerialBufferTest, ReadBufTakesNoMoreThanAskedFor)
+{
+    open(&bulkVTable, RING_SIZE - 3);
+    receive(10);
+
+    uint8_t data[4];
+    EXPECT_EQ(4, serialReadBuf(&port, data, sizeof(data)));
+    EXPECT_EQ(6, serialRxBytesWaiting(&port));
+    EXPECT_EQ(4, serialRead(&port));
+}
+
+TEST_F(SerialBufferTest, PeekStopsWhereTheBufferWraps)
+{
+    open(&bulkVTable, RING_SIZE - 3);
+    receive(10);
+
+    const uint8_t *data;
+    EXPECT_EQ(3, serialPeekContiguous(&port, &data));
+    EXPECT_EQ(0, data[0]);
+    EXPECT_EQ(10, serialRxBytesWaiting(&port));
+
+    serialSkip(&port, 3);
+    EXPECT_EQ(7, serialPeekContiguous(&port, &data));
+    EXPECT_EQ(3, data[0]);
+
+    serialSkip(&port, 7);
+    EXPECT_EQ(0, serialPeekContiguous(&port, &data));
+}
+
+TEST_F(SerialBufferTest, WriteBufContiguousTakesWhatFits)
+{
+    uint8_t data[RING_SIZE];
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+
+    for (int bulk = 0; bulk < 2; bulk++) {
+        for (uint32_t position = 0; position < RING_SIZE; position++) {
+            open(bulk ? &bulkVTable : &byteVTable, position);
+
+            EXPECT_EQ(5, serialWriteBufContiguous(&port, data, 5));
+            EXPECT_EQ(RING_SIZE - 1 - 5, serialWriteBufContiguous(&port, data + 5, sizeof(data) - 5));
+            EXPECT_EQ(0, serialTxBytesFree(&port));
+            EXPECT_EQ(0, serialWriteBufContiguous(&port, data, 1));
+
+            for (uint32_t i = 0; i < RING_SIZE - 1; i++) {
+                EXPECT_EQ(i, transmit());
+            }
+        }
+    }
+}
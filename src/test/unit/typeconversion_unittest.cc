@@ -0,0 +1,260 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/printf.h"
+    #include "common/typeconversion.h"
+    #include "common/utils.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static const int testValues[] = { 0, 1, 5, 9, 10, 99, 100, 999, 1000, 1234, 99999, 123456789, -1, -5, -10, -99, -1234, 2147483647, -2147483647 - 1 };
+
+TEST(TypeConversionUnittest, FormatIntMatchesPrintf)
+{
+    char expected[32];
+    char buf[32];
+
+    for (unsigned i = 0; i < ARRAYLEN(testValues); i++) {
+        const int value = testValues[i];
+        for (int width = 0; width <= 12; width++) {
+            snprintf(expected, sizeof(expected), "%*d", width, value);
+            char *end = formatInt(buf, value, width, ' ');
+            EXPECT_STREQ(expected, buf);
+            EXPECT_EQ(buf + strlen(expected), end);
+
+            snprintf(expected, sizeof(expected), "%0*d", width, value);
+            formatInt(buf, value, width, '0');
+            EXPECT_STREQ(expected, buf);
+
+            snprintf(expected, sizeof(expected), "%0*u", width, (unsigned)value);
+            formatUnsigned(buf, value, width, '0');
+            EXPECT_STREQ(expected, buf);
+        }
+    }
+}
+
+TEST(TypeConversionUnittest, FormatFixed)
+{
+    char buf[32];
+
+    formatFixed(buf, 1234, 2, 0);
+    EXPECT_STREQ("12.34", buf);
+    formatFixed(buf, 1205, 2, 0);
+    EXPECT_STREQ("12.05", buf);
+    formatFixed(buf, 5, 2, 0);
+    EXPECT_STREQ("0.05", buf);
+    formatFixed(buf, -5, 2, 0);
+    EXPECT_STREQ("-0.05", buf);
+    formatFixed(buf, -1234, 1, 0);
+    EXPECT_STREQ("-123.4", buf);
+    formatFixed(buf, 42, 0, 0);
+    EXPECT_STREQ("42", buf);
+    formatFixed(buf, -1801234567, 7, 0);
+    EXPECT_STREQ("-180.1234567", buf);
+
+    // the width is of the whole value, as "%3d.%02d"
+    formatFixed(buf, 123, 2, 6);
+    EXPECT_STREQ("  1.23", buf);
+    formatFixed(buf, 123456, 2, 6);
+    EXPECT_STREQ("1234.56", buf);
+    formatFixed(buf, -123, 2, 6);
+    EXPECT_STREQ(" -1.23", buf);
+
+    for (int value = 0; value < 100000; value += 7) {
+        char expected[32];
+        snprintf(expected, sizeof(expected), "%3d.%02d", value / 100, value % 100);
+        formatFixed(buf, value, 2, 6);
+        ASSERT_STREQ(expected, buf);
+    }
+}
+
+TEST(TypeConversionUnittest, FormatMinutesSeconds)
+{
+    char buf[32];
+
+    formatMinutesSeconds(buf, 0);
+    EXPECT_STREQ("00:00", buf);
+    formatMinutesSeconds(buf, 61);
+    EXPECT_STREQ("01:01", buf);
+    formatMinutesSeconds(buf, 59 * 60 + 59);
+    EXPECT_STREQ("59:59", buf);
+    formatMinutesSeconds(buf, 100 * 60 + 5);
+    EXPECT_STREQ("100:05", buf);
+}
+
+TEST(TypeConversionUnittest, PartsAreWrittenOneAfterAnother)
+{
+    char buf[32];
+
+    char *p = formatChar(buf, 'V');
+    p = formatFixed(p, 1680, 2, 0);
+    p = formatChar(p, 'V');
+    p = formatString(p, " / ");
+    p = formatInt(p, 4, 0, ' ');
+    p = formatString(p, "S");
+    EXPECT_STREQ("V16.80V / 4S", buf);
+    EXPECT_EQ(buf + strlen(buf), p);
+}
+
+/*
+ * The text of a typical 20 element OSD, formatted as the element renderers did with tfp_sprintf
+ * and as they do now. Characters stand in for the font symbols.
+ */
+
+typedef struct osdValues_s {
+    int voltage;            // 0.1V
+    int cellVoltage;        // 0.01V
+    int amperage;           // 0.01A
+    int mAhDrawn;
+    int rssi;
+    int linkQuality;
+    unsigned onTime;        // s
+    unsigned flyTime;       // s
+    int altitude;           // 0.1m
+    int throttle;
+    int numSat;
+    int speed;
+    int homeDistance;       // m
+    int heading;
+    int pitch;              // 0.1 degrees
+    int roll;
+    int vario;              // cm/s
+    int power;
+    int escTemperature;
+    int gForce;             // 0.1G
+} osdValues_t;
+
+#define OSD_ELEMENT_COUNT 20
+#define OSD_ELEMENT_BUFFER_LENGTH 32
+
+static void formatWithPrintf(char (*buff)[OSD_ELEMENT_BUFFER_LENGTH], const osdValues_t *v)
+{
+    tfp_sprintf(buff[0], "%c%d.%d%c", 'B', v->voltage / 10, v->voltage % 10, 'V');
+    tfp_sprintf(buff[1], "%c%d.%02d%c", 'B', v->cellVoltage / 100, v->cellVoltage % 100, 'V');
+    tfp_sprintf(buff[2], "%3d.%02d%c", abs(v->amperage) / 100, abs(v->amperage) % 100, 'A');
+    tfp_sprintf(buff[3], "%4d%c", v->mAhDrawn, 'M');
+    tfp_sprintf(buff[4], "%c%2d", 'R', v->rssi);
+    tfp_sprintf(buff[5], "%c%1d", 'L', v->linkQuality);
+    tfp_sprintf(buff[6], "%c%02d:%02d", 'T', v->onTime / 60, v->onTime % 60);
+    tfp_sprintf(buff[7], "%c%02d:%02d", 'F', v->flyTime / 60, v->flyTime % 60);
+    tfp_sprintf(buff[8], "%c%01d.%01d%c", 'H', v->altitude / 10, v->altitude % 10, 'M');
+    tfp_sprintf(buff[9], "%c%3d", 'T', v->throttle);
+    tfp_sprintf(buff[10], "%c%c%2d", 'S', 's', v->numSat);
+    tfp_sprintf(buff[11], "%c%3d%c", 'S', v->speed, 'K');
+    tfp_sprintf(buff[12], "%c%d%c", 'D', v->homeDistance, 'M');
+    tfp_sprintf(buff[13], "%c%03d", 'N', v->heading);
+    tfp_sprintf(buff[14], "%c%c%02d.%01d", 'P', v->pitch < 0 ? '-' : ' ', abs(v->pitch / 10), abs(v->pitch % 10));
+    tfp_sprintf(buff[15], "%c%c%02d.%01d", 'R', v->roll < 0 ? '-' : ' ', abs(v->roll / 10), abs(v->roll % 10));
+    tfp_sprintf(buff[16], "%c%01d.%01d%c", 'U', abs(v->vario / 100), abs((v->vario % 100) / 10), 'M');
+    tfp_sprintf(buff[17], "%4dW", v->power);
+    tfp_sprintf(buff[18], "E%c%3d%c", 'T', v->escTemperature, 'C');
+    tfp_sprintf(buff[19], "%01d.%01dG", v->gForce / 10, v->gForce % 10);
+}
+
+static void formatWithPrimitives(char (*buff)[OSD_ELEMENT_BUFFER_LENGTH], const osdValues_t *v)
+{
+    char *p;
+
+    p = formatFixed(formatChar(buff[0], 'B'), v->voltage, 1, 0);
+    formatChar(p, 'V');
+    p = formatFixed(formatChar(buff[1], 'B'), v->cellVoltage, 2, 0);
+    formatChar(p, 'V');
+    p = formatFixed(buff[2], abs(v->amperage), 2, 6);
+    formatChar(p, 'A');
+    p = formatInt(buff[3], v->mAhDrawn, 4, ' ');
+    formatChar(p, 'M');
+    formatUnsigned(formatChar(buff[4], 'R'), v->rssi, 2, ' ');
+    formatUnsigned(formatChar(buff[5], 'L'), v->linkQuality, 1, ' ');
+    formatMinutesSeconds(formatChar(buff[6], 'T'), v->onTime);
+    formatMinutesSeconds(formatChar(buff[7], 'F'), v->flyTime);
+    p = formatFixed(formatChar(buff[8], 'H'), v->altitude, 1, 0);
+    formatChar(p, 'M');
+    formatInt(formatChar(buff[9], 'T'), v->throttle, 3, ' ');
+    formatUnsigned(formatChar(formatChar(buff[10], 'S'), 's'), v->numSat, 2, ' ');
+    p = formatInt(formatChar(buff[11], 'S'), v->speed, 3, ' ');
+    formatChar(p, 'K');
+    p = formatInt(formatChar(buff[12], 'D'), v->homeDistance, 0, ' ');
+    formatChar(p, 'M');
+    formatInt(formatChar(buff[13], 'N'), v->heading, 3, '0');
+    p = formatChar(formatChar(buff[14], 'P'), v->pitch < 0 ? '-' : ' ');
+    p = formatUnsigned(p, abs(v->pitch) / 10, 2, '0');
+    formatUnsigned(formatChar(p, '.'), abs(v->pitch) % 10, 1, '0');
+    p = formatChar(formatChar(buff[15], 'R'), v->roll < 0 ? '-' : ' ');
+    p = formatUnsigned(p, abs(v->roll) / 10, 2, '0');
+    formatUnsigned(formatChar(p, '.'), abs(v->roll) % 10, 1, '0');
+    p = formatFixed(formatChar(buff[16], 'U'), abs(v->vario) / 10, 1, 0);
+    formatChar(p, 'M');
+    p = formatInt(buff[17], v->power, 4, ' ');
+    formatChar(p, 'W');
+    p = formatInt(formatChar(formatChar(buff[18], 'E'), 'T'), v->escTemperature, 3, ' ');
+    formatChar(p, 'C');
+    p = formatFixed(buff[19], v->gForce, 1, 0);
+    formatChar(p, 'G');
+}
+
+static void setFrameValues(osdValues_t *v, int frame)
+{
+    v->voltage = 168 - frame % 40;
+    v->cellVoltage = 420 - frame % 100;
+    v->amperage = (frame * 37) % 12000;
+    v->mAhDrawn = frame / 3;
+    v->rssi = 99 - frame % 30;
+    v->linkQuality = frame % 10;
+    v->onTime = 60 + frame / 12;
+    v->flyTime = frame / 12;
+    v->altitude = (frame * 13) % 2000;
+    v->throttle = frame % 101;
+    v->numSat = 6 + frame % 10;
+    v->speed = (frame * 7) % 160;
+    v->homeDistance = (frame * 3) % 2000;
+    v->heading = frame % 360;
+    v->pitch = (frame * 11) % 1800 - 900;
+    v->roll = (frame * 17) % 3600 - 1800;
+    v->vario = (frame * 23) % 2000 - 1000;
+    v->power = (frame * 31) % 2000;
+    v->escTemperature = 30 + frame % 70;
+    v->gForce = frame % 40;
+}
+
+TEST(TypeConversionUnittest, OsdElementsMatchPrintf)
+{
+    char expected[OSD_ELEMENT_COUNT][OSD_ELEMENT_BUFFER_LENGTH];
+    char buff[OSD_ELEMENT_COUNT][OSD_ELEMENT_BUFFER_LENGTH];
+    osdValues_t values;
+
+    for (int frame = 0; frame < 10000; frame++) {
+        setFrameValues(&values, frame);
+        formatWithPrintf(expected, &values);
+        formatWithPrimitives(buff, &values);
+        for (int i = 0; i < OSD_ELEMENT_COUNT; i++) {
+            ASSERT_STREQ(expected[i], buff[i]) << "frame " << frame << " element " << i;
+        }
+    }
+}
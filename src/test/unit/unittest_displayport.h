@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <stdarg.h>
 #include <string.h>
 
 extern "C" {
@@ -33,6 +34,8 @@ void displayPortTestBufferSubstring(int x, int y, const char * expectedFormat, .
 #define UNITTEST_DISPLAYPORT_BUFFER_LEN (UNITTEST_DISPLAYPORT_ROWS * UNITTEST_DISPLAYPORT_COLS)
 
 char testDisplayPortBuffer[UNITTEST_DISPLAYPORT_BUFFER_LEN];
+int testDisplayPortCharsWritten;
+uint32_t testDisplayPortTxBytesFree;
 
 static displayPort_t testDisplayPort;
 
@@ -73,6 +76,7 @@ static int displayPortTestWriteString(displayPort_t *displayPort, uint8_t x, uin
     for (unsigned int i = 0; i < strlen(s); i++) {
         testDisplayPortBuffer[(y * UNITTEST_DISPLAYPORT_COLS) + x + i] = s[i];
     }
+    testDisplayPortCharsWritten += strlen(s);
     return 0;
 }
 
@@ -80,6 +84,7 @@ static int displayPortTestWriteChar(displayPort_t *displayPort, uint8_t x, uint8
 {
     UNUSED(displayPort);
     testDisplayPortBuffer[(y * UNITTEST_DISPLAYPORT_COLS) + x] = c;
+    testDisplayPortCharsWritten++;
     return 0;
 }
 
@@ -103,7 +108,7 @@ static void displayPortTestResync(displayPort_t *displayPort)
 static uint32_t displayPortTestTxBytesFree(const displayPort_t *displayPort)
 {
     UNUSED(displayPort);
-    return 0;
+    return testDisplayPortTxBytesFree;
 }
 
 static const displayPortVTable_t testDisplayPortVTable = {